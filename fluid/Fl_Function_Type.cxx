@@ -1305,6 +1305,7 @@ void Fl_Data_Type::write_code1(Fd_Code_Writer& f) {
   int uncompressedDataSize = 0;
   // path should be set correctly already
   if (filename_ && !f.write_codeview) {
+    f.uncacheable = true;
     enter_project_dir();
     FILE *f = fl_fopen(filename_, "rb");
     leave_project_dir();
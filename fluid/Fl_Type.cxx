@@ -367,7 +367,7 @@ void later_cb(Fl_Widget*,void*) {
 
 /** \brief Delete all children of a Type.
  */
-static void delete_children(Fl_Type *p) {
+void delete_children(Fl_Type *p) {
   Fl_Type *f;
   // find all types following p that are higher in level, effectively finding
   // the last child of the last child
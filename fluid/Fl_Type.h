@@ -86,6 +86,7 @@ enum ID {
 
 void update_visibility_flag(Fl_Type *p);
 void delete_all(int selected_only=0);
+void delete_children(Fl_Type *p);
 int storestring(const char *n, const char * & p, int nostrip=0);
 
 void select_all_cb(Fl_Widget *,void *);
@@ -64,7 +64,7 @@ size_t Fluid_Image::write_static_binary(Fd_Code_Writer& f, const char* fmt) {
     if (nData) {
       char *data = (char*)calloc(nData, 1);
       if (fread(data, nData, 1, in)==0) { /* ignore */ }
-      f.write_cdata(data, (int)nData);
+      f.write_cdata(data, (int)nData, g_project.image_data_as_strings);
       free(data);
     }
     fclose(in);
@@ -104,7 +104,7 @@ void Fluid_Image::write_static_rgb(Fd_Code_Writer& f, const char* idata_name) {
   f.write_c_once("#include <FL/Fl_Image.H>\n");
   f.write_c("static const unsigned char %s[] =\n", idata_name);
   const int extra_data = img->ld() ? (img->ld()-img->w()*img->d()) : 0;
-  f.write_cdata(img->data()[0], (img->w() * img->d() + extra_data) * img->h());
+  f.write_cdata(img->data()[0], (img->w() * img->d() + extra_data) * img->h(), g_project.image_data_as_strings);
   f.write_c(";\n");
   write_initializer(f, "Fl_RGB_Image", "%s, %d, %d, %d, %d", idata_name, img->w(), img->h(), img->d(), img->ld());
 }
@@ -180,7 +180,7 @@ void Fluid_Image::write_static(Fd_Code_Writer& f, int compressed) {
     f.write_c("\n");
     f.write_c_once("#include <FL/Fl_Bitmap.H>\n");
     f.write_c("static const unsigned char %s[] =\n", idata_name);
-    f.write_cdata(img->data()[0], ((img->w() + 7) / 8) * img->h());
+    f.write_cdata(img->data()[0], ((img->w() + 7) / 8) * img->h(), g_project.image_data_as_strings);
     f.write_c(";\n");
     write_initializer(f, "Fl_Bitmap", "%s, %d, %d, %d", idata_name, ((img->w() + 7) / 8) * img->h(), img->w(), img->h());
   } else if (compressed && fl_ascii_strcasecmp(fl_filename_ext(name()), ".jpg")==0) {
@@ -171,6 +171,17 @@ int write_strings(const Fl_String &filename) {
   return fclose(fp);
 }
 
+////////////////////////////////////////////////////////////////
+// Changes of the writer state, see write_fragment():
+
+/// Change of the code writer state that must be repeated when reusing a fragment
+struct Fd_Code_Effect {
+  enum { UNIQUE_ID, HEADER_ONCE, CODE_ONCE };
+  int type;
+  int node;   ///< UNIQUE_ID: index of the object in the nodes of the fragment
+  char *text;
+};
+
 ////////////////////////////////////////////////////////////////
 // Generate unique but human-readable identifiers:
 
@@ -216,6 +227,8 @@ const char* Fd_Code_Writer::unique_id(void* o, const char* type, const char* nam
     while (is_id(*n) && (q < q_end)) *q++ = *n++;
   }
   *q = 0;
+  // code that uses ids of objects outside of the fragment can't be reused
+  if (recording_ && recording_index(o) < 0) uncacheable = true;
   // okay, search the tree and see if the name was already used:
   Fd_Identifier_Tree** p = &id_root;
   int which = 0;
@@ -232,6 +245,7 @@ const char* Fd_Code_Writer::unique_id(void* o, const char* type, const char* nam
     else p  = &((*p)->right);
   }
   *p = new Fd_Identifier_Tree(buffer, o);
+  if (recording_) record_effect(Fd_Code_Effect::UNIQUE_ID, recording_index(o), buffer);
   return (*p)->text;
 }
 
@@ -340,6 +354,7 @@ int Fd_Code_Writer::write_h_once(const char *format, ...) {
   }
   fprintf(header_file,"%s\n",buf);
   *p = new Fd_Text_Tree(buf);
+  if (recording_) record_effect(Fd_Code_Effect::HEADER_ONCE, -1, buf);
   return 1;
 }
 
@@ -371,6 +386,7 @@ int Fd_Code_Writer::write_c_once(const char *format, ...) {
   }
   crc_printf("%s\n", buf);
   *p = new Fd_Text_Tree(buf);
+  if (recording_) record_effect(Fd_Code_Effect::CODE_ONCE, -1, buf);
   return 1;
 }
 
@@ -381,6 +397,7 @@ int Fd_Code_Writer::write_c_once(const char *format, ...) {
  \return true if found in the tree, false if added to the tree
  */
 bool Fd_Code_Writer::c_contains(void *pp) {
+  if (recording_) uncacheable = true;
   Fd_Pointer_Tree **p = &ptr_in_code;
   while (*p) {
     if ((*p)->ptr == pp) return true;
@@ -493,15 +510,26 @@ void Fd_Code_Writer::write_cstring(const char *s) {
   write_cstring(s, (int)strlen(s));
 }
 
+// Longest data written as a string literal, see write_cdata()
+#define FD_MAX_CDATA_STRING 65000
+
 /**
  Write an array of C binary data (does not add a null).
  The output is bracketed in { and }. The content is written
  as decimal bytes, i.e. `{ 1, 2, 200 }`
 
+ If \p as_string is set, the data is written as a string literal instead,
+ which compilers parse much faster than a long list of numbers. This is only
+ useful for arrays declared without a size, as the compiler adds a trailing
+ null to the string. Data longer than FD_MAX_CDATA_STRING bytes is always
+ written as numbers, because some compilers (Visual C++: error C2026) limit
+ the length of a string literal to 64 kBytes.
+
  \param[in] s a block of binary data, interpreted as unsigned bytes
  \param[in] length size of the block in bytes
+ \param[in] as_string write the data as a string literal
  */
-void Fd_Code_Writer::write_cdata(const char *s, int length) {
+void Fd_Code_Writer::write_cdata(const char *s, int length, bool as_string) {
   if (varused_test) {
     varused = 1;
     return;
@@ -518,20 +546,58 @@ void Fd_Code_Writer::write_cdata(const char *s, int length) {
     crc_puts("{ /* ... undefined size binary data... */ }");
     return;
   }
+  if (length > FD_MAX_CDATA_STRING)
+    as_string = false;
+  // Precomputed text for every byte value, so that large images don't need
+  // a printf() call per byte. Output is collected in a buffer and passed on
+  // in blocks, which keeps the MergeBack checksum intact.
+  static char text[256][5];
+  static unsigned char text_len[256];
+  static bool text_as_string = false;
+  if (!text_len[0] || text_as_string != as_string) {
+    for (int c = 0; c < 256; c++) {
+      if (!as_string)
+        snprintf(text[c], 5, "%d", c);
+      else if (c >= ' ' && c < 127 && c != '\"' && c != '\\' && c != '?')
+        snprintf(text[c], 5, "%c", c);
+      else // octal escapes always have 3 digits, so any character can follow
+        snprintf(text[c], 5, "\\%03o", c);
+      text_len[c] = (unsigned char)strlen(text[c]);
+    }
+    text_as_string = as_string;
+  }
+  char buf[1024];
+  int n = 0;
   const unsigned char *w = (const unsigned char *)s;
   const unsigned char *e = w+length;
   int linelength = 1;
-  crc_putc('{');
+  buf[n++] = as_string ? '\"' : '{';
   for (; w < e;) {
     unsigned char c = *w++;
-    if (c>99) linelength += 4;
-    else if (c>9) linelength += 3;
-    else linelength += 2;
-    if (linelength >= 77) {crc_puts("\n"); linelength = 0;}
-    crc_printf("%d", c);
-    if (w<e) crc_putc(',');
+    if (n > (int)sizeof(buf) - 16) {
+      buf[n] = 0;
+      crc_puts(buf);
+      n = 0;
+    }
+    if (as_string) {
+      if (linelength + text_len[c] > 78) {
+        buf[n++] = '\"'; buf[n++] = '\n'; buf[n++] = '\"';
+        linelength = 1;
+      }
+    } else {
+      linelength += text_len[c] + 1;
+      if (linelength >= 77) { buf[n++] = '\n'; linelength = 0; }
+    }
+    memcpy(buf + n, text[c], text_len[c]);
+    n += text_len[c];
+    if (as_string)
+      linelength += text_len[c];
+    else if (w<e)
+      buf[n++] = ',';
   }
-  crc_putc('}');
+  buf[n++] = as_string ? '\"' : '}';
+  buf[n] = 0;
+  crc_puts(buf);
 }
 
 /**
@@ -681,6 +747,353 @@ bool is_comment_before_class_member(Fl_Type *q) {
   return false;
 }
 
+////////////////////////////////////////////////////////////////
+// Cache of generated code:
+// The code of every top level node and its children is kept after it was
+// written, so it can be reused the next time code is written for the same
+// target, for example in the code view. A fragment is reused if its node is
+// written to the project file in the same way as before, and if the writer
+// is in the same state, i.e. the same unique ids and include statements were
+// written before it. The state is tracked as a hash of these changes.
+
+/// Code written for a top level node and its children
+struct Fd_Code_Fragment {
+  Fd_Code_Fragment *next;   ///< next fragment in the same hash bucket
+  unsigned hash;            ///< hash of key, state, and last
+  unsigned state[2];        ///< state of the writer before this fragment
+  bool last;                ///< set if the node was the last node in the project
+  int mode;                 ///< 1 if written for the code view, 0 for files
+  int generation;           ///< last call to write_code() that used this fragment
+  bool cacheable;           ///< if not set, the code must be written every time
+  Fl_String key;            ///< the node as written to a project file
+  Fl_String code, header;   ///< text written to the code and header file
+  Fd_Code_Effect *effects;
+  int n_effects, effects_alloc;
+  int *pos;                 ///< code view positions, 12 per node, relative to the start
+  int n_nodes;
+  Fd_Code_Fragment() : next(NULL), hash(0), last(false), mode(0),
+    generation(0), cacheable(false), effects(NULL), n_effects(0), effects_alloc(0),
+    pos(NULL), n_nodes(0) { }
+  ~Fd_Code_Fragment() { clear(); }
+  void clear() {
+    for (int i = 0; i < n_effects; i++) free(effects[i].text);
+    free(effects); effects = NULL;
+    n_effects = effects_alloc = 0;
+    free(pos); pos = NULL;
+    n_nodes = 0;
+    code.clear(); header.clear();
+    cacheable = false;
+  }
+};
+
+static const int kFragmentBuckets = 1024;
+static Fd_Code_Fragment *fragment_table[kFragmentBuckets];
+static int fragment_generation = 0;
+
+struct Fd_Node_Index {
+  void *node;
+  int index;
+};
+
+static int compare_node_index(const void *a, const void *b) {
+  const void *pa = ((const Fd_Node_Index*)a)->node, *pb = ((const Fd_Node_Index*)b)->node;
+  return pa < pb ? -1 : (pa > pb ? 1 : 0);
+}
+
+// Add text to a pair of independent hashes, FNV-1a and djb2
+static void state_add(unsigned *state, const char *text, int n) {
+  for (int i = 0; i < n; i++) {
+    unsigned char c = (unsigned char)text[i];
+    state[0] = (state[0] ^ c) * 16777619U;
+    state[1] = (state[1] * 33) ^ c;
+  }
+}
+
+// Return the fragment for this key, adding an empty one if there is none
+static Fd_Code_Fragment *fragment_get(const Fl_String &key, const unsigned *state, bool last, int mode) {
+  unsigned h[2] = { state[0], state[1] };
+  state_add(h, key.data(), key.size());
+  h[0] += (last ? 1 : 0);
+  Fd_Code_Fragment **bucket = fragment_table + (h[0] % kFragmentBuckets);
+  for (Fd_Code_Fragment *c = *bucket; c; c = c->next) {
+    if (c->hash == h[0] && c->state[0] == state[0] && c->state[1] == state[1]
+        && c->last == last && c->mode == mode
+        && c->key.size() == key.size() && !memcmp(c->key.data(), key.data(), key.size()))
+      return c;
+  }
+  Fd_Code_Fragment *c = new Fd_Code_Fragment;
+  c->next = *bucket;
+  c->hash = h[0];
+  c->state[0] = state[0];
+  c->state[1] = state[1];
+  c->last = last;
+  c->mode = mode;
+  c->key = key;
+  *bucket = c;
+  return c;
+}
+
+// Delete all fragments of this mode that were not used by the last call to write_code()
+static void fragment_purge(int mode) {
+  for (int i = 0; i < kFragmentBuckets; i++) {
+    Fd_Code_Fragment **p = fragment_table + i;
+    while (*p) {
+      Fd_Code_Fragment *c = *p;
+      if (c->mode == mode && c->generation != fragment_generation) {
+        *p = c->next;
+        delete c;
+      } else {
+        p = &c->next;
+      }
+    }
+  }
+}
+
+/**
+ Delete all code that was kept for reuse by write_code().
+ */
+void Fd_Code_Writer::clear_cache() {
+  for (int i = 0; i < kFragmentBuckets; i++) {
+    while (fragment_table[i]) {
+      Fd_Code_Fragment *c = fragment_table[i];
+      fragment_table[i] = c->next;
+      delete c;
+    }
+  }
+}
+
+#ifndef NDEBUG
+
+// if not -1, test_cache() decides if write_code() uses the cache
+static int test_use_cache = -1;
+
+// Read a whole file, return false if that fails
+static bool test_read_file(const char *filename, Fl_String &text) {
+  FILE *f = fl_fopen(filename, "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  text = "";
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, (int)n);
+  fclose(f);
+  return true;
+}
+
+/**
+ Check that code reused from the cache is the same as newly written code.
+
+ For every type of i18n, the code of the current project is written once to
+ fill the cache. Then the label of the first widget is added or removed, and
+ the code is written again, with and without the cache. Both results must be
+ the same. Changing an earlier label changes the catgets() message numbers
+ of all later labels, for example.
+
+ This is used by `fluid --test-code-cache name.fl` in debug builds.
+
+ \return 0 if all code was the same, 1 if it was not or if writing failed
+ */
+int Fd_Code_Writer::test_cache() {
+  Fl_Type *w = Fl_Type::first;
+  while (w && !w->is_widget()) w = w->next;
+  if (!w) {
+    fprintf(stderr, "test_cache: the project has no widgets\n");
+    return 1;
+  }
+  Fl_String old_label = w->label() ? w->label() : "";
+  bool had_label = (w->label() != NULL);
+  Fl_String code_file = get_tmpdir() + "test_cache.cxx";
+  Fl_String header_file = get_tmpdir() + "test_cache.h";
+  int saved_i18n_type = g_project.i18n_type;
+  static const char *i18n_names[] = { "none", "GNU gettext", "POSIX catgets" };
+  int ret = 0;
+  undo_suspend();
+  for (int i = FD_I18N_NONE; i <= FD_I18N_POSIX; i++) {
+    g_project.i18n_type = (Fd_I18n_Type)i;
+    Fl_String cached, uncached;
+    clear_cache();
+    test_use_cache = 1;
+    w->label(had_label ? old_label.c_str() : NULL);
+    { Fd_Code_Writer f; f.write_code(code_file.c_str(), header_file.c_str()); }
+    w->label(had_label ? NULL : "test_cache");
+    { Fd_Code_Writer f; f.write_code(code_file.c_str(), header_file.c_str()); }
+    bool ok = test_read_file(code_file.c_str(), cached);
+    clear_cache();
+    test_use_cache = 0;
+    { Fd_Code_Writer f; f.write_code(code_file.c_str(), header_file.c_str()); }
+    ok = test_read_file(code_file.c_str(), uncached) && ok;
+    if (!ok || cached != uncached) {
+      fprintf(stderr, "test_cache: cached code differs with i18n type %s\n", i18n_names[i]);
+      ret = 1;
+    }
+  }
+  clear_cache();
+  w->label(had_label ? old_label.c_str() : NULL);
+  g_project.i18n_type = (Fd_I18n_Type)saved_i18n_type;
+  undo_resume();
+  test_use_cache = -1;
+  fl_unlink(code_file.c_str());
+  fl_unlink(header_file.c_str());
+  return ret;
+}
+
+#endif // NDEBUG
+
+static Fd_Text_Tree *text_tree_insert(Fd_Text_Tree **p, const char *text) {
+  while (*p) {
+    if (strcmp(text, (*p)->text) < 0) p = &((*p)->left);
+    else p = &((*p)->right);
+  }
+  return *p = new Fd_Text_Tree(text);
+}
+
+static void get_positions(const Fl_Type *t, int *pos, int code, int header) {
+  const int *src[12] = {
+    &t->code_static_start, &t->code_static_end, &t->code1_start, &t->code1_end,
+    &t->code2_start, &t->code2_end, &t->header_static_start, &t->header_static_end,
+    &t->header1_start, &t->header1_end, &t->header2_start, &t->header2_end };
+  for (int i = 0; i < 12; i++)
+    pos[i] = (*src[i] < 0) ? -1 : *src[i] - (i < 6 ? code : header);
+}
+
+static void set_positions(Fl_Type *t, const int *pos, int code, int header) {
+  int *dst[12] = {
+    &t->code_static_start, &t->code_static_end, &t->code1_start, &t->code1_end,
+    &t->code2_start, &t->code2_end, &t->header_static_start, &t->header_static_end,
+    &t->header1_start, &t->header1_end, &t->header2_start, &t->header2_end };
+  for (int i = 0; i < 12; i++)
+    *dst[i] = (!pos || pos[i] < 0) ? -1 : pos[i] + (i < 6 ? code : header);
+}
+
+// Read text that was written to f since position start
+static bool read_back(FILE *f, long start, Fl_String &text) {
+  long end = ftell(f);
+  if (end < start) return false;
+  text.resize((int)(end - start));
+  bool ok = (fseek(f, start, SEEK_SET) == 0
+             && fread(text.data(), 1, text.size(), f) == (size_t)text.size());
+  fseek(f, 0, SEEK_END);
+  return ok;
+}
+
+/**
+ Return the index of an object in the nodes of the fragment that is recorded.
+ \return the index, or -1 if the object is not one of these nodes
+ */
+int Fd_Code_Writer::recording_index(void *o) {
+  Fd_Node_Index key = { o, 0 };
+  Fd_Node_Index *n = (Fd_Node_Index*)bsearch(&key, recording_nodes_, recording_count_,
+                                             sizeof(Fd_Node_Index), compare_node_index);
+  return n ? n->index : -1;
+}
+
+/**
+ Remember a change to the writer state, so it can be repeated when the
+ fragment that is recorded is reused.
+ */
+void Fd_Code_Writer::record_effect(int type, int node, const char *text) {
+  Fd_Code_Fragment *c = recording_;
+  if (c->n_effects >= c->effects_alloc) {
+    c->effects_alloc = c->effects_alloc ? 2 * c->effects_alloc : 8;
+    c->effects = (Fd_Code_Effect*)realloc(c->effects, c->effects_alloc * sizeof(Fd_Code_Effect));
+  }
+  Fd_Code_Effect &e = c->effects[c->n_effects++];
+  e.type = type;
+  e.node = node;
+  e.text = fl_strdup(text);
+}
+
+/**
+ Write the static code and the code of a top level node and its children,
+ reusing the code from the last call to write_code() if possible.
+ \param[in] p a top level node
+ \param[inout] state hash of the writer state, updated with the changes
+    made by this fragment
+ \return pointer to the next sibling
+ */
+Fl_Type *Fd_Code_Writer::write_fragment(Fl_Type *p, unsigned *state) {
+  undo_suspend();
+  Fd_Project_Writer out;
+  out.open_write_memory();
+  p->write(out);
+  Fl_String key(out.memory(), out.memory_size());
+  out.close_write();
+  undo_resume();
+
+  Fd_Code_Fragment *c = fragment_get(key, state, (p == Fl_Type::last), write_codeview);
+  c->generation = fragment_generation;
+
+  int i, n = 0;
+  Fl_Type *q;
+  for (q = p; q && (q == p || q->level > p->level); q = q->next) n++;
+  long code_start = ftell(code_file), header_start = ftell(header_file);
+
+  // catgets() message numbers count the labels in all earlier nodes
+  bool posix_i18n = (g_project.i18n_type == FD_I18N_POSIX);
+  if (c->cacheable && c->n_nodes == n && !posix_i18n) {
+    fwrite(c->code.data(), 1, c->code.size(), code_file);
+    fwrite(c->header.data(), 1, c->header.size(), header_file);
+    Fl_Type **nodes = (Fl_Type**)malloc(n * sizeof(Fl_Type*));
+    for (i = 0, q = p; i < n; q = q->next, i++) {
+      nodes[i] = q;
+      set_positions(q, c->pos + 12 * i, (int)code_start, (int)header_start);
+    }
+    for (i = 0; i < c->n_effects; i++) {
+      Fd_Code_Effect &e = c->effects[i];
+      if (e.type == Fd_Code_Effect::UNIQUE_ID) {
+        Fd_Identifier_Tree **t = &id_root;
+        while (*t) t = (strcmp(e.text, (*t)->text) < 0) ? &((*t)->left) : &((*t)->right);
+        *t = new Fd_Identifier_Tree(e.text, nodes[e.node]);
+      } else {
+        text_tree_insert(e.type == Fd_Code_Effect::HEADER_ONCE ? &text_in_header : &text_in_code, e.text);
+      }
+      state_add(state, (const char*)&e.type, sizeof(e.type));
+      state_add(state, e.text, (int)strlen(e.text));
+    }
+    state_add(state, (const char*)&indentation, sizeof(indentation));
+    free(nodes);
+    return q;
+  }
+
+  // write the code and record what is needed to reuse it
+  c->clear();
+  recording_ = c;
+  recording_count_ = n;
+  Fd_Node_Index *nodes = (Fd_Node_Index*)malloc(n * sizeof(Fd_Node_Index));
+  for (i = 0, q = p; i < n; q = q->next, i++) {
+    nodes[i].node = q;
+    nodes[i].index = i;
+    set_positions(q, NULL, 0, 0);
+  }
+  qsort(nodes, n, sizeof(Fd_Node_Index), compare_node_index);
+  recording_nodes_ = nodes;
+  uncacheable = posix_i18n;
+  int indentation_before = indentation;
+
+  write_static(p);
+  q = write_code(p);
+
+  recording_ = NULL;
+  recording_nodes_ = NULL;
+  free(nodes);
+  for (i = 0; i < c->n_effects; i++) {
+    state_add(state, (const char*)&c->effects[i].type, sizeof(c->effects[i].type));
+    state_add(state, c->effects[i].text, (int)strlen(c->effects[i].text));
+  }
+  state_add(state, (const char*)&indentation, sizeof(indentation));
+  if (uncacheable || indentation != indentation_before || current_class || current_widget_class
+      || !read_back(code_file, code_start, c->code)
+      || !read_back(header_file, header_start, c->header)) {
+    c->clear();
+    return q;
+  }
+  c->n_nodes = n;
+  c->pos = (int*)malloc(12 * n * sizeof(int));
+  for (i = 0, q = p; i < n; q = q->next, i++)
+    get_positions(q, c->pos + 12 * i, (int)code_start, (int)header_start);
+  c->cacheable = true;
+  return q;
+}
+
 /**
  Recursively write static code and declarations
  \param[in] p write this type and all its children
@@ -766,10 +1179,43 @@ Fl_Type* Fd_Code_Writer::write_code(Fl_Type* p) {
   return q;
 }
 
+/**
+ Replace a file with a newly written one, unless both have the same contents.
+ \param[in] tmp the new file, it is renamed or deleted
+ \param[in] dst the file to replace
+ \return 1 if dst was kept, 0 if it was replaced, -1 if the rename failed
+ */
+static int replace_if_changed(const char *tmp, const char *dst) {
+  FILE *a = fl_fopen(tmp, "rb");
+  FILE *b = fl_fopen(dst, "rb");
+  bool same = (a && b);
+  while (same) {
+    char ba[8192], bb[8192];
+    size_t na = fread(ba, 1, sizeof(ba), a);
+    size_t nb = fread(bb, 1, sizeof(bb), b);
+    if (na != nb || memcmp(ba, bb, na)) same = false;
+    if (na == 0) break;
+  }
+  if (a) fclose(a);
+  if (b) fclose(b);
+  if (same) {
+    fl_unlink(tmp);
+    return 1;
+  }
+  fl_unlink(dst); // rename() fails on Windows if dst exists
+  return fl_rename(tmp, dst) == 0 ? 0 : -1;
+}
+
 /**
  Write the source and header files for the current design.
 
- If the files already exist, they will be overwritten.
+ If the files already exist, they will be overwritten. If write_if_changed
+ is set, the files are written under a temporary name first, and existing
+ files with the same contents are kept.
+
+ Outside of batch mode, the code of every top level node is kept, and reused
+ by the next call if the node and everything its code depends on did not
+ change, see write_fragment().
 
  \note There is no true error checking here.
 
@@ -783,15 +1229,28 @@ int Fd_Code_Writer::write_code(const char *s, const char *t, bool to_codeview) {
   indentation = 0;
   current_class = 0L;
   current_widget_class = 0L;
+  bool use_tmp = (write_if_changed && s && t && !to_codeview);
+  // reuse code from the last call, unless this is a single batch run, or
+  // MergeBack needs the checksums of all code blocks
+  bool use_cache = (s && t && !batch_mode && !g_project.write_mergeback_data);
+#ifndef NDEBUG
+  if (test_use_cache != -1)
+    use_cache = (s && t && test_use_cache && !g_project.write_mergeback_data);
+#endif
+  Fl_String code_tmp, header_tmp;
+  if (use_tmp) {
+    code_tmp = Fl_String(s) + ".tmp";
+    header_tmp = Fl_String(t) + ".tmp";
+  }
   if (!s) code_file = stdout;
   else {
-    FILE *f = fl_fopen(s, "wb");
+    FILE *f = fl_fopen(use_tmp ? code_tmp.c_str() : s, use_cache ? "w+b" : "wb");
     if (!f) return 0;
     code_file = f;
   }
   if (!t) header_file = stdout;
   else {
-    FILE *f = fl_fopen(t, "wb");
+    FILE *f = fl_fopen(use_tmp ? header_tmp.c_str() : t, use_cache ? "w+b" : "wb");
     if (!f) {fclose(code_file); return 0;}
     header_file = f;
   }
@@ -899,11 +1358,35 @@ int Fd_Code_Writer::write_code(const char *s, const char *t, bool to_codeview) {
       write_c("#endif\n");
     }
   }
-  for (Fl_Type* p = first_type; p;) {
-    // write all static data for this & all children first
-    write_static(p);
-    // then write the nested code:
-    p = write_code(p);
+  if (use_cache) {
+    // everything written so far depends on the project settings, the file
+    // names, and the first comment; the code of widgets also depends on the
+    // names of all functions, see has_toplevel_function()
+    undo_suspend();
+    Fd_Project_Writer out;
+    out.open_write_memory();
+    out.write_header(0);
+    if (first_type != Fl_Type::first) Fl_Type::first->write(out);
+    for (Fl_Type *p = Fl_Type::first; p; p = p->next) {
+      if (p->is_a(ID_Function) && p->name())
+        out.write_string("\n%d %s", p->is_in_class(), p->name());
+    }
+    out.write_string("\n%s\n%s\n%d", s, t, indentation);
+    unsigned state[2] = { 2166136261U, 5381 };
+    state_add(state, out.memory(), out.memory_size());
+    out.close_write();
+    undo_resume();
+    fragment_generation++;
+    for (Fl_Type* p = first_type; p;)
+      p = write_fragment(p, state);
+    fragment_purge(write_codeview);
+  } else {
+    for (Fl_Type* p = first_type; p;) {
+      // write all static data for this & all children first
+      write_static(p);
+      // then write the nested code:
+      p = write_code(p);
+    }
   }
 
   if (!s) return 1;
@@ -930,6 +1413,14 @@ int Fd_Code_Writer::write_code(const char *s, const char *t, bool to_codeview) {
   if (header_file != stdout)
     y = fclose(header_file);
   header_file = 0;
+  if (use_tmp && x >= 0 && y >= 0) {
+    int r = replace_if_changed(code_tmp.c_str(), s);
+    if (r > 0) files_unchanged++;
+    if (r < 0) x = -1;
+    r = replace_if_changed(header_tmp.c_str(), t);
+    if (r > 0) files_unchanged++;
+    if (r < 0) y = -1;
+  }
   return x >= 0 && y >= 0;
 }
 
@@ -966,10 +1457,16 @@ Fd_Code_Writer::Fd_Code_Writer()
   block_line_start_(true),
   block_buffer_(NULL),
   block_buffer_size_(0),
+  recording_(NULL),
+  recording_nodes_(NULL),
+  recording_count_(0),
   indentation(0),
   write_codeview(false),
   varused_test(0),
-  varused(0)
+  varused(0),
+  write_if_changed(false),
+  files_unchanged(0),
+  uncacheable(false)
 {
   block_crc_ = crc32(0, NULL, 0);
 }
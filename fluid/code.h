@@ -27,6 +27,8 @@ class Fl_Type;
 struct Fd_Identifier_Tree;
 struct Fd_Text_Tree;
 struct Fd_Pointer_Tree;
+struct Fd_Code_Fragment;
+struct Fd_Node_Index;
 
 int is_id(char c);
 int write_strings(const Fl_String &filename);
@@ -57,6 +59,17 @@ protected:
   /// size of expanding buffer for vsnprintf
   int block_buffer_size_;
 
+  /// fragment of the code cache that is being written, or NULL
+  Fd_Code_Fragment *recording_;
+  /// nodes of the fragment that is being written, sorted by address
+  Fd_Node_Index *recording_nodes_;
+  /// number of entries in recording_nodes_
+  int recording_count_;
+
+  int recording_index(void *o);
+  void record_effect(int type, int node, const char *text);
+  Fl_Type *write_fragment(Fl_Type *p, unsigned *state);
+
   void crc_add(const void *data, int n=-1);
   int crc_printf(const char *format, ...);
   int crc_vprintf(const char *format, va_list args);
@@ -75,6 +88,14 @@ public:
   int varused_test;
   /// set to 1 if varused_test found that a variable is actually used
   int varused;
+  /// if set, existing files are only replaced if their contents changed, so
+  /// that their modification time is kept and dependent files don't rebuild
+  bool write_if_changed;
+  /// number of files that write_code() left unchanged in write_if_changed mode
+  int files_unchanged;
+  /// set while writing code that depends on more than the project, for
+  /// example on the contents of image or data files, so it is not cached
+  bool uncacheable;
 
 public:
   Fd_Code_Writer();
@@ -92,7 +113,7 @@ public:
   bool c_contains(void* ptr);
   void write_cstring(const char *,int length);
   void write_cstring(const char *);
-  void write_cdata(const char *,int length);
+  void write_cdata(const char *,int length, bool as_string=false);
   void vwrite_c(const char* format, va_list args);
   void write_c(const char*, ...) __fl_attr((__format__ (__printf__, 2, 3)));
   void write_cc(const char *, int, const char*, const char*);
@@ -106,6 +127,11 @@ public:
 
   void tag(int type, unsigned short uid);
 
+  static void clear_cache();
+#ifndef NDEBUG
+  static int test_cache();
+#endif
+
   static unsigned long block_crc(const void *data, int n=-1, unsigned long in_crc=0, bool *inout_line_start=NULL);
 };
 
@@ -116,6 +116,8 @@ void Fd_Project_Reader::expand_buffer(int length) {
 /** \brief Construct local project reader. */
 Fd_Project_Reader::Fd_Project_Reader()
 : fin(NULL),
+  mem_pos(NULL),
+  mem_end(NULL),
   lineno(0),
   fname(NULL),
   buffer(NULL),
@@ -139,6 +141,7 @@ Fd_Project_Reader::~Fd_Project_Reader()
  */
 int Fd_Project_Reader::open_read(const char *s) {
   lineno = 1;
+  mem_pos = mem_end = NULL;
   if (!s) {
     fin = stdin;
     fname = "stdin";
@@ -152,11 +155,32 @@ int Fd_Project_Reader::open_read(const char *s) {
   return 1;
 }
 
+/**
+ Read .fl data from memory instead of a file.
+ The text is not copied and must stay valid until close_read() is called.
+ \param[in] text .fl data, does not need to be NUL terminated
+ \param[in] size number of bytes in text
+ \param[in] name a name for error messages
+ \return 1
+ */
+int Fd_Project_Reader::open_read_memory(const char *text, int size, const char *name) {
+  lineno = 1;
+  fin = NULL;
+  mem_pos = text;
+  mem_end = text + size;
+  fname = name;
+  return 1;
+}
+
 /**
  Close the .fl file.
  \return 0 if the operation failed, 1 if it succeeded
  */
 int Fd_Project_Reader::close_read() {
+  if (mem_pos) {
+    mem_pos = mem_end = NULL;
+    return 1;
+  }
   if (fin != stdin) {
     int x = fclose(fin);
     fin = 0;
@@ -194,7 +218,7 @@ int Fd_Project_Reader::read_quoted() {      // read whatever character is after
       for (c=x=0; x<3; x++) {
         int ch = nextchar();
         d = hexdigit(ch);
-        if (d > 15) {ungetc(ch,fin); break;}
+        if (d > 15) {unget(ch); break;}
         c = (c<<4)+d;
       }
       break;
@@ -204,7 +228,7 @@ int Fd_Project_Reader::read_quoted() {      // read whatever character is after
       for (x=0; x<2; x++) {
         int ch = nextchar();
         d = hexdigit(ch);
-        if (d>7) {ungetc(ch,fin); break;}
+        if (d>7) {unget(ch); break;}
         c = (c<<3)+d;
       }
       break;
@@ -283,6 +307,10 @@ Fl_Type *Fd_Project_Reader::read_children(Fl_Type *p, int merge, Strategy strate
         g_project.avoid_early_includes=1;
         goto CONTINUE;
       }
+      if (!strcmp(c,"image_data_as_strings")) {
+        g_project.image_data_as_strings=1;
+        goto CONTINUE;
+      }
       if (!strcmp(c,"i18n_type")) {
         g_project.i18n_type = static_cast<Fd_I18n_Type>(atoi(read_word()));
         goto CONTINUE;
@@ -432,7 +460,6 @@ Fl_Type *Fd_Project_Reader::read_children(Fl_Type *p, int merge, Strategy strate
  \return 0 if the operation failed, 1 if it succeeded
  */
 int Fd_Project_Reader::read_project(const char *filename, int merge, Strategy strategy) {
-  Fl_Type *o;
   undo_suspend();
   read_version = 0.0;
   if (!open_read(filename)) {
@@ -444,6 +471,19 @@ int Fd_Project_Reader::read_project(const char *filename, int merge, Strategy st
   else
     g_project.reset();
   read_children(Fl_Type::current, merge, strategy);
+  finish_read();
+  int ret = close_read();
+  undo_resume();
+  return ret;
+}
+
+/**
+ Update the project after nodes were read.
+ Rebuilds the menus, makes the first selected node the current node, and
+ updates the dialogs that show project settings.
+ */
+void Fd_Project_Reader::finish_read() {
+  Fl_Type *o;
   // clear this
   Fl_Type::current = 0;
   // Force menu items to be rebuilt...
@@ -465,9 +505,6 @@ int Fd_Project_Reader::read_project(const char *filename, int merge, Strategy st
   }
   g_layout_list.update_dialogs();
   g_project.update_settings_dialog();
-  int ret = close_read();
-  undo_resume();
-  return ret;
 }
 
 /**
@@ -484,7 +521,7 @@ int Fd_Project_Reader::read_project(const char *filename, int merge, Strategy st
 void Fd_Project_Reader::read_error(const char *format, ...) {
   va_list args;
   va_start(args, format);
-  if (!fin) { // FIXME: this line suppresses any error messages in interactive mode
+  if (!fin && !mem_pos) { // FIXME: this line suppresses any error messages in interactive mode
     char buffer[1024]; // TODO: hides class member "buffer"
     vsnprintf(buffer, sizeof(buffer), format, args);
     fl_message("%s", buffer);
@@ -520,7 +557,7 @@ const char *Fd_Project_Reader::read_word(int wantbrace) {
   // skip all the whitespace before it:
   for (;;) {
     x = nextchar();
-    if (x < 0 && feof(fin)) {   // eof
+    if (x < 0 && at_eof()) {   // eof
       return 0;
     } else if (x == '#') {      // comment
       do x = nextchar(); while (x >= 0 && x != '\n');
@@ -574,7 +611,7 @@ const char *Fd_Project_Reader::read_word(int wantbrace) {
       expand_buffer(length);
       x = nextchar();
     }
-    ungetc(x, fin);
+    unget(x);
     buffer[length] = 0;
     return buffer;
 
@@ -606,7 +643,7 @@ int Fd_Project_Reader::read_fdesign_line(const char*& name, const char*& value)
   // find a colon:
   for (;;) {
     x = nextchar();
-    if (x < 0 && feof(fin)) return 0;
+    if (x < 0 && at_eof()) return 0;
     if (x == '\n') {length = 0; continue;} // no colon this line...
     if (!isspace(x & 255)) {
       buffer[length++] = x;
@@ -620,7 +657,7 @@ int Fd_Project_Reader::read_fdesign_line(const char*& name, const char*& value)
   // skip to start of value:
   for (;;) {
     x = nextchar();
-    if ((x < 0 && feof(fin)) || x == '\n' || !isspace(x & 255)) break;
+    if ((x < 0 && at_eof()) || x == '\n' || !isspace(x & 255)) break;
   }
 
   // read the value:
@@ -786,6 +823,9 @@ void Fd_Project_Reader::read_fdesign() {
 /** \brief Construct local project writer. */
 Fd_Project_Writer::Fd_Project_Writer()
 : fout(NULL),
+  mem_buf(NULL),
+  mem_size(0),
+  mem_alloc(0),
   needspace(0),
   write_codeview_(false)
 {
@@ -794,6 +834,8 @@ Fd_Project_Writer::Fd_Project_Writer()
 /** \brief Release project writer resources. */
 Fd_Project_Writer::~Fd_Project_Writer()
 {
+  if (mem_buf)
+    ::free(mem_buf);
 }
 
 /**
@@ -813,12 +855,29 @@ int Fd_Project_Writer::open_write(const char *s) {
   return 1;
 }
 
+/**
+ Write the .fl design to memory instead of a file.
+ The text can be retrieved with memory() and memory_size() until the writer
+ is destroyed.
+ \return 1
+ */
+int Fd_Project_Writer::open_write_memory() {
+  fout = NULL;
+  mem_size = 0;
+  if (!mem_buf) {
+    mem_alloc = 4096;
+    mem_buf = (char*)malloc(mem_alloc);
+  }
+  return 1;
+}
+
 /**
  Close the .fl design file.
- Don't close, if data was sent to stdout.
+ Don't close, if data was sent to stdout or to memory.
  \return 1 if succeeded, 0 if fclose failed
  */
 int Fd_Project_Writer::close_write() {
+  if (!fout) return 1;
   if (fout != stdout) {
     int x = fclose(fout);
     fout = stdout;
@@ -841,6 +900,28 @@ int Fd_Project_Writer::write_project(const char *filename, int selected_only, bo
     undo_resume();
     return 0;
   }
+  write_header(selected_only);
+  for (Fl_Type *p = Fl_Type::first; p;) {
+    if (!selected_only || p->selected) {
+      p->write(*this);
+      write_string("\n");
+      int q = p->level;
+      for (p = p->next; p && p->level > q; p = p->next) {/*empty*/}
+    } else {
+      p = p->next;
+    }
+  }
+  int ret = close_write();
+  undo_resume();
+  return ret;
+}
+
+/**
+ Write the version number and the project settings.
+ \param[in] selected_only if set, skip the settings that are not needed to
+    paste nodes
+ */
+void Fd_Project_Writer::write_header(int selected_only) {
   write_string("# data file for the Fltk User Interface Designer (fluid)\n"
                "version %.4f",FL_VERSION);
   if(!g_project.include_H_from_C)
@@ -851,6 +932,8 @@ int Fd_Project_Writer::write_project(const char *filename, int selected_only, bo
     write_string("\nutf8_in_src");
   if (g_project.avoid_early_includes)
     write_string("\navoid_early_includes");
+  if (g_project.image_data_as_strings)
+    write_string("\nimage_data_as_strings");
   if (g_project.i18n_type) {
     write_string("\ni18n_type %d", g_project.i18n_type);
     switch (g_project.i18n_type) {
@@ -883,20 +966,21 @@ int Fd_Project_Writer::write_project(const char *filename, int selected_only, bo
     if (g_project.write_mergeback_data)
       write_string("\nmergeback %d", g_project.write_mergeback_data);
   }
+}
 
-  for (Fl_Type *p = Fl_Type::first; p;) {
-    if (!selected_only || p->selected) {
-      p->write(*this);
-      write_string("\n");
-      int q = p->level;
-      for (p = p->next; p && p->level > q; p = p->next) {/*empty*/}
-    } else {
-      p = p->next;
-    }
+/**
+ Write a single character to the file or to memory.
+ */
+void Fd_Project_Writer::put_char(char c) {
+  if (fout) {
+    putc(c, fout);
+    return;
   }
-  int ret = close_write();
-  undo_resume();
-  return ret;
+  if (mem_size >= mem_alloc) {
+    mem_alloc *= 2;
+    mem_buf = (char*)realloc(mem_buf, mem_alloc);
+  }
+  mem_buf[mem_size++] = c;
 }
 
 /**
@@ -904,13 +988,13 @@ int Fd_Project_Writer::write_project(const char *filename, int selected_only, bo
  \param[in] w NUL terminated text
  */
 void Fd_Project_Writer::write_word(const char *w) {
-  if (needspace) putc(' ', fout);
+  if (needspace) put_char(' ');
   needspace = 1;
-  if (!w || !*w) {fprintf(fout,"{}"); return;}
+  if (!w || !*w) {put_char('{'); put_char('}'); return;}
   const char *p;
   // see if it is a single word:
   for (p = w; is_id(*p); p++) ;
-  if (!*p) {fprintf(fout,"%s",w); return;}
+  if (!*p) {while (*w) put_char(*w++); return;}
   // see if there are matching braces:
   int n = 0;
   for (p = w; *p; p++) {
@@ -919,7 +1003,7 @@ void Fd_Project_Writer::write_word(const char *w) {
   }
   int mismatched = (n != 0);
   // write out brace-quoted string:
-  putc('{', fout);
+  put_char('{');
   for (; *w; w++) {
     switch (*w) {
     case '{':
@@ -927,12 +1011,12 @@ void Fd_Project_Writer::write_word(const char *w) {
       if (!mismatched) break;
     case '\\':
     case '#':
-      putc('\\',fout);
+      put_char('\\');
       break;
     }
-    putc(*w,fout);
+    put_char(*w);
   }
-  putc('}', fout);
+  put_char('}');
 }
 
 /**
@@ -943,9 +1027,22 @@ void Fd_Project_Writer::write_word(const char *w) {
  */
 void Fd_Project_Writer::write_string(const char *format, ...) {
   va_list args;
+  if (needspace && *format != '\n') put_char(' ');
   va_start(args, format);
-  if (needspace && *format != '\n') fputc(' ',fout);
-  vfprintf(fout, format, args);
+  if (fout) {
+    vfprintf(fout, format, args);
+  } else {
+    int n = vsnprintf(mem_buf + mem_size, mem_alloc - mem_size, format, args);
+    if (n >= mem_alloc - mem_size) {
+      // the text did not fit, make room and format it again
+      va_end(args);
+      while (n >= mem_alloc - mem_size) mem_alloc *= 2;
+      mem_buf = (char*)realloc(mem_buf, mem_alloc);
+      va_start(args, format);
+      vsnprintf(mem_buf + mem_size, mem_alloc - mem_size, format, args);
+    }
+    if (n > 0) mem_size += n;
+  }
   va_end(args);
   needspace = !isspace(format[strlen(format)-1] & 255);
 }
@@ -955,8 +1052,8 @@ void Fd_Project_Writer::write_string(const char *format, ...) {
  \param[in] n indent level
  */
 void Fd_Project_Writer::write_indent(int n) {
-  fputc('\n',fout);
-  while (n--) {fputc(' ',fout); fputc(' ',fout);}
+  put_char('\n');
+  while (n--) {put_char(' '); put_char(' ');}
   needspace = 0;
 }
 
@@ -964,8 +1061,8 @@ void Fd_Project_Writer::write_indent(int n) {
  Write a '{' to the .fl file at the given indenting level.
  */
 void Fd_Project_Writer::write_open() {
-  if (needspace) fputc(' ',fout);
-  fputc('{',fout);
+  if (needspace) put_char(' ');
+  put_char('{');
   needspace = 0;
 }
 
@@ -975,7 +1072,7 @@ void Fd_Project_Writer::write_open() {
  */
 void Fd_Project_Writer::write_close(int n) {
   if (needspace) write_indent(n);
-  fputc('}',fout);
+  put_char('}');
   needspace = 1;
 }
 
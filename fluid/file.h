@@ -21,6 +21,8 @@
 
 #include <FL/fl_attr.h>
 
+#include <stdio.h>
+
 class Fl_Type;
 
 extern int fdesign_flip;
@@ -33,6 +35,10 @@ class Fd_Project_Reader
 protected:
   /// Project input file
   FILE *fin;
+  /// Current read position if reading from memory, or NULL
+  const char *mem_pos;
+  /// End of the text if reading from memory
+  const char *mem_end;
   /// Number of most recently read line
   int lineno;
   /// Pointer to the file path and name (not copied!)
@@ -44,7 +50,17 @@ protected:
 
   void expand_buffer(int length);
 
-  int nextchar() { for (;;) { int ret = fgetc(fin); if (ret!='\r') return ret; } }
+  int nextchar() {
+    for (;;) {
+      int ret = mem_pos ? (mem_pos < mem_end ? (unsigned char)*mem_pos++ : EOF) : fgetc(fin);
+      if (ret!='\r') return ret;
+    }
+  }
+  void unget(int c) {
+    if (!mem_pos) ungetc(c, fin);
+    else if (c != EOF) mem_pos--;
+  }
+  bool at_eof() { return mem_pos ? (mem_pos >= mem_end) : (feof(fin) != 0); }
 
 public:
   /// Holds the file version number after reading the "version" tag
@@ -54,7 +70,9 @@ public:
   Fd_Project_Reader();
   ~Fd_Project_Reader();
   int open_read(const char *s);
+  int open_read_memory(const char *text, int size, const char *name);
   int close_read();
+  void finish_read();
   const char *filename_name();
   int read_quoted();
   Fl_Type *read_children(Fl_Type *p, int merge, Strategy strategy, char skip_options=0);
@@ -71,23 +89,37 @@ class Fd_Project_Writer
 protected:
   // Project output file, always opened in "wb" mode
   FILE *fout;
+  /// Output buffer if writing to memory, or NULL
+  char *mem_buf;
+  /// Number of bytes written to mem_buf
+  int mem_size;
+  /// Allocated size of mem_buf
+  int mem_alloc;
   /// If set, one space is written before text unless the format starts with a newline character
   int needspace;
   /// Set if this file will be used in the codeview dialog
   bool write_codeview_;
 
+  void put_char(char c);
+
 public:
   Fd_Project_Writer();
   ~Fd_Project_Writer();
   int open_write(const char *s);
+  int open_write_memory();
   int close_write();
   int write_project(const char *filename, int selected_only, bool codeview);
+  void write_header(int selected_only);
   void write_word(const char *);
   void write_string(const char *,...) __fl_attr((__format__ (__printf__, 2, 3)));
   void write_indent(int n);
   void write_open();
   void write_close(int n);
   FILE *file() const { return fout; }
+  /// Return the text written so far if writing to memory, not NUL terminated
+  const char *memory() const { return mem_buf; }
+  /// Return the number of bytes written so far if writing to memory
+  int memory_size() const { return mem_size; }
   bool write_codeview() const { return write_codeview_; }
 };
 
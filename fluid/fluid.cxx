@@ -168,9 +168,28 @@ int compile_file = 0;           // fluid -c
 /// Set, if Fluid was started with the command line argument -cs
 int compile_strings = 0;        // fluid -cs
 
+#ifndef NDEBUG
+/// Set, if Fluid was started with the command line argument --test-code-cache
+static int test_code_cache = 0; // fluid --test-code-cache
+#endif
+
 /// Set, if Fluid runs in batch mode, and no user interface is activated.
 int batch_mode = 0;             // if set (-c, -u) don't open display
 
+/// Number of files that are processed in parallel in batch mode, set with -j
+static int batch_jobs = 0;
+
+/// .fl files given on the command line in batch mode
+static char **batch_files = NULL;
+static int batch_count = 0;
+static int batch_alloc = 0;
+
+/// Set if write_code_files() must keep code files whose content didn't change
+static bool batch_write_if_changed = false;
+
+/// Number of code files that the last write_code_files() call left unchanged
+static int batch_files_unchanged = 0;
+
 /// command line arguments that overrides the generate code file extension or name
 Fl_String g_code_filename_arg;
 
@@ -212,6 +231,7 @@ Fluid_Project::Fluid_Project() :
   use_FL_COMMAND(0),
   utf8_in_src(0),
   avoid_early_includes(0),
+  image_data_as_strings(0),
   header_file_set(0),
   code_file_set(0),
   write_mergeback_data(0),
@@ -231,6 +251,7 @@ Fluid_Project::~Fluid_Project() {
  */
 void Fluid_Project::reset() {
   ::delete_all();
+  Fd_Code_Writer::clear_cache();
   i18n_type = FD_I18N_NONE;
 
   i18n_gnu_include = "<libintl.h>";
@@ -247,6 +268,7 @@ void Fluid_Project::reset() {
   use_FL_COMMAND = 0;
   utf8_in_src = 0;
   avoid_early_includes = 0;
+  image_data_as_strings = 0;
   header_file_set = 0;
   code_file_set = 0;
   header_file_name = ".h";
@@ -1225,7 +1247,9 @@ int write_code_files(bool dont_show_completion_dialog)
 
   // -- write the code and header files
   if (!batch_mode) enter_project_dir();
+  f.write_if_changed = batch_write_if_changed;
   int x = f.write_code(code_filename.c_str(), header_filename.c_str());
+  batch_files_unchanged = f.files_unchanged;
   Fl_String code_filename_rel = fl_filename_relative(code_filename);
   Fl_String header_filename_rel = fl_filename_relative(header_filename);
   if (!batch_mode) leave_project_dir();
@@ -2119,6 +2143,10 @@ static int arg(int argc, char** argv, int& i) {
     batch_mode++;
     i++; return 1;
   }
+  if (argv[i][1] == 'j' && !argv[i][2] && i+1 < argc) {
+    batch_jobs = atoi(argv[i+1]);
+    i += 2; return 2;
+  }
   if (argv[i][1] == 'o' && !argv[i][2] && i+1 < argc) {
     g_code_filename_arg = argv[i+1];
     batch_mode++;
@@ -2129,6 +2157,11 @@ static int arg(int argc, char** argv, int& i) {
     g_autodoc_path = argv[i+1];
     i += 2; return 2;
   }
+  if (strcmp(argv[i], "--test-code-cache") == 0) {
+    test_code_cache++;
+    batch_mode++;
+    i++; return 1;
+  }
 #endif
   if (argv[i][1] == 'h' && !argv[i][2]) {
     if ( (i+1 < argc) && (argv[i+1][0] != '-') ) {
@@ -2148,6 +2181,8 @@ static int arg(int argc, char** argv, int& i) {
 
 int quit_flag = 0;
 #include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #ifdef _sigargs
 #define SIGARG _sigargs
 #else
@@ -2167,6 +2202,142 @@ static void sigint(SIGARG) {
 
 #endif
 
+/**
+ Add a file to the list of files to process in batch mode.
+ A filename starting with '@' names a text file that lists one .fl file per
+ line. Empty lines and lines starting with '#' are ignored.
+ \param[in] name .fl filename, or '@' followed by the name of a list file
+ \return 0 if the list file can't be read, 1 otherwise
+ */
+static int batch_add_file(const char *name) {
+  if (name[0] == '@') {
+    FILE *f = fl_fopen(name + 1, "rb");
+    if (!f) {
+      fprintf(stderr, "%s : %s\n", name + 1, strerror(errno));
+      return 0;
+    }
+    char line[FL_PATH_MAX];
+    while (fgets(line, sizeof(line), f)) {
+      char *a = line, *b = line + strlen(line);
+      while (*a && isspace(*a & 255)) a++;
+      while (b > a && isspace(b[-1] & 255)) *--b = 0;
+      if (*a && *a != '#') batch_add_file(a);
+    }
+    fclose(f);
+    return 1;
+  }
+  if (batch_count == batch_alloc) {
+    batch_alloc = batch_alloc ? 2 * batch_alloc : 16;
+    batch_files = (char**)realloc(batch_files, batch_alloc * sizeof(char*));
+  }
+  batch_files[batch_count++] = fl_strdup(name);
+  return 1;
+}
+
+/**
+ Apply the -o and -h command line arguments to the current project.
+ Command line arguments override code and header filenames from the project
+ file in batch mode only.
+ */
+static void apply_filename_args() {
+  if (!g_code_filename_arg.empty()) {
+    g_project.code_file_set = 1;
+    g_project.code_file_name = g_code_filename_arg;
+  }
+  if (!g_header_filename_arg.empty()) {
+    g_project.header_file_set = 1;
+    g_project.header_file_name = g_header_filename_arg;
+  }
+}
+
+/**
+ Read one .fl file and write the files requested on the command line.
+ Prints the time it took, and if the code files were left unchanged.
+ \param[in] name .fl filename
+ \return 0 if successful, 1 if the file could not be read
+ \note In batch mode, write errors exit() the program.
+ */
+static int batch_process_file(const char *name) {
+  Fl_Timestamp start = Fl::now();
+  set_filename(name);
+  undo_suspend();
+  int ok = read_file(name, 0);
+  undo_resume();
+  if (!ok) {
+    fprintf(stderr, "%s : %s\n", name, strerror(errno));
+    return 1;
+  }
+  apply_filename_args();
+  batch_files_unchanged = 0;
+  if (update_file)
+    write_file(name, 0);
+  if (compile_file) {
+    if (compile_strings)
+      write_strings_cb(0,0);
+    write_cb(0,0);
+  }
+  printf("%9.1f ms  %s%s\n", Fl::seconds_since(start) * 1000.0, name,
+         (compile_file && batch_files_unchanged == 2) ? " (unchanged)" : "");
+  fflush(stdout);
+  return 0;
+}
+
+/**
+ Process all .fl files given on the command line in batch mode.
+
+ Files are processed by up to batch_jobs worker processes, each forked from
+ this process after the start up, so that the start up cost is only paid once.
+ The project data is global to Fluid, so a worker process handles one file
+ and exits. On Windows, files are processed one after the other.
+
+ Code and header files whose content didn't change are not replaced, so
+ that their dependencies are not rebuilt.
+
+ \return the number of files that failed
+ */
+static int batch_process_files() {
+  int failed = 0;
+  batch_write_if_changed = true;
+  fflush(stdout);
+  fflush(stderr);
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  for (int i = 0; i < batch_count; i++)
+    failed += batch_process_file(batch_files[i]);
+#else
+  int jobs = batch_jobs;
+  if (jobs <= 0) jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (jobs <= 0) jobs = 1;
+  int next = 0, running = 0;
+  while (next < batch_count || running > 0) {
+    while (running < jobs && next < batch_count) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        int ret = batch_process_file(batch_files[next]);
+        fflush(stderr);
+        _exit(ret);
+      }
+      if (pid < 0) {
+        // can't fork, process the file here
+        failed += batch_process_file(batch_files[next++]);
+        continue;
+      }
+      next++;
+      running++;
+    }
+    if (running == 0) continue;
+    int status;
+    pid_t pid = wait(&status);
+    if (pid < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    running--;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+  }
+#endif
+  return failed;
+}
+
 /**
  Start Fluid.
 
@@ -2193,18 +2364,33 @@ int main(int argc,char **argv) {
   g_launch_path = end_with_slash(fl_getcwd()); // store the current path at launch
 
   Fl::args_to_utf8(argc, argv); // for MSYS2/MinGW
-  if (   (Fl::args(argc,argv,i,arg) == 0)     // unsupported argument found
-      || (batch_mode && (i != argc-1))        // .fl filename missing
+  int args_ok = Fl::args(argc,argv,i,arg);
+  if (args_ok && batch_mode) {
+    for (int j = i; j < argc; j++) {
+      if (argv[j][0] == '-' || !batch_add_file(argv[j])) { args_ok = 0; break; }
+    }
+    if (batch_count > 1 || batch_jobs || (i < argc && argv[i][0] == '@')) {
+      // several files: -o and -h can only set the extensions
+      if (   (!g_code_filename_arg.empty() && g_code_filename_arg[0] != '.')
+          || (!g_header_filename_arg.empty() && g_header_filename_arg[0] != '.'))
+        args_ok = 0;
+    }
+  }
+  if (   (args_ok == 0)                       // unsupported argument found
+      || (batch_mode && (i > argc-1))         // .fl filename missing
       || (!batch_mode && (i < argc-1))        // more than one filename found
       || (argv[i] && (argv[i][0] == '-'))) {  // unknown option
     static const char *msg =
-      "usage: %s <switches> name.fl\n"
+      "usage: %s <switches> name.fl ...\n"
       " -u : update .fl file and exit (may be combined with '-c' or '-cs')\n"
       " -c : write .cxx and .h and exit\n"
       " -cs : write .cxx and .h and strings and exit\n"
       " -o <name> : .cxx output filename, or extension if <name> starts with '.'\n"
       " -h <name> : .h output filename, or extension if <name> starts with '.'\n"
-      " -d : enable internal debugging\n";
+      " -j <n> : process up to n files in parallel in batch mode (default: number of CPUs)\n"
+      " -d : enable internal debugging\n"
+      "In batch mode, several .fl files can be given, and @<file> reads the\n"
+      "names of .fl files from <file>. Code files that didn't change are kept.\n";
     const char *app_name = NULL;
     if ( (argc > 0) && argv[0] && argv[0][0] )
       app_name = fl_filename_name(argv[0]);
@@ -2226,6 +2412,9 @@ int main(int argc,char **argv) {
 
   make_main_window();
 
+  if (batch_mode && (batch_count > 1 || batch_jobs || (c && c[0] == '@')))
+    exit(batch_process_files() ? 1 : 0);
+
   if (c) set_filename(c);
   if (!batch_mode) {
 #ifdef __APPLE__
@@ -2261,16 +2450,14 @@ int main(int argc,char **argv) {
 
   // command line args override code and header filenames from the project file
   // in batch mode only
-  if (batch_mode) {
-    if (!g_code_filename_arg.empty()) {
-      g_project.code_file_set = 1;
-      g_project.code_file_name = g_code_filename_arg;
-    }
-    if (!g_header_filename_arg.empty()) {
-      g_project.header_file_set = 1;
-      g_project.header_file_name = g_header_filename_arg;
-    }
-  }
+  if (batch_mode)
+    apply_filename_args();
+
+#ifndef NDEBUG
+  // check that code reused from the code cache is written correctly
+  if (test_code_cache)
+    exit(Fd_Code_Writer::test_cache());
+#endif
 
   if (update_file) {            // fluid -u
     write_file(c,0);
@@ -161,6 +161,10 @@ public:
   int utf8_in_src;
   /// If set, <FL/Fl.H> will not be included from the header code before anything else
   int avoid_early_includes;
+  /// If set, image data is written as string literals instead of lists of numbers.
+  /// Data larger than 65000 bytes is always written as numbers, as Visual C++
+  /// rejects longer string literals.
+  int image_data_as_strings;
   /// If set, command line overrides header file name in .fl file.
   int header_file_set;
   ///  If set, command line overrides source code file name in .fl file.
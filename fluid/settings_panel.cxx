@@ -441,6 +441,19 @@ static void cb_avoid_early_includes_button(Fl_Check_Button* o, void* v) {
   }
 }
 
+Fl_Check_Button *image_data_as_strings_button=(Fl_Check_Button *)0;
+
+static void cb_image_data_as_strings_button(Fl_Check_Button* o, void* v) {
+  if (v == LOAD) {
+    o->value(g_project.image_data_as_strings);
+  } else {
+    if (g_project.image_data_as_strings != o->value()) {
+      set_modflag(1);
+      g_project.image_data_as_strings = o->value();
+    }
+  }
+}
+
 Fl_Check_Button *w_proj_mergeback=(Fl_Check_Button *)0;
 
 static void cb_w_proj_mergeback(Fl_Check_Button* o, void* v) {
@@ -2652,14 +2665,23 @@ Fl_Double_Window* make_settings_window() {
           avoid_early_includes_button->labelsize(11);
           avoid_early_includes_button->callback((Fl_Callback*)cb_avoid_early_includes_button);
         } // Fl_Check_Button* avoid_early_includes_button
-        { Fl_Box* o = new Fl_Box(100, 283, 0, 20, "Experimental: ");
+        { image_data_as_strings_button = new Fl_Check_Button(100, 280, 220, 20, "write image data as strings");
+          image_data_as_strings_button->tooltip("Inline image data is written as string literals, which compile much faster th"
+"an lists of numbers. Images with more than 65000 bytes of data are still writt"
+"en as numbers, because some compilers, like Visual C++, limit the size of stri"
+"ng literals to 64 kBytes.");
+          image_data_as_strings_button->down_box(FL_DOWN_BOX);
+          image_data_as_strings_button->labelsize(11);
+          image_data_as_strings_button->callback((Fl_Callback*)cb_image_data_as_strings_button);
+        } // Fl_Check_Button* image_data_as_strings_button
+        { Fl_Box* o = new Fl_Box(100, 308, 0, 20, "Experimental: ");
           o->labelfont(1);
           o->labelsize(11);
           o->align(Fl_Align(FL_ALIGN_LEFT));
           o->hide();
         } // Fl_Box* o
         { // // Matt: disabled
-          w_proj_mergeback = new Fl_Check_Button(100, 283, 220, 20, "generate MergeBack data");
+          w_proj_mergeback = new Fl_Check_Button(100, 308, 220, 20, "generate MergeBack data");
           w_proj_mergeback->tooltip("MergeBack is a feature under construction that allows changes in code files t"
 "o be merged back into the project file. Checking this option will generate add"
 "itional data in code and project files.");
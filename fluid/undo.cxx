@@ -24,26 +24,24 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Window.H>
-#include <FL/Fl_Preferences.H>
 #include <FL/Fl_Menu_Bar.H>
 #include <FL/fl_ask.H>
-#include "fluid_filename.h"
 #include "../src/flstring.h"
 
-#if defined(_WIN32) && !defined(__CYGWIN__)
-#  include <io.h>
-#  include <windows.h>
-#  define getpid (int)GetCurrentProcessId
-#else
-#  include <unistd.h>
-#endif // _WIN32 && !__CYGWIN__
+#include <stdlib.h>
 
 
 //
-// This file implements an undo system using temporary files; ideally
-// we'd like to do this in memory, however the current data structures
-// and design aren't well-suited...  Instead, we save and restore
-// checkpoint files.
+// This file implements an undo system using checkpoints of the project
+// that are kept in memory.
+//
+// A checkpoint is the project in .fl format, split into one chunk for the
+// header with the project settings and one chunk per top level node. Chunks
+// are shared between checkpoints, so an edit only adds the chunks that
+// changed. When a checkpoint is restored, only the top level nodes between
+// the first and the last chunk that differ from the current project are
+// deleted and read again. The whole project is read again only if the
+// project settings changed.
 //
 
 extern Fl_Window* the_panel;
@@ -56,24 +54,168 @@ static int undo_paused = 0;             // Undo checkpointing paused?
 int undo_once_type = 0;                 // Suspend further undos of the same type
 
 
-// Return the undo filename.
-// The filename is constructed in a static internal buffer and
-// this buffer is overwritten by every call of this function.
-// The return value is a pointer to this internal string.
-static char *undo_filename(int level) {
-  static char undo_path[FL_PATH_MAX] = ""; // Undo path
-  static unsigned int undo_path_len = 0;   // length w/o filename
+// A piece of .fl text, shared by all checkpoints that contain it
+struct Undo_Chunk {
+  Undo_Chunk *next;                     // next chunk in the same hash bucket
+  unsigned hash;
+  int size;
+  int refs;                             // number of checkpoints using it
+  char text[1];
+};
+
+// A checkpoint: the header chunk followed by one chunk per top level node
+struct Undo_Checkpoint {
+  int count;
+  Undo_Chunk *chunk[1];
+};
+
+static const int kChunkBuckets = 1024;
+static Undo_Chunk *chunk_table[kChunkBuckets];
+
+static Undo_Checkpoint **checkpoints = NULL; // indexed by undo level
+static int checkpoints_alloc = 0;
+
+// Return a chunk with the given text, sharing an existing one if possible
+static Undo_Chunk *chunk_get(const char *text, int size) {
+  unsigned h = 2166136261U; // FNV-1a
+  for (int i = 0; i < size; i++) h = (h ^ (unsigned char)text[i]) * 16777619U;
+  Undo_Chunk **bucket = chunk_table + (h % kChunkBuckets);
+  for (Undo_Chunk *c = *bucket; c; c = c->next) {
+    if (c->hash == h && c->size == size && !memcmp(c->text, text, size)) {
+      c->refs++;
+      return c;
+    }
+  }
+  Undo_Chunk *c = (Undo_Chunk*)malloc(sizeof(Undo_Chunk) + size);
+  c->next = *bucket;
+  c->hash = h;
+  c->size = size;
+  c->refs = 1;
+  memcpy(c->text, text, size);
+  *bucket = c;
+  return c;
+}
+
+static void chunk_release(Undo_Chunk *c) {
+  if (--c->refs > 0) return;
+  Undo_Chunk **p = chunk_table + (c->hash % kChunkBuckets);
+  while (*p != c) p = &(*p)->next;
+  *p = c->next;
+  free(c);
+}
+
+static void checkpoint_free(Undo_Checkpoint *cp) {
+  if (!cp) return;
+  for (int i = 0; i < cp->count; i++) chunk_release(cp->chunk[i]);
+  free(cp);
+}
 
-  if (!undo_path_len) {
-    fluid_prefs.getUserdataPath(undo_path, sizeof(undo_path));
-    undo_path_len = (unsigned int)strlen(undo_path);
+// Write the current project into a new checkpoint
+static Undo_Checkpoint *checkpoint_make() {
+  int n = 1;
+  for (Fl_Type *p = Fl_Type::first; p; p = p->next)
+    if (p->level == 0) n++;
+  Undo_Checkpoint *cp = (Undo_Checkpoint*)malloc(sizeof(Undo_Checkpoint) + (n - 1) * sizeof(Undo_Chunk*));
+  cp->count = 0;
+
+  undo_suspend();
+  Fd_Project_Writer out;
+  out.open_write_memory();
+  out.write_header(0);
+  cp->chunk[cp->count++] = chunk_get(out.memory(), out.memory_size());
+  for (Fl_Type *p = Fl_Type::first; p; p = p->next) {
+    if (p->level != 0) continue;
+    int start = out.memory_size();
+    p->write(out);
+    out.write_string("\n");
+    cp->chunk[cp->count++] = chunk_get(out.memory() + start, out.memory_size() - start);
   }
+  out.close_write();
+  undo_resume();
+  return cp;
+}
 
-  // append filename: "undo_PID_LEVEL.fl"
-  snprintf(undo_path + undo_path_len,
-           sizeof(undo_path) - undo_path_len - 1,
-           "undo_%d_%d.fl", getpid(), level);
-  return undo_path;
+// Store a checkpoint of the current project at the given undo level
+static void checkpoint_store(int level) {
+  if (level >= checkpoints_alloc) {
+    int n = checkpoints_alloc ? 2 * checkpoints_alloc : 32;
+    while (level >= n) n *= 2;
+    checkpoints = (Undo_Checkpoint**)realloc(checkpoints, n * sizeof(Undo_Checkpoint*));
+    memset(checkpoints + checkpoints_alloc, 0, (n - checkpoints_alloc) * sizeof(Undo_Checkpoint*));
+    checkpoints_alloc = n;
+  }
+  checkpoint_free(checkpoints[level]);
+  checkpoints[level] = checkpoint_make();
+}
+
+// Read the chunks first..last-1 of a checkpoint
+static void checkpoint_read(Fd_Project_Reader &f, Undo_Checkpoint *cp,
+                            int first, int last, int merge) {
+  int size = 0;
+  for (int i = first; i < last; i++) size += cp->chunk[i]->size;
+  char *text = (char*)malloc(size > 0 ? size : 1);
+  size = 0;
+  for (int i = first; i < last; i++) {
+    memcpy(text + size, cp->chunk[i]->text, cp->chunk[i]->size);
+    size += cp->chunk[i]->size;
+  }
+  f.open_read_memory(text, size, "undo checkpoint");
+  if (merge) {
+    // nodes are added after Fl_Type::current, no header to read
+    f.read_version = FL_VERSION;
+    f.read_children(Fl_Type::current, 1, kAddAfterCurrent, 1);
+  } else {
+    g_project.reset();
+    f.read_children(NULL, 0, kAddAsLastChild);
+  }
+  f.close_read();
+  free(text);
+}
+
+// Replace the current project with the checkpoint at the given undo level.
+// Returns 0 if there is no such checkpoint.
+static int checkpoint_restore(int level) {
+  Undo_Checkpoint *target = (level >= 0 && level < checkpoints_alloc) ? checkpoints[level] : NULL;
+  if (!target) return 0;
+  Undo_Checkpoint *current = checkpoint_make();
+
+  undo_suspend();
+  Fd_Project_Reader f;
+  if (current->chunk[0] != target->chunk[0]) {
+    // the project settings changed, read everything
+    checkpoint_read(f, target, 0, target->count, 0);
+  } else {
+    // find the range of top level nodes that differ
+    int nc = current->count, nt = target->count;
+    int head = 1, tail = 0;
+    while (head < nc && head < nt && current->chunk[head] == target->chunk[head])
+      head++;
+    while (tail < nc - head && tail < nt - head
+           && current->chunk[nc - 1 - tail] == target->chunk[nt - 1 - tail])
+      tail++;
+    // delete nodes head..nc-tail-1, keeping the node before them as the anchor
+    Fl_Type *anchor = NULL, *p = Fl_Type::first;
+    for (int i = 1; p; p = p->next) {
+      if (p->level != 0) continue;
+      if (i == head) break;
+      anchor = p;
+      i++;
+    }
+    for (int i = head; i < nc - tail && p; i++) {
+      Fl_Type *next = p->next_sibling();
+      delete_children(p);
+      delete p;
+      p = next;
+    }
+    Fl_Type::current = anchor;
+    if (head < nt - tail)
+      checkpoint_read(f, target, head, nt - tail, 1);
+  }
+  f.finish_read();
+  undo_resume();
+
+  checkpoint_free(current);
+  return 1;
 }
 
 
@@ -91,8 +233,8 @@ void redo_cb(Fl_Widget *, void *) {
   undo_suspend();
   if (widget_browser) widget_browser->save_scroll_position();
   int reload_panel = (the_panel && the_panel->visible());
-  if (!read_file(undo_filename(undo_current + 1), 0)) {
-    // Unable to read checkpoint file, don't redo...
+  if (!checkpoint_restore(undo_current + 1)) {
+    // No checkpoint, don't redo...
     widget_browser->rebuild();
     g_project.update_settings_dialog();
     undo_resume();
@@ -130,7 +272,7 @@ void undo_cb(Fl_Widget *, void *) {
   }
 
   if (undo_current == undo_last) {
-    write_file(undo_filename(undo_current));
+    checkpoint_store(undo_current);
   }
 
   undo_suspend();
@@ -139,8 +281,8 @@ void undo_cb(Fl_Widget *, void *) {
   // TODO: make the scroll position part of the .fl project file
   if (widget_browser) widget_browser->save_scroll_position();
   int reload_panel = (the_panel && the_panel->visible());
-  if (!read_file(undo_filename(undo_current - 1), 0)) {
-    // Unable to read checkpoint file, don't undo...
+  if (!checkpoint_restore(undo_current - 1)) {
+    // No checkpoint, don't undo...
     widget_browser->rebuild();
     g_project.update_settings_dialog();
     set_modflag(0, 0);
@@ -156,7 +298,7 @@ void undo_cb(Fl_Widget *, void *) {
     }
   }
   // Restore old browser position.
-  // Ideally, we would save the browser position insied the undo file.
+  // Ideally, we would save the browser position inside the checkpoint.
   if (widget_browser) widget_browser->restore_scroll_position();
 
   undo_current --;
@@ -194,12 +336,12 @@ void undo_checkpoint() {
   // int redo_item = main_menubar->find_index(redo_cb);
   undo_once_type = 0;
 
-  // Save the current UI to a checkpoint file...
-  const char *filename = undo_filename(undo_current);
-  if (!write_file(filename)) {
-    // Don't attempt to do undo stuff if we can't write a checkpoint file...
-    perror(filename);
-    return;
+  // Save the current UI to a checkpoint, and drop the checkpoints that
+  // can no longer be redone...
+  checkpoint_store(undo_current);
+  for (int i = undo_current + 1; i <= undo_max && i < checkpoints_alloc; i++) {
+    checkpoint_free(checkpoints[i]);
+    checkpoints[i] = NULL;
   }
 
   // Update the saved level...
@@ -220,9 +362,10 @@ void undo_checkpoint() {
 void undo_clear() {
   // int undo_item = main_menubar->find_index(undo_cb);
   // int redo_item = main_menubar->find_index(redo_cb);
-  // Remove old checkpoint files...
-  for (int i = 0; i <= undo_max; i ++) {
-    fl_unlink(undo_filename(i));
+  // Remove old checkpoints...
+  for (int i = 0; i < checkpoints_alloc; i ++) {
+    checkpoint_free(checkpoints[i]);
+    checkpoints[i] = NULL;
   }
 
   // Reset current, last, and save indices...
@@ -26,6 +26,8 @@
 #include "Fl_Timeout.h"
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Tooltip.H>
+#include <FL/Fl_Shortcut_Index.H>
+#include <FL/Fl_Widget_Profiler.H>
 #include <FL/fl_draw.H>
 
 #include <ctype.h>
@@ -67,6 +69,17 @@ char            *Fl::e_text = (char *)"";
 int             Fl::e_length;
 const char      *Fl::e_clipboard_type = "";
 void            *Fl::e_clipboard_data = NULL;
+int             Fl::e_paste_more = 0;
+Fl_Paste_Progress_Handler Fl::paste_progress_ = NULL;
+void            *Fl::paste_progress_data_ = NULL;
+int             Fl::paste_streaming_ = 0;
+int             Fl::e_history_count = 0;
+int             *Fl::e_history = NULL;
+int             Fl::e_coalesce = Fl::COALESCE_ALL;
+double          Fl::frame_interval_ = 0;
+double          Fl::next_frame_ = 0;
+Fl_Timestamp    Fl::frame_origin_;
+Fl_Frame_Stats  Fl::frame_stats_;
 
 Fl_Event_Dispatch Fl::e_dispatch = 0;
 Fl_Callback_Reason Fl::callback_reason_ = FL_REASON_UNKNOWN;
@@ -800,7 +813,9 @@ void Fl::redraw() {
   Causes all the windows that need it to be redrawn and graphics forced
   out through the pipes.
 
-  This is what wait() does before looking for events.
+  This is what wait() does before looking for events, through
+  Fl::flush_frame() which may postpone it to the next frame.
+  The time spent drawing is added to Fl::frame_stats().
 
   Note: in multi-threaded applications you should only call Fl::flush()
   from the main thread. If a child thread needs to trigger a redraw event,
@@ -810,12 +825,21 @@ void Fl::redraw() {
 void Fl::flush() {
   if (damage()) {
     damage_ = 0;
+    Fl_Timestamp start = Fl::now();
+    double draw_time = 0;
+    bool drawn = false;
     for (Fl_X* i = Fl_X::first; i; i = i->next) {
       Fl_Window* wi = i->w;
       if (Fl_Window_Driver::driver(wi)->wait_for_expose_value) {damage_ = 1; continue;}
       if (!wi->visible_r()) continue;
       if (wi->damage()) {
-        Fl_Window_Driver::driver(wi)->flush();
+        Fl_Timestamp t = Fl::now();
+        {
+          Fl_Widget_Profiler::Scope prof(Fl_Widget_Profiler::DRAW, wi, wi->damage());
+          Fl_Window_Driver::driver(wi)->flush();
+        }
+        draw_time += Fl::seconds_since(t);
+        drawn = true;
         wi->clear_damage();
       }
       // destroy damage regions for windows that don't use them:
@@ -824,11 +848,108 @@ void Fl::flush() {
         i->region = 0;
       }
     }
+    screen_driver()->flush();
+    if (drawn) {
+      double flush_time = Fl::seconds_since(start);
+      frame_stats_.frames++;
+      frame_stats_.draw_time += draw_time;
+      frame_stats_.flush_time += flush_time;
+      if (flush_time > frame_stats_.max_flush_time) frame_stats_.max_flush_time = flush_time;
+      frame_stats_.last_draw_time = draw_time;
+      frame_stats_.last_flush_time = flush_time;
+      if (frame_interval_ > 0 && flush_time > frame_interval_) frame_stats_.missed_frames++;
+    }
+    return;
   }
   screen_driver()->flush();
 }
 
 
+// Frame pacing, see Fl::frame_rate(double)
+
+static void frame_timeout(void *) {
+  // nothing to do: returning to the event loop calls Fl::flush_frame()
+}
+
+/**
+  Redraws damaged windows, at most once per frame.
+
+  This is what the event loop calls instead of Fl::flush(). If no frame
+  rate is set, it is the same as Fl::flush(). Otherwise, if the previous
+  frame was drawn less than a frame interval ago, drawing is postponed
+  to the next frame: redraw requests made until then are merged, and
+  the windows are drawn once.
+  \see Fl::frame_rate(double)
+  \since 1.4.0
+*/
+void Fl::flush_frame() {
+  if (frame_interval_ <= 0 || !damage()) {
+    flush();
+    return;
+  }
+  double now = Fl::seconds_since(frame_origin_);
+  if (now < next_frame_) {
+    frame_stats_.deferred_flushes++;
+    if (!Fl::has_timeout(frame_timeout))
+      Fl::add_timeout(next_frame_ - now, frame_timeout);
+    screen_driver()->flush();
+    return;
+  }
+  // keep frames on a regular schedule, unless we fell behind by a frame or more
+  next_frame_ += frame_interval_;
+  if (next_frame_ <= now) next_frame_ = now + frame_interval_;
+  flush();
+}
+
+/**
+  Sets the maximum number of times per second the event loop redraws
+  windows.
+
+  By default (\p fps = 0) the event loop redraws damaged windows each time
+  it has handled events, timeouts or idle callbacks. Programs that call
+  Fl_Widget::redraw() from many timeouts or Fl::awake() callbacks can redraw
+  far more often than the screen refreshes. With a frame rate, e.g. 60,
+  redraw requests made between two frames are merged and windows are
+  drawn at most \p fps times per second.
+
+  Calls to Fl::flush() by the program are not affected, they always redraw
+  immediately.
+
+  \param[in] fps  maximum frames per second, or 0 to redraw without delay
+  \see Fl::frame_stats()
+  \since 1.4.0
+*/
+void Fl::frame_rate(double fps) {
+  frame_interval_ = fps > 0 ? 1.0 / fps : 0;
+  frame_origin_ = Fl::now();
+  next_frame_ = 0;
+  Fl::remove_timeout(frame_timeout);
+}
+
+/**
+  Returns the maximum number of times per second the event loop redraws
+  windows, or 0 if there is no limit.
+  \see Fl::frame_rate(double)
+*/
+double Fl::frame_rate() {
+  return frame_interval_ > 0 ? 1.0 / frame_interval_ : 0;
+}
+
+/**
+  Returns the drawing statistics collected since the program started or
+  since the last call to Fl::reset_frame_stats().
+  \since 1.4.0
+*/
+const Fl_Frame_Stats &Fl::frame_stats() {
+  return frame_stats_;
+}
+
+/** Clears the statistics returned by Fl::frame_stats(). */
+void Fl::reset_frame_stats() {
+  memset(&frame_stats_, 0, sizeof(frame_stats_));
+}
+
+
 ////////////////////////////////////////////////////////////////
 // Event handlers:
 
@@ -1265,13 +1386,41 @@ static int send_event(int event, Fl_Widget* to, Fl_Window* window) {
   }
   int save_x = Fl::e_x; Fl::e_x += dx;
   int save_y = Fl::e_y; Fl::e_y += dy;
+  Fl_Widget_Profiler::Scope prof(Fl_Widget_Profiler::HANDLE, to, event);
   int ret = to->handle(Fl::e_number = event);
+  prof.result(ret);
   Fl::e_number = old_event;
   Fl::e_y = save_y;
   Fl::e_x = save_x;
   return ret;
 }
 
+// Sends FL_SHORTCUT to the widgets of Fl_Shortcut_Index that have a
+// matching shortcut and can be reached by the broadcast in Fl::handle_(),
+// i.e. are in the window of 'wi' or in Fl::first_window(), which is tried
+// first, and take events.
+static int send_indexed_shortcut(Fl_Widget *wi, Fl_Window *window) {
+  Fl_Widget *list[32];
+  int n = Fl_Shortcut_Index::find(list, 32);
+  if (!n) return 0;
+  Fl_Window *tops[2];
+  tops[0] = Fl::first_window();
+  tops[1] = wi ? wi->top_window() : 0;
+  for (int t = 0; t < 2; t++) {
+    if (!tops[t] || (t && tops[1] == tops[0])) continue;
+    for (int i = 0; i < n; i++) {
+      Fl_Widget *w = list[i];
+      // a callback of another widget may have deleted it:
+      if (!Fl_Shortcut_Index::indexed(w)) continue;
+      Fl_Widget *p = w;
+      while (p->parent() && p->takesevents()) p = p->parent();
+      if (p != tops[t]) continue;
+      if (send_event(FL_SHORTCUT, w, window)) return 1;
+    }
+  }
+  return 0;
+}
+
 /**
  \brief Give the reason for calling a callback.
  \return the reason for the current callback
@@ -1542,6 +1691,9 @@ int Fl::handle_(int e, Fl_Window* window)
 
     // Try it as shortcut, sending to mouse widget and all parents:
     wi = find_active(belowmouse()); // STR #3216
+    if (Fl_Shortcut_Index::enabled() &&
+        send_indexed_shortcut(wi ? wi : modal() ? modal() : window, window))
+      return 1;
     if (!wi) {
       wi = modal();
       if (!wi) wi = window;
@@ -1719,6 +1871,7 @@ void Fl_Widget::redraw_label() {
 }
 
 void Fl_Widget::damage(uchar fl) {
+  Fl_Widget_Profiler::damage(this, fl);
   if (type() < FL_WINDOW) {
     // damage only the rectangle covered by a child widget:
     damage(fl, x(), y(), w(), h());
@@ -16,6 +16,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Button.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Window.H>
 #include <FL/fl_draw.H>
@@ -316,3 +317,8 @@ Fl_Toggle_Button::Fl_Toggle_Button(int X,int Y,int W,int H,const char *L)
  \param[in] v switch compact mode on (1) or off (0)
  */
 void Fl_Button::compact(uchar v) { compact_ = v; }
+
+void Fl_Button::shortcut(int s) {
+  shortcut_ = s;
+  Fl_Shortcut_Index::shortcut(this, s);
+}
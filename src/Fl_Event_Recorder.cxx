@@ -0,0 +1,472 @@
+//
+// Event recorder for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+// File format: a header line, then one line per window and per event.
+// Windows get a number when they receive their first recorded event:
+//
+//   FLTK event recording 1
+//   W <window> <label>
+//   E <time in µs> <event> <window> <x> <y> <dx> <dy> <state> <keysym>
+//     <original keysym> <clicks> <is_click> <text>
+//
+// Strings start with '=' followed by their bytes, where control characters,
+// spaces, '%' and DEL are written as %XX.
+
+#include <FL/Fl_Event_Recorder.H>
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
+#include <FL/fl_utf8.h>
+#include <FL/fl_string_functions.h>
+#include <FL/names.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool Fl_Event_Recorder::recording_ = false;
+bool Fl_Event_Recorder::replaying_ = false;
+int Fl_Event_Recorder::recorded_ = 0;
+
+static const char *header_ = "FLTK event recording 1";
+
+// recording state
+static FILE *rec_file_ = NULL;
+static Fl_Event_Dispatch prev_dispatch_ = NULL;
+static Fl_Timestamp rec_origin_;
+struct Rec_Window {
+  Fl_Window *window;
+  char *label;
+};
+static Rec_Window *rec_windows_ = NULL;
+static int rec_window_count_ = 0, rec_window_alloc_ = 0;
+
+// replay state
+struct Rec_Event {
+  double time;
+  int event, window, x, y, dx, dy, state, keysym, original_keysym, clicks, is_click;
+  char *text;
+  int length;
+};
+static Rec_Event *events_ = NULL;
+static int event_count_ = 0;
+static char **labels_ = NULL;   // window labels, indexed by window number
+static int label_count_ = 0;
+static int next_ = 0;
+static double speed_ = 1.0;
+static Fl_Timestamp replay_origin_;
+static Fl_Replay_Done_Handler done_ = NULL;
+static void *done_data_ = NULL;
+static Fl_Event_Recorder::Result *results_ = NULL;
+static int result_count_ = 0;
+static char empty_text_[1] = "";
+
+
+static bool same_label(const char *a, const char *b) {
+  if (!a || !b) return a == b;
+  return strcmp(a, b) == 0;
+}
+
+// Only events that come from the user are recorded. Window mapping,
+// screen and drag and drop events depend on the state of the desktop.
+static bool recordable(int e) {
+  switch (e) {
+    case FL_PUSH: case FL_RELEASE: case FL_ENTER: case FL_LEAVE:
+    case FL_DRAG: case FL_FOCUS: case FL_UNFOCUS: case FL_KEYDOWN:
+    case FL_KEYUP: case FL_CLOSE: case FL_MOVE: case FL_SHORTCUT:
+    case FL_MOUSEWHEEL: case FL_ZOOM_GESTURE: case FL_ZOOM_EVENT:
+      return true;
+    case FL_PASTE:
+      return Fl::event_clipboard_type() == Fl::clipboard_plain_text;
+    default:
+      return false;
+  }
+}
+
+static void write_string(FILE *f, const char *s, int n) {
+  fputc('=', f);
+  for (int i = 0; i < n; i++) {
+    unsigned char c = (unsigned char)s[i];
+    if (c <= ' ' || c == '%' || c == 0x7f) fprintf(f, "%%%02X", c);
+    else fputc(c, f);
+  }
+}
+
+// Decodes the string at s in place, without its leading '='.
+// Returns its length, or -1 if s is not a string.
+static int read_string(char *s) {
+  if (*s != '=') return -1;
+  char *d = s;
+  for (const char *p = s + 1; *p && *p != '\n' && *p != '\r'; p++) {
+    unsigned v;
+    if (*p == '%' && sscanf(p + 1, "%2X", &v) == 1) { *d++ = (char)v; p += 2; }
+    else *d++ = *p;
+  }
+  *d = 0;
+  return (int)(d - s);
+}
+
+static int window_number(Fl_Window *w) {
+  for (int i = 0; i < rec_window_count_; i++) {
+    if (rec_windows_[i].window == w && same_label(rec_windows_[i].label, w->label()))
+      return i;
+  }
+  if (rec_window_count_ >= rec_window_alloc_) {
+    rec_window_alloc_ = rec_window_alloc_ ? 2 * rec_window_alloc_ : 8;
+    rec_windows_ = (Rec_Window*)realloc(rec_windows_, rec_window_alloc_ * sizeof(Rec_Window));
+  }
+  Rec_Window &r = rec_windows_[rec_window_count_];
+  r.window = w;
+  r.label = w->label() ? fl_strdup(w->label()) : NULL;
+  fprintf(rec_file_, "W %d ", rec_window_count_);
+  write_string(rec_file_, r.label ? r.label : "", r.label ? (int)strlen(r.label) : 0);
+  fputc('\n', rec_file_);
+  return rec_window_count_++;
+}
+
+
+int Fl_Event_Recorder::dispatch_(int e, Fl_Window *window) {
+  if (recording_ && window && recordable(e)) {
+    int n = window_number(window);
+    long t = (long)(Fl::seconds_since(rec_origin_) * 1e6);
+    fprintf(rec_file_, "E %ld %d %d %d %d %d %d %d %d %d %d %d ",
+            t, e, n, Fl::e_x, Fl::e_y, Fl::e_dx, Fl::e_dy, Fl::e_state,
+            Fl::e_keysym, Fl::e_original_keysym, Fl::e_clicks, Fl::e_is_click);
+    if (e == FL_PASTE || e == FL_KEYDOWN || e == FL_KEYUP || e == FL_SHORTCUT)
+      write_string(rec_file_, Fl::e_text ? Fl::e_text : "", Fl::e_text ? Fl::e_length : 0);
+    else
+      fputc('=', rec_file_);
+    fputc('\n', rec_file_);
+    recorded_++;
+  }
+  if (prev_dispatch_) return prev_dispatch_(e, window);
+  return Fl::handle_(e, window);
+}
+
+
+/**
+  Starts recording events to a file.
+  A recording in progress is stopped first.
+  \return 0 on success, -1 if the file can't be created.
+*/
+int Fl_Event_Recorder::start(const char *filename) {
+  if (recording_) stop();
+  rec_file_ = fl_fopen(filename, "w");
+  if (!rec_file_) return -1;
+  fprintf(rec_file_, "%s\n", header_);
+  if (Fl::event_dispatch() != dispatch_) {
+    prev_dispatch_ = Fl::event_dispatch();
+    Fl::event_dispatch(dispatch_);
+  }
+  rec_origin_ = Fl::now();
+  recorded_ = 0;
+  recording_ = true;
+  return 0;
+}
+
+
+/**
+  Stops recording and closes the file.
+  \return 0 on success, -1 if there was no recording or the file couldn't
+    be written completely.
+*/
+int Fl_Event_Recorder::stop() {
+  if (!recording_) return -1;
+  recording_ = false;
+  // leave the dispatch function in place if another one was set after ours
+  if (Fl::event_dispatch() == dispatch_) {
+    Fl::event_dispatch(prev_dispatch_);
+    prev_dispatch_ = NULL;
+  }
+  for (int i = 0; i < rec_window_count_; i++) free(rec_windows_[i].label);
+  free(rec_windows_);
+  rec_windows_ = NULL;
+  rec_window_count_ = rec_window_alloc_ = 0;
+  int ret = (ferror(rec_file_) || fclose(rec_file_)) ? -1 : 0;
+  rec_file_ = NULL;
+  return ret;
+}
+
+
+static void free_events() {
+  for (int i = 0; i < event_count_; i++) free(events_[i].text);
+  free(events_);
+  events_ = NULL;
+  event_count_ = 0;
+  for (int i = 0; i < label_count_; i++) free(labels_[i]);
+  free(labels_);
+  labels_ = NULL;
+  label_count_ = 0;
+}
+
+// Reads a recording, returns the number of events or -1
+static int load(const char *filename) {
+  FILE *f = fl_fopen(filename, "rb");
+  if (!f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *data = (size < 0) ? NULL : (char*)malloc(size + 1);
+  if (!data) {                          // not seekable, or out of memory
+    fclose(f);
+    return -1;
+  }
+  size = (long)fread(data, 1, size, f);
+  fclose(f);
+  data[size] = 0;
+  size_t hl = strlen(header_);
+  if (strncmp(data, header_, hl) != 0 || (data[hl] != '\n' && data[hl] != '\r')) {
+    free(data);
+    return -1;
+  }
+  int alloc = 0;
+  for (char *line = data; line; ) {
+    char *eol = strchr(line, '\n');
+    if (eol) *eol++ = 0;
+    int n, pos = 0;
+    if (line[0] == 'W' && sscanf(line, "W %d %n", &n, &pos) >= 1 && pos && n >= 0 && n < 100000) {
+      if (n >= label_count_) {
+        labels_ = (char**)realloc(labels_, (n + 1) * sizeof(char*));
+        while (label_count_ <= n) labels_[label_count_++] = NULL;
+      }
+      free(labels_[n]);
+      labels_[n] = read_string(line + pos) >= 0 ? fl_strdup(line + pos) : NULL;
+    } else if (line[0] == 'E') {
+      Rec_Event ev;
+      long t;
+      if (sscanf(line, "E %ld %d %d %d %d %d %d %d %d %d %d %d %n", &t, &ev.event, &ev.window,
+                 &ev.x, &ev.y, &ev.dx, &ev.dy, &ev.state, &ev.keysym, &ev.original_keysym,
+                 &ev.clicks, &ev.is_click, &pos) >= 12 && pos) {
+        ev.time = t / 1e6;
+        ev.length = read_string(line + pos);
+        ev.text = ev.length > 0 ? (char*)malloc(ev.length + 1) : NULL;
+        if (ev.text) memcpy(ev.text, line + pos, ev.length + 1);
+        if (ev.length < 0) ev.length = 0;
+        if (event_count_ >= alloc) {
+          alloc = alloc ? 2 * alloc : 1024;
+          events_ = (Rec_Event*)realloc(events_, alloc * sizeof(Rec_Event));
+        }
+        events_[event_count_++] = ev;
+      }
+    }
+    line = eol;
+  }
+  free(data);
+  return event_count_;
+}
+
+static Fl_Window *find_window(int n) {
+  const char *label = (n >= 0 && n < label_count_) ? labels_[n] : NULL;
+  if (label && !*label) label = NULL;
+  for (Fl_Window *w = Fl::first_window(); w; w = Fl::next_window(w)) {
+    if (same_label(w->label(), label)) return w;
+  }
+  return Fl::first_window();
+}
+
+static void add_result(const Fl_Event_Recorder::Result &r) {
+  // results_ has room for all events, see replay()
+  results_[result_count_++] = r;
+}
+
+static void send(const Rec_Event &ev, double due) {
+  Fl_Window *win = find_window(ev.window);
+  if (!win) return;
+  Fl::e_x = ev.x;
+  Fl::e_y = ev.y;
+  Fl::e_x_root = win->x_root() + ev.x;
+  Fl::e_y_root = win->y_root() + ev.y;
+  Fl::e_dx = ev.dx;
+  Fl::e_dy = ev.dy;
+  Fl::e_state = ev.state;
+  Fl::e_keysym = ev.keysym;
+  Fl::e_original_keysym = ev.original_keysym;
+  Fl::e_clicks = ev.clicks;
+  Fl::e_is_click = ev.is_click;
+  Fl::e_text = ev.text ? ev.text : empty_text_;
+  Fl::e_length = ev.length;
+  if (ev.event == FL_PASTE) {
+    Fl::e_clipboard_type = Fl::clipboard_plain_text;
+    Fl::e_clipboard_data = NULL;
+  }
+  Fl_Event_Recorder::Result r;
+  r.event = ev.event;
+  r.time = due;
+  Fl_Timestamp t0 = Fl::now();
+  r.delay = Fl::seconds_between(t0, replay_origin_) - due;
+  if (r.delay < 0) r.delay = 0;
+  r.handled = Fl::handle(ev.event, win);
+  Fl_Timestamp t1 = Fl::now();
+  Fl::flush();
+  Fl_Timestamp t2 = Fl::now();
+  r.handle_time = Fl::seconds_between(t1, t0);
+  r.flush_time = Fl::seconds_between(t2, t1);
+  // the event text belongs to the recording
+  Fl::e_text = empty_text_;
+  Fl::e_length = 0;
+  add_result(r);
+}
+
+static double due_time(int i) {
+  if (speed_ <= 0) return Fl::seconds_since(replay_origin_);
+  return events_[i].time / speed_;
+}
+
+
+void Fl_Event_Recorder::replay_cb_(void *) {
+  if (next_ < event_count_) {
+    send(events_[next_], due_time(next_));
+    next_++;
+  }
+  if (!replaying_) return; // stop_replay() was called by the event handler
+  if (next_ < event_count_) {
+    double wait = due_time(next_) - Fl::seconds_since(replay_origin_);
+    Fl::add_timeout(wait > 0 ? wait : 0, replay_cb_);
+    return;
+  }
+  stop_replay();
+}
+
+
+/**
+  Starts replaying the events recorded in a file.
+  Events are sent from a timeout, so the program must run the event loop,
+  e.g. with Fl::run(). Results of an earlier replay are discarded.
+
+  \param[in] filename  a file written by start() and stop()
+  \param[in] speed     pace of the replay: 1 is the recorded pace, 2 twice as
+                       fast, and 0 sends each event as soon as the previous
+                       one has been handled and drawn
+  \param[in] done      optional function called when the replay ends
+  \param[in] data      user data passed to \p done
+  \return the number of events to replay, or -1 if the file can't be read
+    or is not a recording
+*/
+int Fl_Event_Recorder::replay(const char *filename, double speed,
+                              Fl_Replay_Done_Handler done, void *data) {
+  if (replaying_) {
+    done_ = NULL;
+    stop_replay();
+  }
+  free_events();
+  free(results_);
+  results_ = NULL;
+  result_count_ = 0;
+  int n = load(filename);
+  if (n < 0) {
+    free_events();
+    return -1;
+  }
+  results_ = (Result*)malloc((n > 0 ? n : 1) * sizeof(Result));
+  speed_ = speed;
+  done_ = done;
+  done_data_ = data;
+  next_ = 0;
+  replaying_ = true;
+  replay_origin_ = Fl::now();
+  Fl::add_timeout(n > 0 ? due_time(0) : 0, replay_cb_);
+  return n;
+}
+
+
+/**
+  Stops a replay in progress.
+  The function given to replay() is called, and the results of the
+  events sent so far remain available.
+*/
+void Fl_Event_Recorder::stop_replay() {
+  if (!replaying_) return;
+  Fl::remove_timeout(replay_cb_);
+  replaying_ = false;
+  free_events();
+  Fl_Replay_Done_Handler done = done_;
+  done_ = NULL;
+  if (done) done(done_data_);
+}
+
+
+/** Returns the number of events replayed by the last replay(). */
+int Fl_Event_Recorder::results() {
+  return result_count_;
+}
+
+
+/** Returns the timing of replayed event \p i, with 0 <= i < results(), or NULL. */
+const Fl_Event_Recorder::Result *Fl_Event_Recorder::result(int i) {
+  return (i >= 0 && i < result_count_) ? results_ + i : NULL;
+}
+
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// Writes mean, median, 95th percentile and maximum of v[0..n-1], in µs
+static void write_stats(FILE *f, const char *name, double *v, int n) {
+  qsort(v, n, sizeof(double), compare_doubles);
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += v[i];
+  fprintf(f, "\"%s\": {\"mean\": %.1f, \"p50\": %.1f, \"p95\": %.1f, \"max\": %.1f}",
+          name, sum / n * 1e6, v[n / 2] * 1e6, v[(n * 95) / 100 < n ? (n * 95) / 100 : n - 1] * 1e6,
+          v[n - 1] * 1e6);
+}
+
+
+/**
+  Writes the results of the last replay to a JSON file.
+  The file contains the mean, median, 95th percentile and maximum handling
+  and flush times for each event type, followed by the timing of each event.
+  Times are in microseconds.
+  \return 0 on success, -1 if the file can't be written.
+*/
+int Fl_Event_Recorder::write_report(const char *filename) {
+  FILE *f = fl_fopen(filename, "w");
+  if (!f) return -1;
+  int n = result_count_;
+  double *handle = new double[n > 0 ? n : 1];
+  double *flush = new double[n > 0 ? n : 1];
+  fprintf(f, "{\"speed\": %g, \"events\": %d,\n \"summary\": [\n", speed_, n);
+  bool first = true;
+  for (int e = 0; e <= FL_ZOOM_EVENT; e++) {
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+      if (results_[i].event != e) continue;
+      handle[k] = results_[i].handle_time;
+      flush[k] = results_[i].flush_time;
+      k++;
+    }
+    if (!k) continue;
+    fprintf(f, "%s  {\"event\": \"%s\", \"count\": %d, ", first ? "" : ",\n", fl_eventnames[e], k);
+    write_stats(f, "handle_us", handle, k);
+    fputs(", ", f);
+    write_stats(f, "flush_us", flush, k);
+    fputc('}', f);
+    first = false;
+  }
+  fputs("\n ],\n \"results\": [\n", f);
+  for (int i = 0; i < n; i++) {
+    Result &r = results_[i];
+    fprintf(f, "  {\"event\": \"%s\", \"handled\": %d, \"time_us\": %.0f, \"delay_us\": %.1f, "
+            "\"handle_us\": %.1f, \"flush_us\": %.1f}%s\n",
+            (r.event >= 0 && r.event <= FL_ZOOM_EVENT) ? fl_eventnames[r.event] : "?",
+            r.handled, r.time * 1e6, r.delay * 1e6, r.handle_time * 1e6, r.flush_time * 1e6,
+            i < n - 1 ? "," : "");
+  }
+  fputs(" ]\n}\n", f);
+  delete[] handle;
+  delete[] flush;
+  return fclose(f) == 0 ? 0 : -1;
+}
@@ -41,6 +41,7 @@ const Fl_Graphics_Driver::matrix Fl_Graphics_Driver::m0 = {1, 0, 0, 1, 0, 0};
 unsigned Fl_Graphics_Driver::need_pixmap_bg_color = 0;
 
 extern unsigned fl_cmap[256]; // defined in fl_color.cxx
+extern void fl_clear_text_layout_cache(const Fl_Graphics_Driver *driver); // in fl_draw.cxx
 
 /** Constructor */
 Fl_Graphics_Driver::Fl_Graphics_Driver()
@@ -63,6 +64,7 @@ Fl_Graphics_Driver::Fl_Graphics_Driver()
 /** Destructor */
 Fl_Graphics_Driver::~Fl_Graphics_Driver() {
   if (xpoint) free(xpoint);
+  fl_clear_text_layout_cache(this);
 }
 
 
@@ -22,7 +22,9 @@
 
 #include <FL/Fl_Group.H>
 #include "Fl_Window_Driver.H"
+#include "Fl_Spatial_Index.H"
 #include <FL/Fl_Rect.H>
+#include <FL/Fl_Widget_Profiler.H>
 #include <FL/fl_draw.H>
 
 #include <stdlib.h> // malloc etc.
@@ -48,6 +50,10 @@ Fl_Widget*const* Fl_Group::array() const {
   Returns children() if the widget is NULL or not found.
 */
 int Fl_Group::find(const Fl_Widget* o) const {
+  if (spatial_ && spatial_->valid()) {
+    int i = spatial_->find(o);
+    return i < 0 ? children_ : i;
+  }
   Fl_Widget*const* a = array();
   int i; for (i=0; i < children_; i++) if (*a++ == o) break;
   return i;
@@ -93,7 +99,12 @@ extern Fl_Widget* fl_oldfocus; // set by Fl::focus
 // windows so they are relative to that window.
 
 static int send(Fl_Widget* o, int event) {
-  if (!o->as_window()) return o->handle(event);
+  Fl_Widget_Profiler::Scope prof(Fl_Widget_Profiler::HANDLE, o, event);
+  if (!o->as_window()) {
+    int ret = o->handle(event);
+    prof.result(ret);
+    return ret;
+  }
   switch ( event )
   {
   case FL_DND_ENTER: /* FALLTHROUGH */
@@ -104,6 +115,7 @@ static int send(Fl_Widget* o, int event) {
   int save_x = Fl::e_x; Fl::e_x -= o->x();
   int save_y = Fl::e_y; Fl::e_y -= o->y();
   int ret = o->handle(event);
+  prof.result(ret);
   Fl::e_y = save_y;
   Fl::e_x = save_x;
   switch ( event )
@@ -142,11 +154,30 @@ static int navkey() {
   return 0;
 }
 
+// Maximum number of children under the mouse found with the spatial index
+static const int MAX_HITS = 32;
+
+// Sets 'a' to the children that may contain the mouse position, in child
+// order, and returns their number. These are the children found with the
+// spatial index, or all 'n' children if there's no index or too many hits.
+static int children_at_mouse(Fl_Spatial_Index *index, Fl_Widget*const* &a,
+                             int n, Fl_Widget **hits) {
+  if (!index || !n) return n;
+  if (!index->valid()) index->rebuild(a, n);
+  int k = index->at(Fl::event_x(), Fl::event_y(), hits, MAX_HITS);
+  if (k < 0) return n;
+  a = hits;
+  return k;
+}
+
 int Fl_Group::handle(int event) {
 
   Fl_Widget*const* a = array();
   int i;
   Fl_Widget* o;
+  Fl_Widget* hits[MAX_HITS];
+  Fl_Widget*const* h = a;     // children under the mouse
+  int n;
 
   switch (event) {
 
@@ -188,8 +219,9 @@ int Fl_Group::handle(int event) {
 
   case FL_ENTER:
   case FL_MOVE:
-    for (i = children(); i--;) {
-      o = a[i];
+    n = children_at_mouse(spatial_, h, children(), hits);
+    for (i = n; i--;) {
+      o = h[i];
       if (o->visible() && Fl::event_inside(o)) {
         if (o->contains(Fl::belowmouse())) {
           return send(o,FL_MOVE);
@@ -204,8 +236,9 @@ int Fl_Group::handle(int event) {
 
   case FL_DND_ENTER:
   case FL_DND_DRAG:
-    for (i = children(); i--;) {
-      o = a[i];
+    n = children_at_mouse(spatial_, h, children(), hits);
+    for (i = n; i--;) {
+      o = h[i];
       if (o->takesevents() && Fl::event_inside(o)) {
         if (o->contains(Fl::belowmouse())) {
           return send(o,FL_DND_DRAG);
@@ -219,8 +252,9 @@ int Fl_Group::handle(int event) {
     return 0;
 
   case FL_PUSH:
-    for (i = children(); i--;) {
-      o = a[i];
+    n = children_at_mouse(spatial_, h, children(), hits);
+    for (i = n; i--;) {
+      o = h[i];
       if (o->takesevents() && Fl::event_inside(o)) {
         Fl_Widget_Tracker wp(o);
         if (send(o,FL_PUSH)) {
@@ -237,8 +271,9 @@ int Fl_Group::handle(int event) {
     if (o == this) return 0;
     else if (o) send(o,event);
     else {
-      for (i = children(); i--;) {
-        o = a[i];
+      n = children_at_mouse(spatial_, h, children(), hits);
+      for (i = n; i--;) {
+        o = h[i];
         if (o->takesevents() && Fl::event_inside(o)) {
           if (send(o,event)) return 1;
         }
@@ -247,8 +282,9 @@ int Fl_Group::handle(int event) {
     return 0;
 
   case FL_MOUSEWHEEL:
-    for (i = children(); i--;) {
-      o = a[i];
+    n = children_at_mouse(spatial_, h, children(), hits);
+    for (i = n; i--;) {
+      o = h[i];
       if (o->takesevents() && Fl::event_inside(o) && send(o,FL_MOUSEWHEEL))
         return 1;
     }
@@ -357,6 +393,7 @@ Fl_Group::Fl_Group(int X,int Y,int W,int H,const char *l)
   resizable_ = this;
   bounds_ = 0; // this is allocated when first resize() is done
   sizes_ = 0; // see bounds_ (FLTK 1.3 compatibility)
+  spatial_ = 0;
 
   // Subclasses may want to construct child objects as part of their
   // constructor, so make sure they are add()'d to this object.
@@ -382,6 +419,7 @@ void Fl_Group::clear() {
   savedfocus_ = 0;
   resizable_ = this;
   init_sizes();
+  if (spatial_) spatial_->invalidate();
 
   // we must change the Fl::pushed() widget, if it is one of
   // the group's children. Otherwise fl_fix_focus() would send lots
@@ -447,6 +485,7 @@ Fl_Group::~Fl_Group() {
   if (current_ == this)
     end();
   clear();
+  delete spatial_;
 }
 
 /**
@@ -526,6 +565,7 @@ void Fl_Group::insert(Fl_Widget &o, int index) {
         memmove(array_+(index+1), array_+index, (n-index) * sizeof(Fl_Widget*));
       array_[index] = &o;
       init_sizes();
+      if (spatial_) spatial_->invalidate();
       return;
     }
     g->remove(n);
@@ -549,6 +589,10 @@ void Fl_Group::insert(Fl_Widget &o, int index) {
     int j; for (j = children_; j > index; j--) array_[j] = array_[j-1];
     array_[j] = &o;
   }
+  if (spatial_) {
+    if (index >= children_) spatial_->append(&o);
+    else spatial_->invalidate();
+  }
   children_++;
   init_sizes();
 }
@@ -595,6 +639,10 @@ void Fl_Group::remove(int index) {
 
   // remove the widget from the group
 
+  if (spatial_) {
+    if (index == children_ - 1) spatial_->remove_last();
+    else spatial_->invalidate();
+  }
   children_--;
   if (children_ == 1) { // go from 2 to 1 child
     Fl_Widget *t = array_[!index];
@@ -848,6 +896,7 @@ void Fl_Group::resize(int X, int Y, int W, int H) {
     // didn't change, at least on macOS, if it's a rescale.
 
     if (Fl_Window::is_a_rescale() || dx || dy) {
+      if (spatial_) spatial_->invalidate();
       Fl_Widget*const* a = array();
       for (int i = children_; i--;) {
         Fl_Widget* o = *a++;
@@ -884,6 +933,7 @@ void Fl_Group::resize(int X, int Y, int W, int H) {
     p++;
 
     // resize children
+    if (spatial_) spatial_->invalidate();
     Fl_Widget*const* a = array();
 
     for (int i = children_; i--; p++) {
@@ -910,6 +960,40 @@ void Fl_Group::resize(int X, int Y, int W, int H) {
   } // End of part 2: we have a resizable() widget
 }
 
+/**
+  Enables or disables an index of the children by position.
+
+  Groups with many children, like canvases with thousands of nodes or map
+  items, can use a grid of cells of \p cell_size pixels to find the children
+  under the mouse in handle(), the child in find(), and to skip clipped
+  children in draw_children(), instead of testing all of them.
+  Choose a cell size close to the typical size of the children.
+  A \p cell_size of 0 (the default) disables the index.
+
+  The index is kept up to date when children are added or removed, and
+  when a child is moved or resized with Fl_Widget::resize(). Widgets whose
+  resize() method doesn't call the resize() method of their base class
+  must not be used as children.
+
+  \param[in] cell_size  cell size in pixels, or 0
+  \see spatial_index() const
+  \since 1.4.0
+*/
+void Fl_Group::spatial_index(int cell_size) {
+  if (spatial_ && spatial_->cell_size() == cell_size) return;
+  delete spatial_;
+  spatial_ = cell_size > 0 ? new Fl_Spatial_Index(cell_size) : 0;
+}
+
+/**
+  Returns the cell size of the spatial index, or 0 if there is none.
+  \see spatial_index(int)
+  \since 1.4.0
+*/
+int Fl_Group::spatial_index() const {
+  return spatial_ ? spatial_->cell_size() : 0;
+}
+
 /**
   Draws all children of the group.
 
@@ -927,7 +1011,27 @@ void Fl_Group::draw_children() {
                  h() - Fl::box_dh(box()));
   }
 
-  if (damage() & ~FL_DAMAGE_CHILD) { // redraw the entire thing:
+  // with a spatial index, find the children in the visible part of the
+  // area they cover, if that's cheaper than testing all of them
+  const int *v = 0;
+  int nv = -1;
+  if (spatial_ && children_ && (damage() & ~FL_DAMAGE_CHILD)) {
+    if (!spatial_->valid()) spatial_->rebuild(a, children_);
+    int X, Y, W, H;
+    if (spatial_->extent(X, Y, W, H) && fl_clip_box(X, Y, W, H, X, Y, W, H))
+      nv = spatial_->in(X, Y, W, H, v);
+  }
+
+  if (nv >= 0) { // redraw the entire thing, skipping clipped children:
+    for (int i = 0, j = 0; i < children_; i++) {
+      Fl_Widget& o = *a[i];
+      if (j < nv && v[j] == i) {
+        draw_child(o);
+        j++;
+      }
+      draw_outside_label(o); // the label may be outside the clipped child
+    }
+  } else if (damage() & ~FL_DAMAGE_CHILD) { // redraw the entire thing:
     for (int i=children_; i--;) {
       Fl_Widget& o = **a++;
       draw_child(o);
@@ -959,6 +1063,7 @@ void Fl_Group::draw() {
 void Fl_Group::update_child(Fl_Widget& widget) const {
   if (widget.damage() && widget.visible() && widget.type() < FL_WINDOW &&
       fl_not_clipped(widget.x(), widget.y(), widget.w(), widget.h())) {
+    Fl_Widget_Profiler::Scope prof(Fl_Widget_Profiler::DRAW, &widget, widget.damage());
     widget.draw();
     widget.clear_damage();
   }
@@ -975,6 +1080,7 @@ void Fl_Group::draw_child(Fl_Widget& widget) const {
       fl_not_clipped(widget.x(), widget.y(), widget.w(), widget.h())) {
     // The following call clears all damage flags and then *sets* FL_DAMAGE_ALL
     widget.clear_damage(FL_DAMAGE_ALL);
+    Fl_Widget_Profiler::Scope prof(Fl_Widget_Profiler::DRAW, &widget, FL_DAMAGE_ALL);
     widget.draw();
     widget.clear_damage();
   }
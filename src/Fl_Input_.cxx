@@ -16,6 +16,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Input_.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include <FL/Fl_Window.H>
 #include "Fl_Screen_Driver.H"
 #include <FL/fl_draw.H>
@@ -1283,6 +1284,11 @@ int Fl_Input_::handletext(int event, int X, int Y, int W, int H) {
 
 /*------------------------------*/
 
+void Fl_Input_::shortcut(int s) {
+  shortcut_ = s;
+  Fl_Shortcut_Index::shortcut(this, s);
+}
+
 /**
   Creates a new Fl_Input_ widget.
 
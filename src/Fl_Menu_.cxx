@@ -23,6 +23,7 @@
 
 #include <FL/Fl.H>
 #include <FL/Fl_Menu_.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include "flstring.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -523,6 +524,12 @@ void Fl_Menu_::menu(const Fl_Menu_Item* m) {
   clear();
   prev_value_ = NULL;
   value_ = menu_ = (Fl_Menu_Item*)m;
+  Fl_Shortcut_Index::menu_changed(this);
+}
+
+void Fl_Menu_::shortcut(int i, int s) {
+  menu_[i].shortcut(s);
+  Fl_Shortcut_Index::menu_changed(this);
 }
 
 // this version is ok with new Fl_Menu_add code with fl_menu_array_owner:
@@ -596,6 +603,7 @@ void Fl_Menu_::clear() {
   }
   menu_ = 0;
   value_ = prev_value_ = 0;
+  Fl_Shortcut_Index::menu_changed(this);
 }
 
 /**
@@ -25,6 +25,7 @@
 // string with a % sign in it!
 
 #include <FL/Fl_Menu_.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include <FL/fl_string_functions.h>
 #include "flstring.h"
 #include <stdio.h>
@@ -421,6 +422,7 @@ int Fl_Menu_::insert(
   int value_offset = (int) (value_-menu_);
   menu_ = local_array; // in case it reallocated it
   if (value_) value_ = menu_+value_offset;
+  Fl_Shortcut_Index::menu_changed(this);
   return r;
 }
 
@@ -503,6 +505,7 @@ void Fl_Menu_::remove(int i) {
   }
   // MRS: "n" is the menu size(), which includes the trailing NULL entry...
   memmove(item, next_item, (menu_+n-next_item)*sizeof(Fl_Menu_Item));
+  Fl_Shortcut_Index::menu_changed(this);
 }
 
 /**
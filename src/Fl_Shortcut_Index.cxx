@@ -0,0 +1,288 @@
+//
+// Shortcut index for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Shortcut_Index.H>
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+#include <FL/Fl_Menu_.H>
+#include <FL/fl_utf8.h>
+
+#include <stdlib.h>
+
+bool Fl_Shortcut_Index::enabled_ = false;
+int Fl_Shortcut_Index::count_ = 0;
+
+struct Owner;
+
+// One shortcut of a widget
+struct Entry {
+  Owner *owner;
+  unsigned shortcut;
+  Entry *next_key;    // next entry in the same key slot
+  Entry *next;        // next entry of the same owner
+};
+
+// A widget that has entries, or an Fl_Menu_ that may have some
+struct Owner {
+  Fl_Widget *widget;
+  Entry *entries;
+  Owner *next_hash;   // next owner in the same widget slot
+  Owner *next_dirty;  // next menu in dirty_
+  bool dirty;         // menu items changed since they were indexed
+};
+
+// chained hash tables: key -> entries, widget -> owner
+static Entry **keys_ = NULL;
+static int keys_size_ = 0;      // a power of 2
+static int entries_ = 0;
+static Owner **owners_ = NULL;
+static int owners_size_ = 0;    // a power of 2
+
+// menus whose items must be indexed again before the next lookup
+static Owner *dirty_ = NULL;
+
+// nesting limit for FL_SUBMENU_POINTER items, which may form loops
+static const int MAX_SUBMENU_DEPTH = 8;
+
+static unsigned key_slot(unsigned key) {
+  return (key ^ (key >> 8)) & (keys_size_ - 1);
+}
+
+static unsigned widget_slot(const Fl_Widget *w) {
+  fl_uintptr_t v = (fl_uintptr_t)w;
+  v ^= v >> 16;
+  return (unsigned)(v * 0x45d9f3bu) & (owners_size_ - 1);
+}
+
+static void grow_keys() {
+  int old_size = keys_size_;
+  Entry **old = keys_;
+  keys_size_ = old_size ? 2 * old_size : 256;
+  keys_ = (Entry**)calloc(keys_size_, sizeof(Entry*));
+  for (int i = 0; i < old_size; i++) {
+    for (Entry *e = old[i], *next; e; e = next) {
+      next = e->next_key;
+      unsigned h = key_slot(e->shortcut & FL_KEY_MASK);
+      e->next_key = keys_[h];
+      keys_[h] = e;
+    }
+  }
+  free(old);
+}
+
+static void grow_owners() {
+  int old_size = owners_size_;
+  Owner **old = owners_;
+  owners_size_ = old_size ? 2 * old_size : 64;
+  owners_ = (Owner**)calloc(owners_size_, sizeof(Owner*));
+  for (int i = 0; i < old_size; i++) {
+    for (Owner *o = old[i], *next; o; o = next) {
+      next = o->next_hash;
+      unsigned h = widget_slot(o->widget);
+      o->next_hash = owners_[h];
+      owners_[h] = o;
+    }
+  }
+  free(old);
+}
+
+static Owner *find_owner(const Fl_Widget *w) {
+  if (!owners_size_) return NULL;
+  Owner *o = owners_[widget_slot(w)];
+  while (o && o->widget != w) o = o->next_hash;
+  return o;
+}
+
+// Adds an owner for w, count is the number of owners before
+static Owner *new_owner(Fl_Widget *w, int count) {
+  if (count >= owners_size_) grow_owners();
+  Owner *o = new Owner;
+  o->widget = w;
+  o->entries = NULL;
+  o->next_dirty = NULL;
+  o->dirty = false;
+  unsigned h = widget_slot(w);
+  o->next_hash = owners_[h];
+  owners_[h] = o;
+  return o;
+}
+
+static void add_entry(Owner *o, unsigned shortcut) {
+  if (!(shortcut & FL_KEY_MASK)) return;
+  if (entries_ >= keys_size_) grow_keys();
+  Entry *e = new Entry;
+  e->owner = o;
+  e->shortcut = shortcut;
+  unsigned h = key_slot(shortcut & FL_KEY_MASK);
+  e->next_key = keys_[h];
+  keys_[h] = e;
+  e->next = o->entries;
+  o->entries = e;
+  entries_++;
+}
+
+static void clear_entries(Owner *o) {
+  for (Entry *e = o->entries, *next; e; e = next) {
+    next = e->next;
+    Entry **p = keys_ + key_slot(e->shortcut & FL_KEY_MASK);
+    while (*p != e) p = &(*p)->next_key;
+    *p = e->next_key;
+    delete e;
+    entries_--;
+  }
+  o->entries = NULL;
+}
+
+static void add_items(Owner *o, const Fl_Menu_Item *m, int depth) {
+  if (!m) return;
+  int n = m->size();
+  for (int i = 0; i < n; i++) {
+    if (!m[i].text) continue;
+    add_entry(o, m[i].shortcut());
+    if ((m[i].flags & FL_SUBMENU_POINTER) && depth < MAX_SUBMENU_DEPTH)
+      add_items(o, (const Fl_Menu_Item*)m[i].user_data(), depth + 1);
+  }
+}
+
+static void index_dirty_menus() {
+  while (dirty_) {
+    Owner *o = dirty_;
+    dirty_ = o->next_dirty;
+    o->next_dirty = NULL;
+    o->dirty = false;
+    clear_entries(o);
+    add_items(o, ((Fl_Menu_*)o->widget)->menu(), 0);
+  }
+}
+
+
+/**
+  Makes Fl::handle() send shortcuts to the indexed widgets first, or stops
+  it. Widgets are indexed whether the index is enabled or not, so that it
+  can be enabled at any time.
+*/
+void Fl_Shortcut_Index::enable(bool on) {
+  enabled_ = on;
+}
+
+
+/**
+  Sets the indexed shortcut of widget \p w.
+  Use this in widgets that handle FL_SHORTCUT with their own shortcut
+  value, like Fl_Button does. A shortcut of 0 removes the widget.
+  \see Fl_Button::shortcut(int) for the format of \p shortcut
+*/
+void Fl_Shortcut_Index::shortcut(Fl_Widget *w, int shortcut) {
+  Owner *o = find_owner(w);
+  if (!o) {
+    if (!shortcut) return;
+    o = new_owner(w, count_++);
+  } else if (!shortcut) {
+    remove(w);
+    return;
+  }
+  clear_entries(o);
+  add_entry(o, (unsigned)shortcut);
+}
+
+
+/**
+  Tells the index that the items of menu \p m changed.
+  The Fl_Menu_ methods that change the menu call this. The items are
+  indexed again before the next shortcut is looked up.
+*/
+void Fl_Shortcut_Index::menu_changed(Fl_Menu_ *m) {
+  Owner *o = find_owner(m);
+  if (!o) o = new_owner(m, count_++);
+  if (!o->dirty) {
+    o->dirty = true;
+    o->next_dirty = dirty_;
+    dirty_ = o;
+  }
+}
+
+
+/** Removes all shortcuts of widget \p w from the index. */
+void Fl_Shortcut_Index::remove(Fl_Widget *w) {
+  if (!owners_size_) return;
+  Owner **p = owners_ + widget_slot(w);
+  while (*p && (*p)->widget != w) p = &(*p)->next_hash;
+  Owner *o = *p;
+  if (!o) return;
+  *p = o->next_hash;
+  if (o->dirty) {
+    Owner **d = &dirty_;
+    while (*d != o) d = &(*d)->next_dirty;
+    *d = o->next_dirty;
+  }
+  clear_entries(o);
+  delete o;
+  count_--;
+}
+
+
+/** Returns true if widget \p w is in the index. */
+bool Fl_Shortcut_Index::indexed(const Fl_Widget *w) {
+  return find_owner(w) != NULL;
+}
+
+
+/** Returns the number of indexed shortcuts. */
+int Fl_Shortcut_Index::entries() {
+  index_dirty_menus();
+  return entries_;
+}
+
+
+/**
+  Finds the indexed widgets that have a shortcut matching the current
+  event, which must be an FL_KEYBOARD or FL_SHORTCUT event.
+  Each widget is listed once, in no particular order.
+  \param[out] list  receives the widgets
+  \param[in] size   the size of \p list
+  \return the number of widgets in \p list
+*/
+int Fl_Shortcut_Index::find(Fl_Widget **list, int size) {
+  index_dirty_menus();
+  if (!entries_) return 0;
+  // Fl::test_shortcut() compares the key of a shortcut with the event
+  // key, the first character of the event text, and that character
+  // with bit 0x40 flipped when Ctrl is held
+  unsigned keys[3];
+  int nkeys = 0;
+  keys[nkeys++] = (unsigned)Fl::event_key();
+  if (Fl::event_length() > 0) {
+    const char *t = Fl::event_text();
+    unsigned c = fl_utf8decode(t, t + Fl::event_length(), 0);
+    if (c != keys[0]) keys[nkeys++] = c;
+    unsigned k = c ^ 0x40;
+    if ((Fl::event_state() & FL_CTRL) && k >= 0x3f && k <= 0x5f) keys[nkeys++] = k;
+  }
+  int n = 0;
+  for (int i = 0; i < nkeys; i++) {
+    for (Entry *e = keys_[key_slot(keys[i] & FL_KEY_MASK)]; e; e = e->next_key) {
+      if ((e->shortcut & FL_KEY_MASK) != keys[i] || !Fl::test_shortcut(e->shortcut))
+        continue;
+      Fl_Widget *w = e->owner->widget;
+      int j = 0;
+      while (j < n && list[j] != w) j++;
+      if (j < n) continue;
+      if (n >= size) return n;
+      list[n++] = w;
+    }
+  }
+  return n;
+}
@@ -0,0 +1,355 @@
+//
+// Spatial index of group children for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Spatial_Index.H"
+#include <FL/Fl_Widget.H>
+
+#include <stdlib.h>
+#include <string.h>
+
+// Children that overlap more cells than this are not entered in the grid
+static const int MAX_CELLS = 16;
+
+// Maximum number of children returned by at()
+static const int MAX_AT = 64;
+
+static unsigned widget_hash(const Fl_Widget *w) {
+  fl_uintptr_t v = (fl_uintptr_t)w;
+  v ^= v >> 16;
+  return (unsigned)(v * 0x45d9f3bu);
+}
+
+static unsigned cell_hash(int cx, int cy) {
+  return ((unsigned)cx * 73856093u) ^ ((unsigned)cy * 19349663u);
+}
+
+// Division that rounds towards minus infinity
+static int floor_div(int v, int d) {
+  return v >= 0 ? v / d : -((-v - 1) / d) - 1;
+}
+
+static int compare_int(const void *a, const void *b) {
+  return *(const int*)a - *(const int*)b;
+}
+
+
+Fl_Spatial_Index::Fl_Spatial_Index(int cell_size) {
+  cell_ = cell_size > 0 ? cell_size : 1;
+  valid_ = false;
+  records_ = NULL;
+  count_ = alloc_ = 0;
+  slots_ = NULL;
+  slots_size_ = 0;
+  cells_ = NULL;
+  cells_size_ = cells_used_ = 0;
+  big_ = NULL;
+  big_count_ = big_alloc_ = 0;
+  result_ = NULL;
+  result_alloc_ = 0;
+  stamp_ = 0;
+  ex1_ = ey1_ = ex2_ = ey2_ = 0;
+}
+
+Fl_Spatial_Index::~Fl_Spatial_Index() {
+  clear();
+  free(records_);
+  free(slots_);
+  free(cells_);
+  free(big_);
+  free(result_);
+}
+
+// Forgets all records, keeps the allocated tables
+void Fl_Spatial_Index::clear() {
+  for (int i = 0; i < cells_size_; i++) free(cells_[i].items);
+  if (cells_) memset(cells_, 0, cells_size_ * sizeof(Cell));
+  cells_used_ = 0;
+  for (int i = 0; i < slots_size_; i++) slots_[i] = -1;
+  count_ = 0;
+  big_count_ = 0;
+  ex1_ = ey1_ = ex2_ = ey2_ = 0;
+}
+
+// Returns the slot of widget w, which holds -1 if w has no record
+int Fl_Spatial_Index::slot(const Fl_Widget *w) const {
+  unsigned mask = slots_size_ - 1;
+  unsigned h = widget_hash(w) & mask;
+  while (slots_[h] >= 0 && records_[slots_[h]].widget != w) h = (h + 1) & mask;
+  return (int)h;
+}
+
+void Fl_Spatial_Index::grow_slots() {
+  slots_size_ = slots_size_ ? 2 * slots_size_ : 256;
+  slots_ = (int*)realloc(slots_, slots_size_ * sizeof(int));
+  for (int i = 0; i < slots_size_; i++) slots_[i] = -1;
+  for (int i = 0; i < count_; i++) slots_[slot(records_[i].widget)] = i;
+}
+
+// Returns the cell (cx, cy), NULL if it doesn't exist and create is false
+Fl_Spatial_Index::Cell *Fl_Spatial_Index::cell(int cx, int cy, bool create) {
+  if (!cells_size_) {
+    if (!create) return NULL;
+    grow_cells();
+  }
+  unsigned mask = cells_size_ - 1;
+  unsigned h = cell_hash(cx, cy) & mask;
+  while (cells_[h].items) {
+    if (cells_[h].cx == cx && cells_[h].cy == cy) return cells_ + h;
+    h = (h + 1) & mask;
+  }
+  if (!create) return NULL;
+  if (2 * (cells_used_ + 1) > cells_size_) {
+    grow_cells();
+    return cell(cx, cy, true);
+  }
+  Cell *c = cells_ + h;
+  c->cx = cx;
+  c->cy = cy;
+  c->alloc = 4;
+  c->count = 0;
+  c->items = (int*)malloc(c->alloc * sizeof(int));
+  cells_used_++;
+  return c;
+}
+
+void Fl_Spatial_Index::grow_cells() {
+  int old_size = cells_size_;
+  Cell *old = cells_;
+  cells_size_ = old_size ? 2 * old_size : 256;
+  cells_ = (Cell*)calloc(cells_size_, sizeof(Cell));
+  unsigned mask = cells_size_ - 1;
+  for (int i = 0; i < old_size; i++) {
+    if (!old[i].items) continue;
+    unsigned h = cell_hash(old[i].cx, old[i].cy) & mask;
+    while (cells_[h].items) h = (h + 1) & mask;
+    cells_[h] = old[i];
+  }
+  free(old);
+}
+
+// Computes the cells overlapped by r, returns false if there are too many
+bool Fl_Spatial_Index::cell_range(const Record &r, int &cx1, int &cy1, int &cx2, int &cy2) const {
+  cx1 = floor_div(r.x, cell_);
+  cy1 = floor_div(r.y, cell_);
+  cx2 = r.w > 0 ? floor_div(r.x + r.w - 1, cell_) : cx1;
+  cy2 = r.h > 0 ? floor_div(r.y + r.h - 1, cell_) : cy1;
+  return (double)(cx2 - cx1 + 1) * (cy2 - cy1 + 1) <= MAX_CELLS;
+}
+
+void Fl_Spatial_Index::push(int *&list, int &count, int &alloc, int i) {
+  if (count >= alloc) {
+    alloc = alloc ? 2 * alloc : 16;
+    list = (int*)realloc(list, alloc * sizeof(int));
+  }
+  list[count++] = i;
+}
+
+void Fl_Spatial_Index::pull(int *list, int &count, int i) {
+  for (int k = 0; k < count; k++) {
+    if (list[k] == i) {
+      list[k] = list[--count];
+      return;
+    }
+  }
+}
+
+// Enters record i in its cells
+void Fl_Spatial_Index::link(int i) {
+  Record &r = records_[i];
+  if (r.w > 0 && r.h > 0) {
+    if (ex1_ >= ex2_ || ey1_ >= ey2_) {
+      ex1_ = r.x; ey1_ = r.y; ex2_ = r.x + r.w; ey2_ = r.y + r.h;
+    } else {
+      if (r.x < ex1_) ex1_ = r.x;
+      if (r.y < ey1_) ey1_ = r.y;
+      if (r.x + r.w > ex2_) ex2_ = r.x + r.w;
+      if (r.y + r.h > ey2_) ey2_ = r.y + r.h;
+    }
+  }
+  int cx1, cy1, cx2, cy2;
+  if (!cell_range(r, cx1, cy1, cx2, cy2)) {
+    push(big_, big_count_, big_alloc_, i);
+    return;
+  }
+  for (int cy = cy1; cy <= cy2; cy++) {
+    for (int cx = cx1; cx <= cx2; cx++) {
+      Cell *c = cell(cx, cy, true);
+      push(c->items, c->count, c->alloc, i);
+    }
+  }
+}
+
+// Removes record i from its cells
+void Fl_Spatial_Index::unlink(int i) {
+  int cx1, cy1, cx2, cy2;
+  if (!cell_range(records_[i], cx1, cy1, cx2, cy2)) {
+    pull(big_, big_count_, i);
+    return;
+  }
+  for (int cy = cy1; cy <= cy2; cy++) {
+    for (int cx = cx1; cx <= cx2; cx++) {
+      Cell *c = cell(cx, cy, false);
+      if (c) pull(c->items, c->count, i);
+    }
+  }
+}
+
+
+// Indexes the n children in a, and makes the index valid
+void Fl_Spatial_Index::rebuild(Fl_Widget * const *a, int n) {
+  clear();
+  valid_ = true;
+  for (int i = 0; i < n; i++) append(a[i]);
+}
+
+// Adds a record for a child appended to the group
+void Fl_Spatial_Index::append(Fl_Widget *w) {
+  if (!valid_) return;
+  if (count_ >= alloc_) {
+    alloc_ = alloc_ ? 2 * alloc_ : 64;
+    records_ = (Record*)realloc(records_, alloc_ * sizeof(Record));
+  }
+  if (2 * (count_ + 1) > slots_size_) grow_slots();
+  int i = count_++;
+  Record &r = records_[i];
+  r.widget = w;
+  r.x = w->x(); r.y = w->y(); r.w = w->w(); r.h = w->h();
+  r.stamp = 0;
+  slots_[slot(w)] = i;
+  link(i);
+}
+
+// Removes the record of the last child of the group
+void Fl_Spatial_Index::remove_last() {
+  if (!valid_ || !count_) return;
+  int i = count_ - 1;
+  unlink(i);
+  // remove the slot, moving later slots of the same probe sequence back
+  unsigned mask = slots_size_ - 1;
+  unsigned s = (unsigned)slot(records_[i].widget);
+  for (;;) {
+    slots_[s] = -1;
+    unsigned j = s;
+    for (;;) {
+      j = (j + 1) & mask;
+      if (slots_[j] < 0) {
+        count_--;
+        return;
+      }
+      unsigned h = widget_hash(records_[slots_[j]].widget) & mask;
+      // stay if h is cyclically in (s, j]
+      if (s <= j ? (s < h && h <= j) : (s < h || h <= j)) continue;
+      slots_[s] = slots_[j];
+      s = j;
+      break;
+    }
+  }
+}
+
+// Updates the record of a child that was moved or resized
+void Fl_Spatial_Index::moved(Fl_Widget *w) {
+  if (!valid_) return;
+  int i = slots_size_ ? slots_[slot(w)] : -1;
+  if (i < 0) { // should not happen
+    valid_ = false;
+    return;
+  }
+  Record &r = records_[i];
+  if (r.x == w->x() && r.y == w->y() && r.w == w->w() && r.h == w->h()) return;
+  unlink(i);
+  r.x = w->x(); r.y = w->y(); r.w = w->w(); r.h = w->h();
+  link(i);
+}
+
+// Returns the index of child w, or -1 if it is not indexed
+int Fl_Spatial_Index::find(const Fl_Widget *w) const {
+  if (!valid_ || !slots_size_) return -1;
+  return slots_[slot(w)];
+}
+
+/*
+  Finds the children that contain the point (X, Y).
+  Puts them in list in child order and returns their number, or returns -1
+  if there are more than size.
+*/
+int Fl_Spatial_Index::at(int X, int Y, Fl_Widget **list, int size) {
+  int found[MAX_AT];
+  if (size > MAX_AT) size = MAX_AT;
+  int n = 0;
+  Cell *c = cell(floor_div(X, cell_), floor_div(Y, cell_), false);
+  for (int pass = 0; pass < 2; pass++) {
+    const int *items = pass ? big_ : (c ? c->items : NULL);
+    int count = pass ? big_count_ : (c ? c->count : 0);
+    for (int k = 0; k < count; k++) {
+      const Record &r = records_[items[k]];
+      if (X < r.x || X >= r.x + r.w || Y < r.y || Y >= r.y + r.h) continue;
+      if (n >= size) return -1;
+      // insertion sort, there are only a few
+      int j = n++;
+      while (j > 0 && found[j-1] > items[k]) { found[j] = found[j-1]; j--; }
+      found[j] = items[k];
+    }
+  }
+  for (int k = 0; k < n; k++) list[k] = records_[found[k]].widget;
+  return n;
+}
+
+// Adds the records in items that overlap X, Y, W, H to result_, once
+void Fl_Spatial_Index::gather(const int *items, int count, int X, int Y, int W, int H, int &n) {
+  for (int k = 0; k < count; k++) {
+    Record &r = records_[items[k]];
+    if (r.stamp == stamp_) continue;
+    if (r.w <= 0 || r.h <= 0 || r.x >= X + W || r.x + r.w <= X ||
+        r.y >= Y + H || r.y + r.h <= Y) continue;
+    r.stamp = stamp_;
+    push(result_, n, result_alloc_, items[k]);
+  }
+}
+
+/*
+  Finds the children that overlap the area X, Y, W, H.
+  Sets list to their indexes in increasing order and returns their number,
+  or returns -1 if the area covers more cells than the grid uses, so that
+  testing all children is faster. The list is valid until the next call.
+*/
+int Fl_Spatial_Index::in(int X, int Y, int W, int H, const int *&list) {
+  list = result_;
+  if (W <= 0 || H <= 0) return 0;
+  int cx1 = floor_div(X, cell_), cy1 = floor_div(Y, cell_);
+  int cx2 = floor_div(X + W - 1, cell_), cy2 = floor_div(Y + H - 1, cell_);
+  if ((double)(cx2 - cx1 + 1) * (cy2 - cy1 + 1) > cells_used_) return -1;
+  if (++stamp_ == 0) { // wrapped around
+    for (int i = 0; i < count_; i++) records_[i].stamp = 0;
+    stamp_ = 1;
+  }
+  int n = 0;
+  for (int cy = cy1; cy <= cy2; cy++) {
+    for (int cx = cx1; cx <= cx2; cx++) {
+      Cell *c = cell(cx, cy, false);
+      if (c) gather(c->items, c->count, X, Y, W, H, n);
+    }
+  }
+  gather(big_, big_count_, X, Y, W, H, n);
+  qsort(result_, n, sizeof(int), compare_int);
+  list = result_;
+  return n;
+}
+
+// Gets a box that contains all children, returns false if there are none
+bool Fl_Spatial_Index::extent(int &X, int &Y, int &W, int &H) const {
+  X = ex1_; Y = ey1_; W = ex2_ - ex1_; H = ey2_ - ey1_;
+  return W > 0 && H > 0;
+}
@@ -26,6 +26,8 @@
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
 #include <stdlib.h>
+#include <string.h>             // memmove()
+#include <limits.h>             // INT_MAX
 
 // for debugging...
 // #define DEBUG 1
@@ -38,36 +40,136 @@
 #define PRINTEVENT
 #endif
 
-// An STL-ish vector without templates (private to Fl_Table_Row)
-
-void Fl_Table_Row::CharVector::copy(char *newarr, int newsize) {
-  size(newsize);
-  memcpy(arr, newarr, newsize * sizeof(char));
-}
+// Selected row ranges (private to Fl_Table_Row)
+//
+//    Ranges are kept sorted, and neither overlap nor touch,
+//    so that each selected row is in exactly one range and
+//    adjacent ranges are always separated by unselected rows.
+//
 
-Fl_Table_Row::CharVector::~CharVector() {       // DTOR
+Fl_Table_Row::RowRanges::~RowRanges() {         // DTOR
   if (arr) free(arr);
   arr = 0;
 }
 
-void Fl_Table_Row::CharVector::size(int count) {
-  if (count <= 0 ) {    // Same state as init() - (issue #296)
-    if ( arr ) free(arr);
-    arr   = 0;
-    _size = 0;
-    return;
+// Return the index of the first range whose start (side=0) or end (side=1) is > row
+int Fl_Table_Row::RowRanges::lower(int row, int side) const {
+  int lo = 0, hi = _count;
+  while ( lo < hi ) {
+    int mid = (lo + hi) / 2;
+    if ( arr[2*mid+side] > row ) hi = mid;
+    else                         lo = mid + 1;
+  }
+  return(lo);
+}
+
+// Replace ranges lo..hi-1 with the 'n' ranges in 'pairs'
+void Fl_Table_Row::RowRanges::splice(int lo, int hi, const int *pairs, int n) {
+  int newcount = _count - (hi - lo) + n;
+  if ( newcount > _alloc ) {
+    _alloc = newcount < 8 ? 8 : newcount * 2;
+    arr = (int*)realloc(arr, (unsigned)_alloc * 2 * sizeof(int));
+  }
+  memmove(arr + 2*(lo+n), arr + 2*hi, (unsigned)(_count - hi) * 2 * sizeof(int));
+  memcpy(arr + 2*lo, pairs, (unsigned)n * 2 * sizeof(int));
+  _count = newcount;
+}
+
+// Is 'row' selected?
+int Fl_Table_Row::RowRanges::contains(int row) const {
+  int i = lower(row, 1);                // first range ending after row
+  return(i < _count && start(i) <= row ? 1 : 0);
+}
+
+// Count the selected rows in from..to-1
+int Fl_Table_Row::RowRanges::selected(int from, int to) const {
+  int n = 0;
+  for ( int i = lower(from, 1); i < _count && start(i) < to; i++ ) {
+    int s = start(i) > from ? start(i) : from;
+    int e = end(i) < to ? end(i) : to;
+    n += e - s;
+  }
+  return(n);
+}
+
+// Return the first selected row after 'row', or -1
+int Fl_Table_Row::RowRanges::next(int row) const {
+  int i = lower(row + 1, 1);            // first range ending after row+1
+  if ( i >= _count ) return(-1);
+  return(start(i) > row ? start(i) : row + 1);
+}
+
+// Select (val=1) or deselect (val=0) rows from..to-1
+void Fl_Table_Row::RowRanges::set(int from, int to, int val) {
+  if ( from >= to ) return;
+  int pairs[4], n = 0;
+  if ( val ) {
+    int lo = lower(from - 1, 1);        // first range touching 'from' or after
+    int hi = lower(to, 0);              // first range after 'to', not touching
+    pairs[0] = (lo < hi && start(lo) < from) ? start(lo) : from;
+    pairs[1] = (lo < hi && end(hi-1) > to) ? end(hi-1) : to;
+    splice(lo, hi, pairs, 1);
+  } else {
+    int lo = lower(from, 1);            // first range overlapping 'from' or after
+    int hi = lower(to - 1, 0);          // first range starting at 'to' or after
+    if ( lo >= hi ) return;             // nothing selected in from..to-1
+    if ( start(lo) < from ) { pairs[2*n] = start(lo); pairs[2*n+1] = from; n++; }
+    if ( end(hi-1) > to )   { pairs[2*n] = to; pairs[2*n+1] = end(hi-1); n++; }
+    splice(lo, hi, pairs, n);
+  }
+}
+
+// Invert the selection of rows from..to-1
+void Fl_Table_Row::RowRanges::toggle(int from, int to) {
+  if ( from >= to ) return;
+  int lo = lower(from - 1, 1);          // ranges touching from..to-1 are replaced
+  int hi = lower(to, 0);
+  int max = 2 * (hi - lo) + 3;
+  int *pairs = (int*)malloc((unsigned)max * 2 * sizeof(int));
+  int n = 0;
+  int row = from;                       // start of the next unselected gap
+  for ( int i = lo; i < hi; i++ ) {
+    int s = start(i), e = end(i);
+    if ( s < from ) {                   // keep part before 'from'
+      pairs[2*n] = s; pairs[2*n+1] = from; n++;
+    }
+    if ( s > row ) {                    // gap becomes selected
+      pairs[2*n] = row; pairs[2*n+1] = s; n++;
+    }
+    if ( e > to ) {                     // keep part after 'to'
+      pairs[2*n] = to; pairs[2*n+1] = e; n++;
+    }
+    if ( e > row ) row = e;
   }
-  if (count != _size) {
-    arr = (char*)realloc(arr, (unsigned)count * sizeof(char));
-    _size = count;
+  if ( row < to ) {                     // trailing gap becomes selected
+    pairs[2*n] = row; pairs[2*n+1] = to; n++;
   }
+  // Merge pieces that touch (e.g. range ending at 'from' + gap starting there)
+  int m = 0;
+  for ( int i = 0; i < n; i++ ) {
+    if ( pairs[2*i] >= pairs[2*i+1] ) continue;
+    if ( m > 0 && pairs[2*(m-1)+1] == pairs[2*i] ) {
+      pairs[2*(m-1)+1] = pairs[2*i+1];
+    } else {
+      pairs[2*m] = pairs[2*i]; pairs[2*m+1] = pairs[2*i+1]; m++;
+    }
+  }
+  splice(lo, hi, pairs, m);
+  free(pairs);
 }
 
 
+// Redraw the visible part of rows R1..R2
+void Fl_Table_Row::redraw_rows(int R1, int R2) {
+  if ( R1 < toprow ) R1 = toprow;
+  if ( R2 > botrow ) R2 = botrow;
+  if ( R1 <= R2 ) redraw_range(R1, R2, leftcol, rightcol);
+}
+
 // Is row selected?
 int Fl_Table_Row::row_selected(int row) {
   if ( row < 0 || row >= rows() ) return(-1);
-  return(_rowselect[row]);
+  return(_rowselect.contains(row));
 }
 
 // Change row selection type
@@ -75,21 +177,14 @@ void Fl_Table_Row::type(TableRowSelectMode val) {
   _selectmode = val;
   switch ( _selectmode ) {
     case SELECT_NONE: {
-      for ( int row=0; row<rows(); row++ ) {
-        _rowselect[row] = 0;
-      }
+      _rowselect.clear();
       redraw();
       break;
     }
     case SELECT_SINGLE: {
-      int count = 0;
-      for ( int row=0; row<rows(); row++ ) {
-        if ( _rowselect[row] ) {
-          if ( ++count > 1 ) {  // only one allowed
-            _rowselect[row] = 0;
-          }
-        }
-      }
+      int row = _rowselect.next(-1);    // only one allowed: keep the first
+      _rowselect.clear();
+      if ( row >= 0 ) _rowselect.set(row, row+1, 1);
       redraw();
       break;
     }
@@ -118,34 +213,26 @@ int Fl_Table_Row::select_row(int row, int flag) {
       return(-1);
 
     case SELECT_SINGLE: {
-      int oldval;
-      for ( int t=0; t<rows(); t++ ) {
-        if ( t == row ) {
-          oldval = _rowselect[row];
-          if ( flag == 2 ) { _rowselect[row] ^= 1; }
-          else             { _rowselect[row] = flag; }
-          if ( oldval != _rowselect[row] ) {
-            redraw_range(row, row, leftcol, rightcol);
-            ret = 1;
-          }
-        }
-        else if ( _rowselect[t] ) {
-          _rowselect[t] = 0;
-          redraw_range(t, t, leftcol, rightcol);
-        }
+      int oldval = _rowselect.contains(row);
+      int newval = ( flag == 2 ) ? !oldval : ( flag ? 1 : 0 );
+      for ( int t = _rowselect.next(-1); t >= 0; t = _rowselect.next(t) ) {
+        if ( t != row ) redraw_rows(t, t);      // deselect any other row
+      }
+      _rowselect.clear();
+      if ( newval ) _rowselect.set(row, row+1, 1);
+      if ( oldval != newval ) {
+        redraw_rows(row, row);
+        ret = 1;
       }
       break;
     }
 
     case SELECT_MULTI: {
-      int oldval = _rowselect[row];
-      if ( flag == 2 ) { _rowselect[row] ^= 1; }
-      else             { _rowselect[row] = flag; }
-      if ( _rowselect[row] != oldval ) {                // select state changed?
-        if ( row >= toprow && row <= botrow ) {         // row visible?
-          // Extend partial redraw range
-          redraw_range(row, row, leftcol, rightcol);
-        }
+      int oldval = _rowselect.contains(row);
+      int newval = ( flag == 2 ) ? !oldval : ( flag ? 1 : 0 );
+      if ( newval != oldval ) {                         // select state changed?
+        _rowselect.set(row, row+1, newval);
+        redraw_rows(row, row);                          // extend partial redraw range if visible
         ret = 1;
       }
     }
@@ -153,6 +240,46 @@ int Fl_Table_Row::select_row(int row, int flag) {
   return(ret);
 }
 
+// Change selection state for rows R1..R2
+//
+//     flag: 0 - clear, 1 - set, 2 - toggle selection
+//
+//     Returns:
+//        0 - selection state did not change
+//        1 - selection state changed
+//       -1 - rows out of range or incorrect selection mode
+//
+int Fl_Table_Row::select_rows(int R1, int R2, int flag) {
+  if ( R1 > R2 ) { int t = R1; R1 = R2; R2 = t; }
+  if ( R1 < 0 || R2 >= rows() ) { return(-1); }
+  switch ( _selectmode ) {
+    case SELECT_NONE:
+      return(-1);
+
+    case SELECT_SINGLE:
+      if ( R1 != R2 ) return(-1);
+      return(select_row(R1, flag));
+
+    case SELECT_MULTI:
+      break;
+  }
+  int nsel = _rowselect.selected(R1, R2+1);
+  if ( flag == 2 ) {
+    _rowselect.toggle(R1, R2+1);
+  } else {
+    if ( nsel == (flag ? R2-R1+1 : 0) ) return(0);      // already in that state
+    _rowselect.set(R1, R2+1, flag ? 1 : 0);
+  }
+  redraw_rows(R1, R2);
+  return(1);
+}
+
+// Return the first selected row after 'row', or -1 if none
+int Fl_Table_Row::next_selected_row(int row) {
+  int next = _rowselect.next(row < -1 ? -1 : row);
+  return(next < rows() ? next : -1);
+}
+
 // Select all rows to a known state
 void Fl_Table_Row::select_all_rows(int flag) {
   switch ( _selectmode ) {
@@ -166,18 +293,17 @@ void Fl_Table_Row::select_all_rows(int flag) {
     case SELECT_MULTI: {
       char changed = 0;
       if ( flag == 2 ) {
-        for ( int row=0; row<(int)_rowselect.size(); row++ ) {
-          _rowselect[row] ^= 1;
-        }
-        changed = 1;
+        _rowselect.toggle(0, rows());
+        changed = rows() > 0 ? 1 : 0;
+      } else if ( flag ) {
+        changed = ( _rowselect.selected(0, rows()) != rows() ) ? 1 : 0;
+        _rowselect.set(0, rows(), 1);
       } else {
-        for ( int row=0; row<(int)_rowselect.size(); row++ ) {
-          changed |= (_rowselect[row] != flag)?1:0;
-          _rowselect[row] = flag;
-        }
+        changed = _rowselect.count() ? 1 : 0;
+        _rowselect.clear();
       }
       if ( changed ) {
-        redraw();
+        redraw_rows(0, rows()-1);       // only the visible rows can change
       }
     }
   }
@@ -186,8 +312,7 @@ void Fl_Table_Row::select_all_rows(int flag) {
 // Set number of rows
 void Fl_Table_Row::rows(int val) {
   Fl_Table::rows(val);
-  while ( val > (int)_rowselect.size() ) { _rowselect.push_back(0); }   // enlarge
-  while ( val < (int)_rowselect.size() ) { _rowselect.pop_back(); }     // shrink
+  _rowselect.set(val < 0 ? 0 : val, INT_MAX, 0);        // forget rows that were removed
 }
 
 // Handle events
@@ -239,14 +364,7 @@ int Fl_Table_Row::handle(int event) {
             case FL_SHIFT: {
               select_row(R, 1);
               if ( _last_row > -1 ) {
-                int srow = R, erow = _last_row;
-                if ( srow > erow ) {
-                  srow = _last_row;
-                  erow = R;
-                }
-                for ( int row = srow; row <= erow; row++ ) {
-                  select_row(row, 1);
-                }
+                select_rows(R, _last_row, 1);
               }
               break;
             }
@@ -305,14 +423,7 @@ int Fl_Table_Row::handle(int event) {
             default:
               select_row(R, 1);
               if ( _last_row > -1 ) {
-                int srow = R, erow = _last_row;
-                if ( srow > erow ) {
-                  srow = _last_row;
-                  erow = R;
-                }
-                for ( int row = srow; row <= erow; row++ ) {
-                  select_row(row, 1);
-                }
+                select_rows(R, _last_row, 1);
               }
               break;
           }
@@ -0,0 +1,217 @@
+//
+// Task scheduler for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Task_Scheduler.H>
+#include <FL/Fl.H>
+
+double Fl_Task_Scheduler::budget_ = 0.005;
+
+// Pending tasks, in the order they are called: by decreasing priority,
+// then in turn. A task that has been called moves behind the other
+// tasks of the same priority.
+struct Task {
+  int id;
+  Fl_Task_Handler cb;
+  void *data;
+  int priority;
+  Task *next;
+};
+
+static Task *first_ = NULL;
+static Task *running_ = NULL;      // task being called, not in the list
+static bool running_removed_ = false;
+static int count_ = 0;
+static int next_id_ = 1;
+
+static void insert(Task *t) {
+  Task **p = &first_;
+  while (*p && (*p)->priority >= t->priority) p = &(*p)->next;
+  t->next = *p;
+  *p = t;
+}
+
+static Task *unlink(Task *t) {
+  for (Task **p = &first_; *p; p = &(*p)->next) {
+    if (*p == t) {
+      *p = t->next;
+      t->next = NULL;
+      return t;
+    }
+  }
+  return NULL;
+}
+
+static Task *find(int id) {
+  if (running_ && running_->id == id) return running_removed_ ? NULL : running_;
+  for (Task *t = first_; t; t = t->next) if (t->id == id) return t;
+  return NULL;
+}
+
+// Calls the first task once, returns false if there was none
+static bool run_one() {
+  Task *t = first_;
+  if (!t) return false;
+  first_ = t->next;
+  running_ = t;
+  running_removed_ = false;
+  int more = t->cb(t->data);
+  running_ = NULL;
+  if (more && !running_removed_) {
+    insert(t);
+  } else {
+    delete t;
+    count_--;
+  }
+  return true;
+}
+
+
+/**
+  Adds a task.
+  The task function is called repeatedly while the program is idle, until
+  it returns 0 or it is removed.
+  \param[in] cb        the task function
+  \param[in] data      user data passed to \p cb
+  \param[in] priority  tasks with a higher priority are called first
+  \return an identifier of the task, for remove(int) and priority(int, int)
+*/
+int Fl_Task_Scheduler::add(Fl_Task_Handler cb, void *data, int priority) {
+  Task *t = new Task;
+  t->id = next_id_++;
+  if (next_id_ <= 0) next_id_ = 1;
+  t->cb = cb;
+  t->data = data;
+  t->priority = priority;
+  t->next = NULL;
+  insert(t);
+  count_++;
+  if (!Fl::has_idle(idle_cb_)) Fl::add_idle(idle_cb_);
+  return t->id;
+}
+
+
+/**
+  Removes a task, which won't be called again.
+  A task may remove itself, or other tasks, while it runs.
+  \return 1 if the task was found, 0 otherwise
+*/
+int Fl_Task_Scheduler::remove(int id) {
+  if (running_ && running_->id == id) {
+    if (running_removed_) return 0;
+    running_removed_ = true;
+    return 1;
+  }
+  Task *t = first_;
+  while (t && t->id != id) t = t->next;
+  if (!t) return 0;
+  delete unlink(t);
+  count_--;
+  return 1;
+}
+
+
+/**
+  Removes all tasks that use the function \p cb and the user data \p data.
+  \return the number of tasks removed
+*/
+int Fl_Task_Scheduler::remove(Fl_Task_Handler cb, void *data) {
+  int n = 0;
+  if (running_ && !running_removed_ && running_->cb == cb && running_->data == data) {
+    running_removed_ = true;
+    n++;
+  }
+  for (Task **p = &first_; *p; ) {
+    Task *t = *p;
+    if (t->cb == cb && t->data == data) {
+      *p = t->next;
+      delete t;
+      count_--;
+      n++;
+    } else {
+      p = &t->next;
+    }
+  }
+  return n;
+}
+
+
+/** Returns 1 if task \p id is pending, 0 if it finished or was removed. */
+int Fl_Task_Scheduler::has(int id) {
+  return find(id) != NULL;
+}
+
+
+/**
+  Changes the priority of a pending task.
+  \return 1 if the task was found, 0 otherwise
+*/
+int Fl_Task_Scheduler::priority(int id, int priority) {
+  Task *t = find(id);
+  if (!t) return 0;
+  t->priority = priority;
+  if (t != running_) insert(unlink(t));
+  return 1;
+}
+
+
+/** Returns the number of pending tasks. */
+int Fl_Task_Scheduler::tasks() {
+  return count_ - (running_ && running_removed_ ? 1 : 0);
+}
+
+
+/**
+  Sets the time the scheduler may spend running tasks each time the
+  event loop is idle (default: 5 ms).
+
+  A task step that is running when the budget is used up is not
+  interrupted, so steps should be short compared to the budget.
+  With a frame rate set with Fl::frame_rate(double), choose a budget
+  well below the frame interval so that drawing keeps up.
+*/
+void Fl_Task_Scheduler::budget(double seconds) {
+  budget_ = seconds > 0 ? seconds : 0;
+}
+
+
+/**
+  Runs pending tasks for up to \p seconds, without handling events.
+  This can be used to finish background work before it is needed,
+  e.g. before printing. Use a negative value to run all tasks to
+  completion.
+  \return the number of tasks still pending
+*/
+int Fl_Task_Scheduler::run(double seconds) {
+  if (running_) return tasks(); // called by a task
+  Fl_Timestamp start = Fl::now();
+  while (run_one()) {
+    if (seconds >= 0 && Fl::seconds_since(start) >= seconds) break;
+  }
+  if (!first_) Fl::remove_idle(idle_cb_);
+  return tasks();
+}
+
+
+void Fl_Task_Scheduler::idle_cb_(void *) {
+  if (running_) return; // a task called Fl::check() or Fl::wait()
+  Fl_Timestamp start = Fl::now();
+  // always make progress, then stop when the budget is used up or events
+  // or timeouts are waiting
+  while (run_one()) {
+    if (!first_ || Fl::seconds_since(start) >= budget_ || Fl::ready()) break;
+  }
+  if (!first_) Fl::remove_idle(idle_cb_);
+}
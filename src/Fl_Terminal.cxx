@@ -708,8 +708,12 @@ void Fl_Terminal::RingBuffer::offset_adjust(int rows) {
 //   around the end of the ring. The NEW buffer's offset will be zero,
 //   so the hist/disp do NOT wrap around, making the move operation easier to debug.
 //
-//   The copy preservation starts at the LAST ROW in display of both old (src) and new (dst)
-//   buffers, and copies rows in reverse until hist_use_srow() reached, or if we hit top
+//   Rows are not copied: only the row pointers are moved into the new ring, so the
+//   cost is proportional to #rows, not #rows * #cols. Row contents are widened (or
+//   logically truncated) to the new column count when the row is next accessed.
+//
+//   The move preservation starts at the LAST ROW in display of both old (src) and new (dst)
+//   buffers, and moves rows in reverse until hist_use_srow() reached, or if we hit top
 //   of the new history (index=0), which ever comes first. So in the following where the
 //   display is being enlarged, the copy preservation starts at "Line 5" (bottom of display)
 //   and works upwards, ending at "Line 1" (top of history use):
@@ -732,62 +736,94 @@ void Fl_Terminal::RingBuffer::new_copy(int drows, int dcols, int hrows, const Ch
   int addhist       = disp_rows() - drows;                  // adjust history use
   int new_ring_rows = (drows+hrows);
   int new_hist_use  = clamp(hist_use_ + addhist, 0, hrows); // clamp incase new_hist_rows smaller than old
-  int new_nchars    = (new_ring_rows * dcols);
-  Utf8Char *new_ring_chars = new Utf8Char[new_nchars];      // Create new ring buffer (†)
+  Row *new_rows     = new Row[new_ring_rows];               // Create new ring of empty rows (†)
+  memset(new_rows, 0, new_ring_rows * sizeof(Row));
   // Preserve old contents in new buffer
-  int dst_cols      = dcols;
   int src_stop_row  = hist_use_srow();
-  int tcols         = MIN(ring_cols(), dcols);
   int src_row       = hist_use_srow() + hist_use_ + disp_rows_ - 1; // use row#s relative to hist_use_srow()
   int dst_row       = new_ring_rows - 1;
-  // Copy rows: working up from bottom of disp, stop at top of hist
+  // Move rows: working up from bottom of disp, stop at top of hist
   while ((src_row >= src_stop_row) && (dst_row >= 0)) {
-    Utf8Char *src = u8c_ring_row(src_row);
-    Utf8Char *dst = new_ring_chars + (dst_row*dst_cols);
-    for (int col=0; col<tcols; col++ ) *dst++ = *src++;
+    Row &src = rows_[normalize(src_row, ring_rows_)];
+    new_rows[dst_row] = src;                                // new ring owns row's chars now
+    src.chars_ = 0;
+    src.cols_ = src.alloc_ = 0;
     --src_row;
     --dst_row;
   }
-  // Install new buffer: dump old, install new, adjust internals
-  if (ring_chars_) delete[] ring_chars_;
-  ring_chars_ = new_ring_chars;
+  // Install new buffer: dump old (rows not moved), install new, adjust internals
+  for (int row=0; row<ring_rows_; row++) free_row(rows_[row]);
+  delete[] rows_;
+  rows_       = new_rows;
   ring_rows_  = new_ring_rows;
   ring_cols_  = dcols;
-  nchars_     = new_nchars;
   hist_rows_  = hrows;
   hist_use_   = new_hist_use;
   disp_rows_  = drows;
   offset_     = 0;        // for new buffer, we used a zero offset
 }
 
+// Free a row's chars, leaving it empty
+void Fl_Terminal::RingBuffer::free_row(Row &row) {
+  delete[] row.chars_;
+  row.chars_ = 0;
+  row.cols_  = 0;
+  row.alloc_ = 0;
+}
+
+// Return the chars for ring row index 'rowi', sized to ring_cols().
+//    Rows are allocated on first access, and rows last used with a different
+//    #columns are adjusted here: widened rows get blank chars on the right,
+//    narrowed rows keep their allocation so a later widen is cheap.
+//
+Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::row_chars(int rowi) const {
+  Row &row = rows_[rowi];
+  if (row.cols_ == ring_cols_) return row.chars_;     // most common case
+  if (row.alloc_ < ring_cols_) {                      // too small? grow allocation
+    Utf8Char *chars = new Utf8Char[ring_cols_];
+    for (int col=0; col<row.cols_; col++) chars[col] = row.chars_[col];
+    delete[] row.chars_;
+    row.chars_ = chars;
+    row.alloc_ = ring_cols_;
+  } else {                                            // blank cols beyond old width
+    for (int col=row.cols_; col<ring_cols_; col++) row.chars_[col] = Utf8Char();
+  }
+  row.cols_ = ring_cols_;
+  return row.chars_;
+}
+
 // Clear the class, delete previous ring if any
 void Fl_Terminal::RingBuffer::clear(void) {
-  if (ring_chars_) delete[] ring_chars_; // dump our ring
-  ring_chars_ = 0;
+  if (rows_) {                           // dump our ring
+    for (int row=0; row<ring_rows_; row++) free_row(rows_[row]);
+    delete[] rows_;
+  }
+  rows_       = 0;
   ring_rows_  = 0;
   ring_cols_  = 0;
-  nchars_     = 0;
   hist_rows_  = 0;
   hist_use_   = 0;
   disp_rows_  = 0;
   offset_     = 0;
 }
 
-// Clear history
+// Clear history, freeing the memory of the history rows
 void Fl_Terminal::RingBuffer::clear_hist(void) {
   hist_use_ = 0;
+  for (int hrow=0; hrow<hist_rows_; hrow++)
+    free_row(rows_[(hrow + offset_) % ring_rows_]);
 }
 
 // Default ctor
 Fl_Terminal::RingBuffer::RingBuffer(void) {
-  ring_chars_ = 0;
+  rows_ = 0;
   clear();
 }
 
 // Ctor with specific sizes
 Fl_Terminal::RingBuffer::RingBuffer(int drows, int dcols, int hrows) {
   // Start with cleared buffer first..
-  ring_chars_ = 0;
+  rows_ = 0;
   clear();
   // ..then create.
   create(drows, dcols, hrows);
@@ -795,8 +831,7 @@ Fl_Terminal::RingBuffer::RingBuffer(int drows, int dcols, int hrows) {
 
 // Dtor
 Fl_Terminal::RingBuffer::~RingBuffer(void) {
-  if (ring_chars_) delete[] ring_chars_;
-  ring_chars_ = NULL;
+  clear();
 }
 
 // See if 'grow' is within the history buffer
@@ -919,7 +954,7 @@ void Fl_Terminal::RingBuffer::scroll(int rows, const CharStyle& style) {
 const Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::u8c_ring_row(int row) const {
   row = normalize(row, ring_rows());
   assert(row >= 0 && row < ring_rows_);
-  return &ring_chars_[row * ring_cols()];
+  return row_chars(row);
 }
 
 // Return UTF-8 char for beginning of 'row' in the history buffer.
@@ -934,7 +969,7 @@ const Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::u8c_hist_row(int hrow) con
   int rowi = normalize(hrow, hist_rows());
   rowi = (rowi + offset_) % ring_rows_;
   assert(rowi >= 0 && rowi <= ring_rows_);
-  return &ring_chars_[rowi * ring_cols()];
+  return row_chars(rowi);
 }
 
 // Special case to walk the "in use" rows of the history
@@ -949,9 +984,9 @@ const Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::u8c_hist_use_row(int hurow
   if (hist_use_ == 0) return 0;             // history is empty! (caller is dumb to ask)
   hurow = hurow % hist_use_;                // normalize indexing within history in use
   hurow = hist_rows_ - hist_use_ + hurow;   // index hist_use rows from end history
-  hurow = (hurow + offset_) % ring_rows_;   // convert to absolute index in ring_chars_[]
-  assert(hurow >= 0 && hurow <= hist_use());
-  return &ring_chars_[hurow * ring_cols()];
+  hurow = (hurow + offset_) % ring_rows_;   // convert to absolute index in rows_[]
+  assert(hurow >= 0 && hurow <= ring_rows_);
+  return row_chars(hurow);
 }
 
 // Return UTF-8 char for beginning of 'row' in the display buffer
@@ -966,7 +1001,7 @@ const Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::u8c_disp_row(int drow) con
   int rowi = normalize(drow, disp_rows());
   rowi = (hist_rows_ + rowi + offset_) % ring_rows_; // display starts at end of history
   assert(rowi >= 0 && rowi <= ring_rows_);
-  return &ring_chars_[rowi * ring_cols()];
+  return row_chars(rowi);
 }
 
 // non-const versions of the above ////////////////////////////////////////////////
@@ -1000,6 +1035,7 @@ Fl_Terminal::Utf8Char* Fl_Terminal::RingBuffer::u8c_disp_row(int drow)
   { return const_cast<Utf8Char*>(const_cast<const RingBuffer*>(this)->u8c_disp_row(drow)); }
 
 // Resize ring buffer by creating new one, dumping old (if any).
+//    Rows are left empty, and are allocated when first accessed.
 // Input:
 //    drows -- display height in lines of text (rows)
 //    dcols -- display width in characters (columns)
@@ -1015,8 +1051,8 @@ void Fl_Terminal::RingBuffer::create(int drows, int dcols, int hrows) {
   // Ring buffer
   ring_rows_  = hist_rows_ + disp_rows_;
   ring_cols_  = dcols;
-  nchars_     = ring_rows_ * ring_cols_;
-  ring_chars_ = new Utf8Char[nchars_];
+  rows_       = new Row[ring_rows_];
+  memset(rows_, 0, ring_rows_ * sizeof(Row));
 }
 
 // Resize the buffer, preserve previous contents as much as possible
@@ -1025,12 +1061,14 @@ void Fl_Terminal::RingBuffer::resize(int drows, int dcols, int hrows, const Char
   int  old_rows     = disp_rows() + hist_rows();  // new display + history rows
   bool cols_changed = (dcols != disp_cols());     // was there a change in total #columns?
   bool rows_changed = (new_rows != old_rows);     // was there a change in total #rows?
-  // If rows or cols changed, make a NEW buffer and copy old contents.
-  // New copy will have disp/hist_rows/cols and nchars adjusted.
-  if (cols_changed || rows_changed) {             // rows or cols changed?
+  // If total rows changed, make a NEW ring and move old rows into it.
+  // New copy will have disp/hist_rows/cols adjusted.
+  if (rows_changed) {                             // rows changed?
     new_copy(drows, dcols, hrows, style);         // rebuild ring buffer, preserving contents
   } else {
-    // Cols and total rows the same, probably just changed disp/hist ratio
+    // Only cols changed? Rows are resized lazily when next accessed
+    if (cols_changed) ring_cols_ = dcols;
+    // Total rows the same, probably just changed disp/hist ratio
     int addhist = disp_rows() - drows;            // adj hist_use smaller if disp enlarged
     hist_rows_  = hrows;                          // adj hist rows for new value
     disp_rows_  = drows;                          // adj disp rows for new value
@@ -1819,7 +1857,7 @@ int Fl_Terminal::x_to_glob_col(int X, int grow, int &gcol, bool &gcr) const {
   return 0;                                         // not found
 }
 
-// Convert fltk window X,Y coords to row + column indexing into ring_chars[]
+// Convert fltk window X,Y coords to global row + column of the ring (see u8c_ring_row())
 // Returns:
 //              1 -- found row,col
 //              0 -- not found, outside display's character area
@@ -2301,16 +2339,9 @@ void Fl_Terminal::delete_chars(int rep) {
   forcing it to redraw().
 */
 void Fl_Terminal::clear_history(void) {
-  // Adjust history use
+  // Adjust history use, release history rows (re-created blank when next used)
   ring_.clear_hist();
   scrollbar->value(0);   // zero scroll position
-  // Clear entire history buffer
-  for (int hrow=0; hrow<hist_rows(); hrow++) {
-    Utf8Char *u8c = u8c_hist_row(hrow);          // walk history rows..
-    for (int hcol=0; hcol<hist_cols(); hcol++) { // ..and history cols
-      (u8c++)->clear(*current_style_);
-    }
-  }
   // Adjust scrollbar (hist_use changed)
   update_scrollbar();
 }
@@ -2372,13 +2403,13 @@ void Fl_Terminal::reset_terminal(void) {
 //DEBUG     if (row >= arows) {
 //DEBUG       ::printf("          %*s   ", acols, "");
 //DEBUG     } else {
-//DEBUG       u8c = a->ring_chars()+(arows*acols);
+//DEBUG       u8c = a->u8c_ring_row(row);
 //DEBUG       ::printf("%3d/%3d [", row, trows-1); write_row(stdout, u8c, acols); ::printf("]  ");
 //DEBUG     }
 //DEBUG     if (!b) { ::printf("\033[K\n"); continue; }
 //DEBUG     // 'B' buffer
 //DEBUG     if (row < brows) {
-//DEBUG       u8c = b->ring_chars()+(brows*bcols);
+//DEBUG       u8c = b->u8c_ring_row(row);
 //DEBUG       ::printf("["); write_row(stdout, u8c, bcols); ::printf("]");
 //DEBUG     }
 //DEBUG     ::printf("\033[K\n");
@@ -3547,7 +3578,7 @@ void  Fl_Terminal::hscrollbar_style(ScrollbarStyle val) {
 ////////////////////////////
 
 /**
-  Draw the background for the specified ring_chars[] global row \p grow
+  Draw the background for the specified global row \p grow of the ring
   starting at FLTK coords \p X and \p Y.
 
   Note we may be called to draw display, or even history if we're scrolled back.
@@ -3590,7 +3621,7 @@ void Fl_Terminal::draw_row_bg(int grow, int X, int Y) const {
 }
 
 /**
-  Draw the specified global row, which is the row in ring_chars[].
+  Draw the specified global row, which is the ring row returned by u8c_ring_row().
   The global row includes history + display buffers.
 
  \param[in] grow row number
@@ -3923,6 +3954,13 @@ int Fl_Terminal::handle(int e) {
   return ret;
 }
 
+// Append line and a newline to the Fl_String in 'data'
+static void text_append_cb(const char *line, int len, void *data) {
+  Fl_String *lines = (Fl_String*)data;
+  lines->append(line, len);
+  lines->append('\n');
+}
+
 /**
   Return a string copy of all lines in the terminal (including history).
   The returned string is allocated with strdup(3), which the caller must free.
@@ -3946,9 +3984,46 @@ int Fl_Terminal::handle(int e) {
   \param[in]  lines_below_cursor  include lines below cursor, default: false
 
   \return A string allocated with strdup(3) which must be free'd, text is UTF-8.
+
+  \see text_lines(), write_text() to process very large histories a line at a time.
 */
 const char* Fl_Terminal::text(bool lines_below_cursor) const {
   Fl_String lines;          // lines of text we'll return
+  text_lines(text_append_cb, &lines, lines_below_cursor);
+  return fl_strdup(lines.c_str());
+}
+
+/**
+  Pass each line of the terminal's text to callback \p cb.
+
+  This walks the same lines text() returns: the scrollback history in use,
+  followed by the display, with trailing whitespace trimmed from each line.
+  Lines are passed one at a time, so unlike text() the whole history is never
+  held in memory at once, which suits exporting very large histories.
+
+  Example use:
+  \par
+  \code
+      // Count the lines containing "error"
+      static void count_cb(const char *line, int len, void *data) {
+        std::string s(line, len);
+        if (s.find("error") != std::string::npos) (*(int*)data)++;
+      }
+      :
+      int count = 0;
+      tty->text_lines(count_cb, &count);
+  \endcode
+
+  \param[in]  cb                  called for each line; \p line is not NULL terminated,
+                                  and is only valid during the call
+  \param[in]  data                user data passed to \p cb
+  \param[in]  lines_below_cursor  include lines below cursor, default: false
+
+  \see text(), write_text(FILE*,bool)
+*/
+void Fl_Terminal::text_lines(Fl_Terminal_Line_Callback *cb, void *data,
+                             bool lines_below_cursor) const {
+  Fl_String line;           // current line, reused for each row
   // See how many display rows we need to include
   int disprows = lines_below_cursor ? disp_rows() - 1    // all display lines
                                     : cursor_row();      // only lines up to cursor
@@ -3958,18 +4033,189 @@ const char* Fl_Terminal::text(bool lines_below_cursor) const {
   for (int row=srow; row<=erow; row++) {                 // walk rows
     const Utf8Char *u8c = u8c_ring_row(row);             // start of row
     int trim = 0;
+    line.clear();
     for (int col=0; col<ring_cols(); col++,u8c++) {      // walk cols in row
       const char *s = u8c->text_utf8();                  // first byte of char
-      for (int i=0; i<u8c->length(); i++) lines += *s++; // append all bytes in multibyte char
+      line.append(s, u8c->length());                     // append all bytes in multibyte char
       // Count any trailing whitespace to trim
-      if (u8c->length()==1 && s[-1]==' ') trim++;        // trailing whitespace? trim
-      else                                trim = 0;      // non-whitespace? don't trim
+      if (u8c->length()==1 && *s==' ') trim++;           // trailing whitespace? trim
+      else                             trim = 0;         // non-whitespace? don't trim
     }
-    // trim trailing whitespace from each line, if any
-    if (trim) lines.resize(lines.size() - trim);
-    lines += "\n";
+    // trim trailing whitespace from line, if any
+    (*cb)(line.c_str(), line.size() - trim, data);
   }
-  return fl_strdup(lines.c_str());
+}
+
+// Write line and a newline to the FILE* in 'data'
+static void write_text_cb(const char *line, int len, void *data) {
+  FILE *fp = (FILE*)data;
+  fwrite(line, 1, len, fp);
+  fputc('\n', fp);
+}
+
+/**
+  Write the terminal's text to an open file, one line at a time.
+
+  The text written is the same as text() returns, but it is written
+  as each line is read, so the whole history is never held in memory.
+
+  \param[in]  fp                  file open for writing
+  \param[in]  lines_below_cursor  include lines below cursor, default: false
+
+  \return 0 on success, -1 if there was a write error (see ferror(3))
+
+  \see text(), text_lines()
+*/
+int Fl_Terminal::write_text(FILE *fp, bool lines_below_cursor) const {
+  text_lines(write_text_cb, (void*)fp, lines_below_cursor);
+  return ferror(fp) ? -1 : 0;
+}
+
+// Decode the chars in text row 'row' into 'ucs', one Unicode value per
+// column, lowercased unless 'match_case'. ucs[] must hold ring_cols() values.
+//
+void Fl_Terminal::text_row_ucs(int row, unsigned *ucs, bool match_case) const {
+  const Utf8Char *u8c = u8c_ring_row(hist_use_srow() + row);
+  for (int col=0; col<ring_cols(); col++,u8c++) {
+    const char *s = u8c->text_utf8();
+    int len;
+    unsigned c = fl_utf8decode(s, s + u8c->length(), &len);
+    ucs[col] = match_case ? c : (unsigned)fl_tolower(c);
+  }
+}
+
+// Decode UTF-8 string 'str' into a malloc'd array of Unicode values,
+// lowercased unless 'match_case'. Returns #values in 'n'.
+//
+static unsigned *search_ucs(const char *str, bool match_case, int &n) {
+  const char *end = str + strlen(str);
+  unsigned *ucs = (unsigned*)malloc((end - str + 1) * sizeof(unsigned));
+  for (n=0; str < end; n++) {
+    int len;
+    unsigned c = fl_utf8decode(str, end, &len);
+    ucs[n] = match_case ? c : (unsigned)fl_tolower(c);
+    str += len;
+  }
+  return ucs;
+}
+
+/**
+  Search the terminal's text forward for string \p str.
+
+  Rows are numbered the same way as the lines returned by text(true):
+  row 0 is the oldest line of the scrollback history in use, and row
+  history_use()+display_rows()-1 is the last row of the display.
+  Columns are character positions within the row.
+
+  The search starts at \p row, \p col and moves towards the end of the
+  text. Matches do not span rows. Rows are searched in place, so no copy
+  of the text is made.
+
+  \param[in]  row,col     row and column where the search starts
+  \param[in]  str         UTF-8 string to search for
+  \param[out] frow,fcol   row and column of the start of the match, if found
+  \param[in]  match_case  if false (default), the search ignores case
+
+  \return true if found, false if not found
+
+  \see search_backward(), search_select()
+*/
+bool Fl_Terminal::search_forward(int row, int col, const char *str,
+                                 int &frow, int &fcol, bool match_case) const {
+  int nrows = hist_use() + disp_rows();
+  int ncols = ring_cols();
+  int npat;
+  unsigned *pat  = search_ucs(str, match_case, npat);
+  unsigned *line = (unsigned*)malloc(ncols * sizeof(unsigned));
+  bool found = false;
+  if (row < 0) { row = 0; col = 0; }                     // before start? start at top
+  for (; !found && npat > 0 && row < nrows; row++, col = 0) {
+    text_row_ucs(row, line, match_case);
+    for (int c=MAX(col,0); c<=ncols-npat; c++) {
+      if (memcmp(line + c, pat, npat * sizeof(unsigned)) == 0)
+        { frow = row; fcol = c; found = true; break; }
+    }
+  }
+  free(line);
+  free(pat);
+  return found;
+}
+
+/**
+  Search the terminal's text backward for string \p str.
+
+  Finds the last match that starts at or before \p row, \p col.
+  See search_forward() for how rows and columns are numbered.
+
+  \param[in]  row,col     row and column where the search starts
+  \param[in]  str         UTF-8 string to search for
+  \param[out] frow,fcol   row and column of the start of the match, if found
+  \param[in]  match_case  if false (default), the search ignores case
+
+  \return true if found, false if not found
+
+  \see search_forward(), search_select()
+*/
+bool Fl_Terminal::search_backward(int row, int col, const char *str,
+                                  int &frow, int &fcol, bool match_case) const {
+  int nrows = hist_use() + disp_rows();
+  int ncols = ring_cols();
+  int npat;
+  unsigned *pat  = search_ucs(str, match_case, npat);
+  unsigned *line = (unsigned*)malloc(ncols * sizeof(unsigned));
+  bool found = false;
+  if (row >= nrows) { row = nrows - 1; col = ncols; }    // past end? start at bottom
+  for (; !found && npat > 0 && row >= 0; row--, col = ncols) {
+    text_row_ucs(row, line, match_case);
+    for (int c=MIN(col,ncols-npat); c>=0; c--) {
+      if (memcmp(line + c, pat, npat * sizeof(unsigned)) == 0)
+        { frow = row; fcol = c; found = true; break; }
+    }
+  }
+  free(line);
+  free(pat);
+  return found;
+}
+
+/**
+  Find the next match for \p str and select it.
+
+  Searches from the current selection (or from the top of the history
+  when searching forward, or the bottom of the display when searching
+  backward, if there is no selection). The match is selected, scrolled
+  into view, and redrawn. Calling this again finds the next match, so
+  it can be used for a "find next" / "find previous" feature.
+
+  \param[in]  str         UTF-8 string to search for
+  \param[in]  forward     true (default) to search forward, false to search backward
+  \param[in]  match_case  if false (default), the search ignores case
+
+  \return true if a match was found and selected, false if not found
+           (the selection is left unchanged)
+
+  \see search_forward(), search_backward(), selection_text()
+*/
+bool Fl_Terminal::search_select(const char *str, bool forward, bool match_case) {
+  int nrows  = hist_use() + disp_rows();
+  int toprow = disp_srow() - hist_use();       // global row of text row 0
+  int row = forward ? 0 : nrows, col = 0;
+  int srow, scol, erow, ecol;
+  if (get_selection(srow, scol, erow, ecol)) { // start next to selection
+    row = normalize(srow - toprow, ring_rows());
+    col = forward ? scol + 1 : scol - 1;
+  }
+  int frow, fcol;
+  bool found = forward ? search_forward(row, col, str, frow, fcol, match_case)
+                       : search_backward(row, col, str, frow, fcol, match_case);
+  if (!found) return false;
+  int nchars = fl_utf_nb_char((const unsigned char*)str, (int)strlen(str));
+  select_.select(toprow + frow, fcol, toprow + frow, fcol + nchars - 1);
+  // Scroll match into view if it's offscreen
+  int vrow = frow - hist_use() + scrollbar->value();  // row on screen
+  if (vrow < 0 || vrow >= disp_rows())
+    scrollbar->value(clamp(hist_use() - frow, 0, hist_use()));
+  redraw();
+  return true;
 }
 
 /**
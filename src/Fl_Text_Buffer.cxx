@@ -116,6 +116,29 @@ public:
     }
   }
 
+  /*
+   Release the unused part of the undo buffer. Called when the action is
+   pushed to a list, because it won't grow anymore.
+   */
+  void shrink() {
+    int n = undocut + undoyankcut; // at most one of them is set
+    if (n >= undobufferlength) return;
+    if (n) {
+      undobuffer = (char *)realloc(undobuffer, n);
+    } else {
+      ::free(undobuffer);
+      undobuffer = NULL;
+    }
+    undobufferlength = n;
+  }
+
+  /*
+   Return the number of bytes used by this action.
+   */
+  int memory() const {
+    return (int)sizeof(Fl_Text_Undo_Action) + undobufferlength;
+  }
+
   void clear() {
     undocut = undoinsert = 0;
   }
@@ -139,17 +162,22 @@ public:
  current.
 
  A list can be locked to be protected from purging while running an undo event.
+
+ The list keeps track of the memory used by its actions, so that the oldest
+ actions can be dropped when the undo history exceeds its memory limit.
  */
 class Fl_Text_Undo_Action_List {
   Fl_Text_Undo_Action** list_;
   int list_size_;
   int list_capacity_;
+  int memory_;
   bool locked_;
 public:
   Fl_Text_Undo_Action_List() :
   list_(NULL),
   list_size_(0),
   list_capacity_(0),
+  memory_(0),
   locked_(false)
   { }
 
@@ -162,22 +190,39 @@ public:
     return list_size_;
   }
 
+  int memory() const {
+    return memory_;
+  }
+
   void push(Fl_Text_Undo_Action* action) {
     if (list_size_ == list_capacity_) {
       list_capacity_ += 25;
       list_ = (Fl_Text_Undo_Action**)realloc(list_, list_capacity_ * sizeof(Fl_Text_Undo_Action*));
     }
+    action->shrink();
+    memory_ += action->memory();
     list_[list_size_++] = action;
   }
 
   Fl_Text_Undo_Action* pop() {
     if (list_size_ > 0) {
-      return list_[--list_size_];
+      Fl_Text_Undo_Action* action = list_[--list_size_];
+      memory_ -= action->memory();
+      return action;
     } else {
       return NULL;
     }
   }
 
+  // Delete the action at the bottom of the stack
+  void drop_oldest() {
+    if (list_size_ > 0) {
+      memory_ -= list_[0]->memory();
+      delete list_[0];
+      memmove(list_, list_ + 1, (--list_size_) * sizeof(Fl_Text_Undo_Action*));
+    }
+  }
+
   void clear() {
     if (locked_) return;
     if (list_) {
@@ -189,12 +234,31 @@ public:
     list_ = NULL;
     list_size_ = 0;
     list_capacity_ = 0;
+    memory_ = 0;
   }
 
   void lock() { locked_ = true; }
   void unlock() { locked_ = false; }
+  bool locked() const { return locked_; }
 };
 
+/*
+ Drop the oldest undo actions, then the most distant redo actions, until
+ the undo history fits into the memory limit. The current undo action is
+ always kept. Nothing is dropped while an undo action is running, because
+ undo() relies on the action it generates on top of the undo list.
+ */
+static void trim_undo_history(Fl_Text_Undo_Action_List *undo_list,
+                              Fl_Text_Undo_Action_List *redo_list, int limit)
+{
+  if (limit <= 0 || redo_list->locked())
+    return;
+  while (undo_list->size() && undo_list->memory() + redo_list->memory() > limit)
+    undo_list->drop_oldest();
+  while (redo_list->size() && redo_list->memory() > limit)
+    redo_list->drop_oldest();
+}
+
 
 static void def_transcoding_warning_action(Fl_Text_Buffer *text)
 {
@@ -229,6 +293,7 @@ Fl_Text_Buffer::Fl_Text_Buffer(int requestedSize, int preferredGapSize)
   mUndo = new Fl_Text_Undo_Action();
   mUndoList = new Fl_Text_Undo_Action_List();
   mRedoList = new Fl_Text_Undo_Action_List();
+  mUndoMemoryLimit = 32 * 1024 * 1024;
   input_file_was_transcoded = 0;
   transcoding_warning_action = def_transcoding_warning_action;
 }
@@ -627,6 +692,7 @@ int Fl_Text_Buffer::undo(int *cursorPos) {
       mUndo = mUndoList->pop();
       if (!mUndo) mUndo = new Fl_Text_Undo_Action();
     }
+    trim_undo_history(mUndoList, mRedoList, mUndoMemoryLimit);
   }
 
   return ret;
@@ -685,6 +751,25 @@ void Fl_Text_Buffer::canUndo(char flag)
   mCanUndo = flag;
 }
 
+/*
+ Set the memory limit of the undo history and drop old actions if needed.
+ */
+void Fl_Text_Buffer::undo_memory_limit(int bytes)
+{
+  mUndoMemoryLimit = bytes > 0 ? bytes : 0;
+  trim_undo_history(mUndoList, mRedoList, mUndoMemoryLimit);
+}
+
+/*
+ Return the memory used by the undo and redo history.
+ */
+int Fl_Text_Buffer::undo_memory() const
+{
+  int n = mUndoList->memory() + mRedoList->memory();
+  if (mUndo) n += mUndo->memory();
+  return n;
+}
+
 
 /*
  Change the tab width. This will cause a couple of callbacks and a complete
@@ -1285,8 +1370,188 @@ int Fl_Text_Buffer::rewind_lines(int startPos, int nLines)
 
 
 /*
- Find a matching string in the buffer.
+ Substring search with the Boyer-Moore-Horspool algorithm.
+
+ The searcher finds matches in a contiguous range of bytes. The gap buffer
+ is searched in three parts: the text before the gap, a small copy of the
+ bytes around the gap for matches that span it, and the text after the gap.
+
+ For case-insensitive searches the needle is folded once with fl_tolower().
+ fl_tolower() maps ASCII characters to ASCII characters, other characters
+ to other characters of the same UTF-8 length, so a text byte can only match
+ a needle byte of the same kind. The skip tables treat all non-ASCII bytes
+ alike, which is conservative but never skips a match.
+ */
+class Fl_Text_Searcher {
+  unsigned char *needle_;       // folded if caseless
+  int m_;                       // length in bytes
+  bool caseless_;
+  int skip_[256];               // forward shift by the last byte of a window
+  int rskip_[256];              // backward shift by the first byte of a window
+  static unsigned char fold_[256];  // ASCII case folding
+
+  int fold(unsigned char c) const { return caseless_ ? fold_[c] : c; }
+
+public:
+  Fl_Text_Searcher(const char *s, int matchCase) {
+    if (!fold_['A']) for (int c = 0; c < 256; c++) fold_[c] = (c < 128) ? (unsigned char)tolower(c) : c;
+    caseless_ = !matchCase;
+    m_ = (int)strlen(s);
+    needle_ = (unsigned char*)malloc(m_ + 1);
+    if (caseless_) {
+      int o = 0;
+      for (int i = 0; i < m_; ) {
+        int l;
+        unsigned cp = fl_utf8decode(s + i, s + m_, &l);
+        int n = fl_utf8encode(fl_tolower(cp), (char*)needle_ + o);
+        if (n != l) { memcpy(needle_ + o, s + i, l); n = l; } // invalid UTF-8
+        i += l; o += n;
+      }
+    } else {
+      memcpy(needle_, s, m_);
+    }
+    needle_[m_] = 0;
+    int non_ascii = m_, rnon_ascii = m_;
+    for (int i = 0; i < m_ - 1; i++)
+      if (needle_[i] >= 0x80) non_ascii = m_ - 1 - i;
+    for (int i = m_ - 1; i > 0; i--)
+      if (needle_[i] >= 0x80) rnon_ascii = i;
+    for (int c = 0; c < 256; c++) {
+      skip_[c] = (c >= 0x80 && caseless_) ? non_ascii : m_;
+      rskip_[c] = (c >= 0x80 && caseless_) ? rnon_ascii : m_;
+    }
+    for (int i = 0; i < m_ - 1; i++) {
+      unsigned char c = needle_[i];
+      if (!caseless_) skip_[c] = m_ - 1 - i;
+      else if (c < 0x80) skip_[c] = skip_[toupper(c)] = m_ - 1 - i;
+    }
+    for (int i = m_ - 1; i > 0; i--) {
+      unsigned char c = needle_[i];
+      if (!caseless_) rskip_[c] = i;
+      else if (c < 0x80) rskip_[c] = rskip_[toupper(c)] = i;
+    }
+  }
+  ~Fl_Text_Searcher() { free(needle_); }
+
+  int length() const { return m_; }
+
+  // Returns true if the needle matches the m_ bytes at t
+  bool match(const unsigned char *t) const {
+    if (!caseless_) return memcmp(t, needle_, m_) == 0;
+    if ((t[0] & 0xC0) == 0x80) return false; // not at a character boundary
+    for (int i = 0; i < m_; ) {
+      unsigned char n = needle_[i];
+      if (n < 0x80) {
+        if (fold_[t[i]] != n) return false;
+        i++;
+        continue;
+      }
+      int l, ln;
+      unsigned cp = fl_utf8decode((const char*)t + i, (const char*)t + m_, &l);
+      unsigned ncp = fl_utf8decode((const char*)needle_ + i, (const char*)needle_ + m_, &ln);
+      if (l != ln || (unsigned)fl_tolower(cp) != ncp) return false;
+      i += l;
+    }
+    return true;
+  }
+
+  // Returns the first match in [begin, end), or NULL
+  const unsigned char *find(const unsigned char *begin, const unsigned char *end) const {
+    if (end - begin < m_) return NULL;
+    size_t last = (size_t)(end - begin - m_);
+    if (!caseless_ && m_ <= 2) { // short needle: let memchr() scan for the first byte
+      for (size_t i = 0; i <= last; i++) {
+        const unsigned char *p = (const unsigned char*)memchr(begin + i, needle_[0], last - i + 1);
+        if (!p) return NULL;
+        if (m_ == 1 || p[1] == needle_[1]) return p;
+        i = (size_t)(p - begin);
+      }
+      return NULL;
+    }
+    unsigned char tail = needle_[m_ - 1];
+    bool check = caseless_ && tail >= 0x80; // can't compare single bytes
+    for (size_t i = 0; i <= last; i += skip_[begin[i + m_ - 1]]) {
+      if ((check || fold(begin[i + m_ - 1]) == tail) && match(begin + i))
+        return begin + i;
+    }
+    return NULL;
+  }
+
+  // Returns the last match in [begin, end), or NULL
+  const unsigned char *rfind(const unsigned char *begin, const unsigned char *end) const {
+    if (end - begin < m_) return NULL;
+    unsigned char head = needle_[0];
+    bool check = caseless_ && head >= 0x80;
+    for (size_t i = (size_t)(end - begin - m_); ; i -= rskip_[begin[i]]) {
+      if ((check || fold(begin[i]) == head) && match(begin + i))
+        return begin + i;
+      if (i < (size_t)rskip_[begin[i]]) break;
+    }
+    return NULL;
+  }
+};
+
+unsigned char Fl_Text_Searcher::fold_[256];
+
+/*
+ Finds the first match that starts at or after startPos, or the last match
+ that starts at or before startPos if backward is set. Returns its
+ position or -1. A forward search stops at endPos (-1: end of buffer),
+ the text after it is not scanned.
  */
+int Fl_Text_Buffer::search_(const Fl_Text_Searcher &s, int startPos, bool backward, int endPos) const
+{
+  int m = s.length();
+  int len = (endPos >= 0 && endPos < mLength && !backward) ? endPos : mLength; // end of searched text
+  if (m == 0 || m > len) return -1;
+  const unsigned char *a = (const unsigned char*)mBuf;                 // before the gap
+  const unsigned char *b = (const unsigned char*)mBuf + mGapEnd - mGapStart; // b+pos for pos >= mGapStart
+  const unsigned char *p;
+  // the bytes around the gap, for matches that span it
+  int seamStart = mGapStart - (m - 1);
+  if (seamStart < 0) seamStart = 0;
+  int seamEnd = mGapStart + (m - 1);
+  if (seamEnd > len) seamEnd = len;
+  unsigned char seamBuf[256];
+  unsigned char *seam = NULL;
+  if (mGapStart > 0 && mGapStart < len && seamEnd - seamStart >= m) {
+    seam = (seamEnd - seamStart <= (int)sizeof(seamBuf)) ?
+      seamBuf : (unsigned char*)malloc(seamEnd - seamStart);
+    memcpy(seam, a + seamStart, mGapStart - seamStart);
+    memcpy(seam + mGapStart - seamStart, b + mGapStart, seamEnd - mGapStart);
+  }
+  int found = -1;
+  if (!backward) {
+    if (startPos < 0) startPos = 0;
+    if (startPos < mGapStart && (p = s.find(a + startPos, a + (mGapStart < len ? mGapStart : len))))
+      found = (int)(p - a);
+    else if (seam && startPos < mGapStart) {
+      int from = startPos > seamStart ? startPos : seamStart;
+      if ((p = s.find(seam + from - seamStart, seam + seamEnd - seamStart)))
+        found = (int)(p - seam) + seamStart;
+    }
+    if (found < 0) {
+      int from = startPos > mGapStart ? startPos : mGapStart;
+      if (from < len && (p = s.find(b + from, b + len))) found = (int)(p - b);
+    }
+  } else {
+    if (startPos > mLength - m) startPos = mLength - m;
+    if (startPos >= mGapStart && (p = s.rfind(b + mGapStart, b + startPos + m)))
+      found = (int)(p - b);
+    else if (seam && startPos >= seamStart) {
+      int to = startPos + m < seamEnd ? startPos + m : seamEnd;
+      if ((p = s.rfind(seam, seam + to - seamStart)))
+        found = (int)(p - seam) + seamStart;
+    }
+    if (found < 0 && startPos >= 0) {
+      int to = startPos + m < mGapStart ? startPos + m : mGapStart;
+      if ((p = s.rfind(a, a + to))) found = (int)(p - a);
+    }
+  }
+  if (seam && seam != seamBuf) free(seam);
+  return found;
+}
+
 int Fl_Text_Buffer::search_forward(int startPos, const char *searchString,
                                    int *foundPos, int matchCase) const
 {
@@ -1295,48 +1560,16 @@ int Fl_Text_Buffer::search_forward(int startPos, const char *searchString,
 
   if (!searchString)
     return 0;
-  int bp;
-  const char *sp;
-  if (matchCase) {
-    while (startPos < length()) {
-      bp = startPos;
-      sp = searchString;
-      for (;;) {
-        char c = *sp;
-        // we reached the end of the "needle", so we found the string!
-        if (!c) {
-          *foundPos = startPos;
-          return 1;
-        }
-        int l = fl_utf8len1(c);
-        if (memcmp(sp, address(bp), l))
-          break;
-        sp += l; bp += l;
-      }
-      startPos = next_char(startPos);
-    }
-  } else {
-    while (startPos < length()) {
-      bp = startPos;
-      sp = searchString;
-      for (;;) {
-        // we reached the end of the "needle", so we found the string!
-        if (!*sp) {
-          *foundPos = startPos;
-          return 1;
-        }
-        int l;
-        unsigned int b = char_at(bp);
-        unsigned int s = fl_utf8decode(sp, 0, &l);
-        if (fl_tolower(b)!=fl_tolower(s))
-          break;
-        sp += l;
-        bp = next_char(bp);
-      }
-      startPos = next_char(startPos);
-    }
+  if (!*searchString) { // the empty string is found everywhere
+    if (startPos >= length()) return 0;
+    *foundPos = startPos;
+    return 1;
   }
-  return 0;
+  Fl_Text_Searcher s(searchString, matchCase);
+  int pos = search_(s, startPos, false);
+  if (pos < 0) return 0;
+  *foundPos = pos;
+  return 1;
 }
 
 int Fl_Text_Buffer::search_backward(int startPos, const char *searchString,
@@ -1345,50 +1578,37 @@ int Fl_Text_Buffer::search_backward(int startPos, const char *searchString,
   IS_UTF8_ALIGNED2(this, (startPos))
   IS_UTF8_ALIGNED(searchString)
 
-  if (!searchString)
+  if (!searchString || startPos < 0)
     return 0;
-  int bp;
-  const char *sp;
-  if (matchCase) {
-    while (startPos >= 0) {
-      bp = startPos;
-      sp = searchString;
-      for (;;) {
-        char c = *sp;
-        // we reached the end of the "needle", so we found the string!
-        if (!c) {
-          *foundPos = startPos;
-          return 1;
-        }
-        int l = fl_utf8len1(c);
-        if (memcmp(sp, address(bp), l))
-          break;
-        sp += l; bp += l;
-      }
-      startPos = prev_char(startPos);
-    }
-  } else {
-    while (startPos >= 0) {
-      bp = startPos;
-      sp = searchString;
-      for (;;) {
-        // we reached the end of the "needle", so we found the string!
-        if (!*sp) {
-          *foundPos = startPos;
-          return 1;
-        }
-        int l;
-        unsigned int b = char_at(bp);
-        unsigned int s = fl_utf8decode(sp, 0, &l);
-        if (fl_tolower(b)!=fl_tolower(s))
-          break;
-        sp += l;
-        bp = next_char(bp);
-      }
-      startPos = prev_char(startPos);
-    }
+  if (!*searchString) { // the empty string is found everywhere
+    *foundPos = startPos;
+    return 1;
   }
-  return 0;
+  Fl_Text_Searcher s(searchString, matchCase);
+  int pos = search_(s, startPos, true);
+  if (pos < 0) return 0;
+  *foundPos = pos;
+  return 1;
+}
+
+/*
+ Finds all non-overlapping occurrences of a string.
+ */
+int Fl_Text_Buffer::search_all(const char *searchString, Fl_Text_Match_Cb cb,
+                               void *cbArg, int matchCase, int startPos, int endPos) const
+{
+  IS_UTF8_ALIGNED(searchString)
+
+  if (!searchString || !*searchString)
+    return 0;
+  if (endPos < 0 || endPos > mLength) endPos = mLength;
+  Fl_Text_Searcher s(searchString, matchCase);
+  int m = s.length(), count = 0;
+  for (int pos = startPos; (pos = search_(s, pos, false, endPos)) >= 0; pos += m) {
+    count++;
+    if (cb && !cb(pos, pos + m, cbArg)) break;
+  }
+  return count;
 }
 
 
@@ -1430,6 +1650,7 @@ int Fl_Text_Buffer::insert_(int pos, const char *text, int insertedLength)
         // insert text at a new position, so generate a new undo action
         mRedoList->clear();
         mUndoList->push(mUndo);
+        trim_undo_history(mUndoList, mRedoList, mUndoMemoryLimit);
         mUndo = new Fl_Text_Undo_Action();
       } else {
         // we deleted and inserted at the same position, making this a yankcut
@@ -1453,19 +1674,28 @@ int Fl_Text_Buffer::insert_(int pos, const char *text, int insertedLength)
 void Fl_Text_Buffer::remove_(int start, int end)
 {
   if (start >= end) return;
+  char *undo_dst = NULL; // where the removed text is saved
   if (mCanUndo) {
     if (mUndo->undoat == end && mUndo->undocut) {
-      // continue to remove text at the same cursor position
+      // continue to remove text at the same cursor position (backspace)
       mUndo->undobuffersize(mUndo->undocut + end - start + 1);
       memmove(mUndo->undobuffer + end - start, mUndo->undobuffer, mUndo->undocut);
       mUndo->undocut += end - start;
+      undo_dst = mUndo->undobuffer;
+    } else if (mUndo->undoat == start && mUndo->undocut && !mUndo->undoinsert) {
+      // continue to remove text after the cursor position (delete)
+      mUndo->undobuffersize(mUndo->undocut + end - start + 1);
+      undo_dst = mUndo->undobuffer + mUndo->undocut;
+      mUndo->undocut += end - start;
     } else {
       // remove text at a new position, so generate a new undo action
       mRedoList->clear();
       mUndoList->push(mUndo);
+      trim_undo_history(mUndoList, mRedoList, mUndoMemoryLimit);
       mUndo = new Fl_Text_Undo_Action();
       mUndo->undocut = end - start;
       mUndo->undobuffersize(mUndo->undocut);
+      undo_dst = mUndo->undobuffer;
     }
     mUndo->undoat = start;
     mUndo->undoinsert = 0;
@@ -1473,19 +1703,18 @@ void Fl_Text_Buffer::remove_(int start, int end)
   }
 
   if (start > mGapStart) {
-    if (mCanUndo)
-      memcpy(mUndo->undobuffer, mBuf + (mGapEnd - mGapStart) + start,
-             end - start);
+    if (undo_dst)
+      memcpy(undo_dst, mBuf + (mGapEnd - mGapStart) + start, end - start);
     move_gap(start);
   } else if (end < mGapStart) {
-    if (mCanUndo)
-      memcpy(mUndo->undobuffer, mBuf + start, end - start);
+    if (undo_dst)
+      memcpy(undo_dst, mBuf + start, end - start);
     move_gap(end);
   } else {
     int prelen = mGapStart - start;
-    if (mCanUndo) {
-      memcpy(mUndo->undobuffer, mBuf + start, prelen);
-      memcpy(mUndo->undobuffer + prelen, mBuf + mGapEnd, end - start - prelen);
+    if (undo_dst) {
+      memcpy(undo_dst, mBuf + start, prelen);
+      memcpy(undo_dst + prelen, mBuf + mGapEnd, end - start - prelen);
     }
   }
 
@@ -29,6 +29,7 @@
 #include <FL/platform.H>
 #include <FL/Fl_Text_Buffer.H>
 #include <FL/Fl_Text_Display.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Menu_Item.H>
 #include <FL/Fl_Input.H>
@@ -202,6 +203,11 @@ Fl_Text_Display::Fl_Text_Display(int X, int Y, int W, int H, const char* l)
 }
 
 
+void Fl_Text_Display::shortcut(int s) {
+  shortcut_ = s;
+  Fl_Shortcut_Index::shortcut(this, s);
+}
+
 /**
   Free a text display and release its associated memory.
 
@@ -76,6 +76,7 @@ static int find_total_children(Fl_Tree_Item *item, int count=0) {
 
 /// Constructor.
 Fl_Tree::Fl_Tree(int X, int Y, int W, int H, const char *L) : Fl_Group(X,Y,W,H,L) {
+  _intern_labels = 0;                           // before root_label() is set
   _root = new Fl_Tree_Item(this);
   _root->parent(0);                             // we are root of tree
   _root->label("ROOT");
@@ -85,6 +86,9 @@ Fl_Tree::Fl_Tree(int X, int Y, int W, int H, const char *L) : Fl_Group(X,Y,W,H,L
   _scrollbar_size  = 0;                         // 0: uses Fl::scrollbar_size()
 
   _lastselect       = 0;
+  _populate_cb      = 0;
+  _populate_data    = 0;
+  _release_closed   = 0;
 
   box(FL_DOWN_BOX);
   color(FL_BACKGROUND2_COLOR, FL_SELECTION_COLOR);
@@ -1385,29 +1389,58 @@ Fl_Tree_Item *Fl_Tree::next_item(Fl_Tree_Item *item, int dir, bool visible) {
  \version 1.3.3
 */
 Fl_Tree_Item *Fl_Tree::next_selected_item(Fl_Tree_Item *item, int dir) {
+  // Subtrees without selected items (Fl_Tree_Item::selected_count()==0) are skipped,
+  // so walking the selection costs about the number of selected items, not tree size.
   switch (dir) {
     case FL_Down:
-      if ( ! item ) {
-        if ( ! (item = first()) ) return(0);
-        if ( item->is_selected() ) return(item);
+      if ( ! item ) return(first_selected_below(_root));
+      for ( int t=0; t<item->children(); t++ )          // below item?
+        if ( item->child(t)->selected_count() )
+          return(first_selected_below(item->child(t)));
+      for ( ; item; item = item->parent() ) {           // after item or its parents?
+        for ( Fl_Tree_Item *s = item->next_sibling(); s; s = s->next_sibling() )
+          if ( s->selected_count() )
+            return(first_selected_below(s));
       }
-      while ( (item = item->next()) )
-        if ( item->is_selected() )
-          return(item);
       return(0);
     case FL_Up:
-      if ( ! item ) {
-        if ( ! (item = last()) ) return(0);
-        if ( item->is_selected() ) return(item);
+      if ( ! item ) return(last_selected_below(_root));
+      for ( ; item; item = item->parent() ) {           // before item or its parents?
+        for ( Fl_Tree_Item *s = item->prev_sibling(); s; s = s->prev_sibling() )
+          if ( s->selected_count() )
+            return(last_selected_below(s));
+        if ( item->parent() && item->parent()->is_selected() )
+          return(item->parent());
       }
-      while ( (item = item->prev()) )
-        if ( item->is_selected() )
-          return(item);
       return(0);
   }
   return(0);
 }
 
+// INTERNAL: Return the first selected item in 'item' and its descendants
+Fl_Tree_Item *Fl_Tree::first_selected_below(Fl_Tree_Item *item) {
+  while ( item && item->selected_count() ) {
+    if ( item->is_selected() ) return(item);
+    Fl_Tree_Item *next = 0;
+    for ( int t=0; t<item->children() && !next; t++ )
+      if ( item->child(t)->selected_count() ) next = item->child(t);
+    item = next;
+  }
+  return(0);
+}
+
+// INTERNAL: Return the last selected item in 'item' and its descendants
+Fl_Tree_Item *Fl_Tree::last_selected_below(Fl_Tree_Item *item) {
+  while ( item && item->selected_count() ) {
+    Fl_Tree_Item *next = 0;
+    for ( int t=item->children()-1; t>=0 && !next; t-- )
+      if ( item->child(t)->selected_count() ) next = item->child(t);
+    if ( !next ) return(item->is_selected() ? item : 0);
+    item = next;
+  }
+  return(0);
+}
+
 /**
  Returns the currently selected items as an array of \p 'ret_items'.
 
@@ -1469,6 +1502,65 @@ int Fl_Tree::open(Fl_Tree_Item *item, int docallback) {
   return(1);
 }
 
+/// Set the function that adds the children of lazy items.
+///
+/// \p cb is called with \p populate = 1 the first time a lazy item is
+/// opened (see Fl_Tree_Item::lazy()), and again after its children were
+/// released. It should add the item's children, e.g. with
+/// add(Fl_Tree_Item*, const char*), and mark children that can have
+/// children of their own as lazy.
+///
+/// When release_closed() is enabled, \p cb is called with \p populate = 0
+/// before the children of a closed lazy item are deleted, so that the
+/// application can free data attached to them with Fl_Tree_Item::user_data().
+///
+/// \param[in] cb   The function, or NULL to not populate lazy items
+/// \param[in] data Passed to \p cb as its last argument
+/// \see release_closed(int)
+/// \version 1.4.0
+///
+void Fl_Tree::populate_callback(Fl_Tree_Populate_Callback *cb, void *data) {
+  _populate_cb   = cb;
+  _populate_data = data;
+}
+
+/// Set whether the children of lazy items are deleted when the items are closed.
+///
+/// This keeps memory use proportional to the parts of a large hierarchy
+/// that are open. Released items are lost with their selection state and
+/// widgets; the populate callback adds them again when the item is reopened.
+/// Default is off.
+///
+/// \see populate_callback(Fl_Tree_Populate_Callback*, void*), Fl_Tree_Item::lazy()
+/// \version 1.4.0
+///
+void Fl_Tree::release_closed(int val) {
+  _release_closed = val;
+}
+
+// INTERNAL: Add the children of a lazy item that is about to be opened
+void Fl_Tree::populate_item(Fl_Tree_Item *item) {
+  if ( _populate_cb ) _populate_cb(this, item, 1, _populate_data);
+  redraw();
+}
+
+// INTERNAL: See if 'item' is a descendant of 'parent'
+static int is_below(const Fl_Tree_Item *item, const Fl_Tree_Item *parent) {
+  for ( item = item ? item->parent() : 0; item; item = item->parent() )
+    if ( item == parent ) return(1);
+  return(0);
+}
+
+// INTERNAL: Delete the children of a lazy item that was closed
+void Fl_Tree::release_item(Fl_Tree_Item *item) {
+  if ( _populate_cb ) _populate_cb(this, item, 0, _populate_data);
+  // forget items that are about to be deleted (~Fl_Tree_Item handles _item_focus)
+  if ( is_below(_lastselect, item) ) _lastselect = 0;
+  if ( is_below(_callback_item, item) ) _callback_item = 0;
+  item->clear_children();
+  redraw();
+}
+
 /// Opens the item specified by \p 'path'.
 ///
 /// This causes the item's children (if any) to be shown.<br>
@@ -1815,6 +1907,7 @@ int Fl_Tree::deselect(const char *path, int docallback) {
 int Fl_Tree::deselect_all(Fl_Tree_Item *item, int docallback) {
   item = item ? item : first();                 // NULL? use first()
   if ( ! item ) return(0);
+  if ( ! item->selected_count() ) return(0);    // nothing selected below item
   int count = 0;
   // Deselect item
   if ( item->is_selected() )
@@ -1852,12 +1945,10 @@ int Fl_Tree::select_only(Fl_Tree_Item *selitem, int docallback) {
   // Deselect everything first.
   //    Prevents callbacks from seeing more than one item selected.
   //
-  for ( Fl_Tree_Item *item = first(); item; item = item->next() ) {
+  for ( Fl_Tree_Item *item = first_selected_item(); item; item = next_selected_item(item) ) {
     if ( item == selitem ) continue;            // don't do anything to selitem yet..
-    if ( item->is_selected() ) {
-      deselect(item, docallback);
-      ++changed;
-    }
+    deselect(item, docallback);
+    ++changed;
   }
   // Should we 'reselect' item if already selected?
   if ( selitem->is_selected() && (item_reselect_mode()==FL_TREE_SELECTABLE_ALWAYS) ) {
@@ -2001,6 +2092,19 @@ void Fl_Tree::item_labelbgcolor(Fl_Color val) {
   _prefs.labelbgcolor(val);
 }
 
+/// Set whether items with equal labels share one copy of the label text.
+///
+/// Trees with many repeated labels (e.g. file names, record types) can
+/// save most of the memory used for labels. Each distinct label costs a
+/// few bytes more than an unshared copy, so this is off by default.
+/// Affects labels set after this call.
+///
+/// \version 1.4.0
+///
+void Fl_Tree::intern_labels(int val) {
+  _intern_labels = val;
+}
+
 /// Get the connector color used for tree connection lines.
 Fl_Color Fl_Tree::connectorcolor() const {
   return(_prefs.connectorcolor());
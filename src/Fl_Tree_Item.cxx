@@ -35,6 +35,155 @@ static int event_inside(const int xywh[4]) {
   return(Fl::event_inside(xywh[0],xywh[1],xywh[2],xywh[3]));
 }
 
+// Label styles
+//
+//    The label font, size and colors of all items are kept in one table
+//    of unique styles. Each item stores the index of its style, so a tree
+//    with millions of items in a few styles needs only a few records.
+//    The table is never shrunk; it only grows when new combinations are used.
+//
+struct Fl_Tree_Item_Style {
+  Fl_Font     font;
+  Fl_Fontsize size;
+  Fl_Color    fgcolor;
+  Fl_Color    bgcolor;
+};
+
+static Fl_Tree_Item_Style *style_table = 0;     // unique styles
+static unsigned int        style_count = 0;     // #styles used
+static unsigned int        style_alloc = 0;     // #styles allocated
+static unsigned int       *style_hash  = 0;     // style index+1 by hash (0=empty)
+static unsigned int        style_hsize = 0;     // size of style_hash (power of 2)
+
+static unsigned int hash_style(const Fl_Tree_Item_Style &s) {
+  unsigned int h = (unsigned int)s.font * 0x9e3779b1u;
+  h = (h ^ (unsigned int)s.size)    * 0x85ebca6bu;
+  h = (h ^ (unsigned int)s.fgcolor) * 0xc2b2ae35u;
+  h = (h ^ (unsigned int)s.bgcolor) * 0x27d4eb2fu;
+  return(h ^ (h >> 15));
+}
+
+static void rehash_styles(unsigned int hsize) {
+  free(style_hash);
+  style_hash  = (unsigned int*)calloc(hsize, sizeof(unsigned int));
+  style_hsize = hsize;
+  for ( unsigned int i=0; i<style_count; i++ ) {
+    unsigned int h = hash_style(style_table[i]) & (hsize-1);
+    while ( style_hash[h] ) h = (h+1) & (hsize-1);
+    style_hash[h] = i+1;
+  }
+}
+
+// Return the index of the style record for the given attributes,
+// adding a record if this combination is new.
+//
+static unsigned int find_style(Fl_Font font, Fl_Fontsize size, Fl_Color fg, Fl_Color bg) {
+  Fl_Tree_Item_Style s;
+  s.font = font; s.size = size; s.fgcolor = fg; s.bgcolor = bg;
+  if ( style_hsize ) {
+    unsigned int h = hash_style(s) & (style_hsize-1);
+    for ( ; style_hash[h]; h = (h+1) & (style_hsize-1) ) {
+      const Fl_Tree_Item_Style &t = style_table[style_hash[h]-1];
+      if ( t.font == font && t.size == size && t.fgcolor == fg && t.bgcolor == bg )
+        return(style_hash[h]-1);
+    }
+  }
+  if ( style_count == style_alloc ) {
+    style_alloc = style_alloc ? style_alloc*2 : 16;
+    style_table = (Fl_Tree_Item_Style*)realloc((void*)style_table,
+                                               style_alloc*sizeof(Fl_Tree_Item_Style));
+  }
+  style_table[style_count++] = s;
+  if ( style_count*2 > style_hsize ) {          // keep hash at most half full
+    rehash_styles(style_hsize ? style_hsize*2 : 32);
+  } else {
+    unsigned int h = hash_style(s) & (style_hsize-1);
+    while ( style_hash[h] ) h = (h+1) & (style_hsize-1);
+    style_hash[h] = style_count;
+  }
+  return(style_count-1);
+}
+
+// Interned labels
+//
+//    With Fl_Tree::intern_labels() enabled, items with equal labels share
+//    one reference counted copy of the text. The text follows the header.
+//
+struct Fl_Tree_Label_Entry {
+  Fl_Tree_Label_Entry *next;                    // next entry in hash chain
+  unsigned int refs;                            // #items using this label
+  unsigned int hash;                            // hash of the text
+};
+
+static Fl_Tree_Label_Entry **label_hash  = 0;   // chains of entries
+static unsigned int          label_hsize = 0;   // size of label_hash (power of 2)
+static unsigned int          label_count = 0;   // #entries
+
+static unsigned int hash_label(const char *s) {
+  unsigned int h = 2166136261u;                 // FNV-1a
+  for ( ; *s; s++ ) h = (h ^ (unsigned char)*s) * 16777619u;
+  return(h);
+}
+
+static const char *entry_text(const Fl_Tree_Label_Entry *e) {
+  return((const char*)(e+1));
+}
+
+static Fl_Tree_Label_Entry *text_entry(const char *text) {
+  return((Fl_Tree_Label_Entry*)text - 1);
+}
+
+static const char *intern_label(const char *s) {
+  unsigned int h = hash_label(s);
+  if ( label_hsize ) {
+    for ( Fl_Tree_Label_Entry *e = label_hash[h & (label_hsize-1)]; e; e = e->next ) {
+      if ( e->hash == h && strcmp(entry_text(e), s) == 0 ) {
+        e->refs++;
+        return(entry_text(e));
+      }
+    }
+  }
+  if ( label_count >= label_hsize ) {           // grow table, rehash chains
+    unsigned int nsize = label_hsize ? label_hsize*2 : 256;
+    Fl_Tree_Label_Entry **nhash = (Fl_Tree_Label_Entry**)calloc(nsize, sizeof(Fl_Tree_Label_Entry*));
+    for ( unsigned int i=0; i<label_hsize; i++ ) {
+      while ( label_hash[i] ) {
+        Fl_Tree_Label_Entry *e = label_hash[i];
+        label_hash[i] = e->next;
+        e->next = nhash[e->hash & (nsize-1)];
+        nhash[e->hash & (nsize-1)] = e;
+      }
+    }
+    free(label_hash);
+    label_hash  = nhash;
+    label_hsize = nsize;
+  }
+  size_t len = strlen(s);
+  Fl_Tree_Label_Entry *e = (Fl_Tree_Label_Entry*)malloc(sizeof(Fl_Tree_Label_Entry) + len + 1);
+  e->refs = 1;
+  e->hash = h;
+  memcpy((char*)(e+1), s, len+1);
+  e->next = label_hash[h & (label_hsize-1)];
+  label_hash[h & (label_hsize-1)] = e;
+  label_count++;
+  return(entry_text(e));
+}
+
+static const char *share_label(const char *text) {
+  text_entry(text)->refs++;
+  return(text);
+}
+
+static void release_label(const char *text) {
+  Fl_Tree_Label_Entry *e = text_entry(text);
+  if ( --e->refs ) return;
+  Fl_Tree_Label_Entry **pe = &label_hash[e->hash & (label_hsize-1)];
+  while ( *pe != e ) pe = &(*pe)->next;
+  *pe = e->next;
+  label_count--;
+  free((void*)e);
+}
+
 /// Constructor.
 /// Makes a new instance of Fl_Tree_Item using defaults from \p 'prefs'.
 /// \deprecated in 1.3.3 ABI -- you must use Fl_Tree_Item(Fl_Tree*) for proper horizontal scrollbar behavior.
@@ -49,26 +198,15 @@ Fl_Tree_Item::Fl_Tree_Item(const Fl_Tree_Prefs &prefs) {
 void Fl_Tree_Item::_Init(const Fl_Tree_Prefs &prefs, Fl_Tree *tree) {
   _tree         = tree;
   _label        = 0;
-  _labelfont    = prefs.labelfont();
-  _labelsize    = prefs.labelsize();
-  _labelfgcolor = prefs.labelfgcolor();
-  _labelbgcolor = prefs.labelbgcolor();
-  _widget       = 0;
+  _style        = find_style(prefs.labelfont(), prefs.labelsize(),
+                             prefs.labelfgcolor(), prefs.labelbgcolor());
   _flags        = OPEN|VISIBLE|ACTIVE;
+  _selcount     = 0;
   _xywh[0]      = 0;
   _xywh[1]      = 0;
   _xywh[2]      = 0;
   _xywh[3]      = 0;
-  _collapse_xywh[0] = 0;
-  _collapse_xywh[1] = 0;
-  _collapse_xywh[2] = 0;
-  _collapse_xywh[3] = 0;
-  _label_xywh[0]    = 0;
-  _label_xywh[1]    = 0;
-  _label_xywh[2]    = 0;
-  _label_xywh[3]    = 0;
-  _usericon         = 0;
-  _userdeicon       = 0;
+  _extra            = 0;
   _userdata         = 0;
   _parent           = 0;
   _children.manage_item_destroy(1);     // let array's dtor manage destroying Fl_Tree_Items
@@ -90,13 +228,9 @@ Fl_Tree_Item::Fl_Tree_Item(Fl_Tree *tree) {
 
 // DTOR
 Fl_Tree_Item::~Fl_Tree_Item() {
-  if ( _label ) {
-    free((void*)_label);
-    _label = 0;
-  }
-  _widget = 0;                  // Fl_Group will handle destruction
-  _usericon = 0;                // user handled allocation
-  _userdeicon = 0;              // user handled allocation
+  free_label();
+  delete _extra;                // widget: Fl_Group will handle destruction
+  _extra = 0;                   // icons: user handled allocation
   // focus item? set to null
   if ( _tree && this == _tree->_item_focus )
     { _tree->_item_focus = 0; }
@@ -106,32 +240,58 @@ Fl_Tree_Item::~Fl_Tree_Item() {
 /// Copy constructor.
 Fl_Tree_Item::Fl_Tree_Item(const Fl_Tree_Item *o) {
   _tree             = o->_tree;
-  _label        = o->label() ? fl_strdup(o->label()) : 0;
-  _labelfont    = o->labelfont();
-  _labelsize    = o->labelsize();
-  _labelfgcolor = o->labelfgcolor();
-  _labelbgcolor = o->labelbgcolor();
-  _widget       = o->widget();
   _flags        = o->_flags;
+  if ( !o->_label ) {
+    _label      = 0;
+  } else if ( o->is_flag(INTERNED) ) {
+    _label      = share_label(o->_label);       // share interned label
+  } else {
+    _label      = fl_strdup(o->_label);
+  }
+  _style        = o->_style;
+  _selcount     = is_flag(SELECTED);    // children are not copied
   _xywh[0]      = o->_xywh[0];
   _xywh[1]      = o->_xywh[1];
   _xywh[2]      = o->_xywh[2];
   _xywh[3]      = o->_xywh[3];
-  _collapse_xywh[0] = o->_collapse_xywh[0];
-  _collapse_xywh[1] = o->_collapse_xywh[1];
-  _collapse_xywh[2] = o->_collapse_xywh[2];
-  _collapse_xywh[3] = o->_collapse_xywh[3];
-  _label_xywh[0]    = o->_label_xywh[0];
-  _label_xywh[1]    = o->_label_xywh[1];
-  _label_xywh[2]    = o->_label_xywh[2];
-  _label_xywh[3]    = o->_label_xywh[3];
-  _usericon         = o->usericon();
+  _extra            = o->_extra ? new Extra(*o->_extra) : 0;
   _userdata         = o->user_data();
   _parent           = o->_parent;
   _prev_sibling     = 0;                // do not copy ptrs! use update_prev_next()
   _next_sibling     = 0;                // do not copy ptrs! use update_prev_next()
 }
 
+// INTERNAL: Return the item's widget and icons, allocating them if needed.
+Fl_Tree_Item::Extra *Fl_Tree_Item::extra() {
+  if ( !_extra ) {
+    _extra = new Extra;
+    _extra->widget     = 0;
+    _extra->usericon   = 0;
+    _extra->userdeicon = 0;
+  }
+  return(_extra);
+}
+
+// INTERNAL: Add 'delta' to the selection count of this item and its parents.
+//    Each item counts the selected items in its subtree, so that
+//    searches for selected items can skip subtrees without any.
+//
+void Fl_Tree_Item::add_selcount(int delta) {
+  if ( !delta ) return;
+  for ( Fl_Tree_Item *p = this; p; p = p->_parent )
+    p->_selcount += delta;
+}
+
+// INTERNAL: Free the item's label, whether interned or not.
+void Fl_Tree_Item::free_label() {
+  if ( _label ) {
+    if ( is_flag(INTERNED) ) release_label(_label);
+    else free((void*)_label);
+    _label = 0;
+  }
+  _flags &= ~INTERNED;
+}
+
 /// Print the tree as 'ascii art' to stdout.
 /// Used mainly for debugging.
 ///
@@ -155,9 +315,19 @@ void Fl_Tree_Item::show_self(const char *indent) const {
 /// Set the label to \p 'name'.
 /// Makes and manages an internal copy of \p 'name'.
 ///
+/// If the tree's intern_labels() option is enabled, the copy is
+/// shared with all other items that have the same label.
+/// \see Fl_Tree::intern_labels(int)
+///
 void Fl_Tree_Item::label(const char *name) {
-  if ( _label ) { free((void*)_label); _label = 0; }
-  _label = name ? fl_strdup(name) : 0;
+  if ( name && _label && name == _label ) return;       // same text, e.g. label(label())
+  free_label();
+  if ( name && _tree && _tree->intern_labels() ) {
+    _label = intern_label(name);
+    _flags |= INTERNED;
+  } else {
+    _label = name ? fl_strdup(name) : 0;
+  }
   recalc_tree();                // may change label geometry
 }
 
@@ -166,6 +336,56 @@ const char *Fl_Tree_Item::label() const {
   return(_label);
 }
 
+/// Set item's label font face.
+void Fl_Tree_Item::labelfont(Fl_Font val) {
+  const Fl_Tree_Item_Style &s = style_table[_style];
+  _style = find_style(val, s.size, s.fgcolor, s.bgcolor);
+  recalc_tree();              // may change tree geometry
+}
+
+/// Get item's label font face.
+Fl_Font Fl_Tree_Item::labelfont() const {
+  return(style_table[_style].font);
+}
+
+/// Set item's label font size.
+void Fl_Tree_Item::labelsize(Fl_Fontsize val) {
+  const Fl_Tree_Item_Style &s = style_table[_style];
+  _style = find_style(s.font, val, s.fgcolor, s.bgcolor);
+  recalc_tree();              // may change tree geometry
+}
+
+/// Get item's label font size.
+Fl_Fontsize Fl_Tree_Item::labelsize() const {
+  return(style_table[_style].size);
+}
+
+/// Set item's label foreground text color.
+void Fl_Tree_Item::labelfgcolor(Fl_Color val) {
+  const Fl_Tree_Item_Style &s = style_table[_style];
+  _style = find_style(s.font, s.size, val, s.bgcolor);
+}
+
+/// Return item's label foreground text color.
+Fl_Color Fl_Tree_Item::labelfgcolor() const {
+  return(style_table[_style].fgcolor);
+}
+
+/// Set item's label background color.
+/// A special case is made for color 0xffffffff which uses the parent tree's bg color.
+void Fl_Tree_Item::labelbgcolor(Fl_Color val) {
+  const Fl_Tree_Item_Style &s = style_table[_style];
+  _style = find_style(s.font, s.size, s.fgcolor, val);
+}
+
+/// Return item's label background text color.
+/// If the color is 0xffffffff, the default behavior is the parent tree's
+/// bg color will be used. (An overloaded draw_item_content() can override
+/// this behavior.)
+Fl_Color Fl_Tree_Item::labelbgcolor() const {
+  return(style_table[_style].bgcolor);
+}
+
 /// Return const child item for the specified 'index'.
 const Fl_Tree_Item *Fl_Tree_Item::child(int index) const {
   return(_children[index]);
@@ -173,6 +393,7 @@ const Fl_Tree_Item *Fl_Tree_Item::child(int index) const {
 
 /// Clear all the children for this item.
 void Fl_Tree_Item::clear_children() {
+  add_selcount(is_flag(SELECTED) - _selcount);  // forget selected descendants
   _children.clear();
   recalc_tree();                // may change tree geometry
 }
@@ -308,6 +529,7 @@ Fl_Tree_Item *Fl_Tree_Item::add(const Fl_Tree_Prefs &prefs,
     { item = new Fl_Tree_Item(_tree); item->label(new_label); }
   recalc_tree();                // may change tree geometry
   item->_parent = this;
+  add_selcount(item->_selcount);
   switch ( prefs.sortorder() ) {
     case FL_TREE_SORT_NONE: {
       _children.add(item);
@@ -441,6 +663,7 @@ Fl_Tree_Item *Fl_Tree_Item::insert_above(const Fl_Tree_Prefs &prefs, const char
 Fl_Tree_Item* Fl_Tree_Item::deparent(int pos) {
   Fl_Tree_Item *orphan = _children[pos];
   if ( _children.deparent(pos) < 0 ) return NULL;
+  add_selcount(-orphan->_selcount);
   return orphan;
 }
 
@@ -456,6 +679,7 @@ int Fl_Tree_Item::reparent(Fl_Tree_Item *newchild, int pos) {
   int ret;
   if ( (ret = _children.reparent(newchild, this, pos)) < 0 ) return ret;
   newchild->parent(this);               // take custody
+  add_selcount(newchild->_selcount);
   return 0;
 }
 
@@ -631,6 +855,7 @@ Fl_Tree_Item *Fl_Tree_Item::replace_child(Fl_Tree_Item *olditem,
   int pos = find_child(olditem);        // find our index for olditem
   if ( pos == -1 ) return(NULL);
   newitem->_parent = this;
+  add_selcount(newitem->_selcount - olditem->_selcount);
   // replace in array (handles stitching neighboring items)
   _children.replace(pos, newitem);
   recalc_tree();                        // newitem may have changed tree geometry
@@ -644,6 +869,7 @@ int Fl_Tree_Item::remove_child(Fl_Tree_Item *item) {
   for ( int t=0; t<children(); t++ ) {
     if ( child(t) == item ) {
       item->clear_children();
+      add_selcount(-item->_selcount);
       _children.remove(t);
       recalc_tree();            // may change tree geometry
       return(0);
@@ -663,6 +889,7 @@ int Fl_Tree_Item::remove_child(const char *name) {
   for ( int t=0; t<children(); t++ ) {
     if ( child(t)->label() ) {
       if ( strcmp(child(t)->label(), name) == 0 ) {
+        add_selcount(-child(t)->_selcount);
         _children.remove(t);
         recalc_tree();          // may change tree geometry
         return(0);
@@ -813,15 +1040,16 @@ int Fl_Tree_Item::calc_item_height(const Fl_Tree_Prefs &prefs) const {
   if ( ! is_visible() ) return(0);
   int H = 0;
   if ( _label ) {
-    fl_font(_labelfont, _labelsize);    // fl_descent() needs this :/
-    H = _labelsize + fl_descent() + 1;  // at least one pixel space below descender
+    const Fl_Tree_Item_Style &s = style_table[_style];
+    fl_font(s.font, s.size);            // fl_descent() needs this :/
+    H = s.size + fl_descent() + 1;      // at least one pixel space below descender
   }
   if ( widget() &&
        (prefs.item_draw_mode() & FL_TREE_ITEM_HEIGHT_FROM_WIDGET) &&
        H < widget()->h()) {
     H = widget()->h();
   }
-  if ( has_children() && H < prefs.openicon_h() )
+  if ( can_open() && H < prefs.openicon_h() )
     H = prefs.openicon_h();
   if ( usericon() && H<usericon()->h() )
     H = usericon()->h();
@@ -835,9 +1063,10 @@ int Fl_Tree_Item::calc_item_height(const Fl_Tree_Prefs &prefs) const {
 /// \version 1.3.3 ABI ABI
 ///
 Fl_Color Fl_Tree_Item::drawfgcolor() const {
-  return is_selected() ? fl_contrast(_labelfgcolor, tree()->selection_color())
-                       : (is_active() && tree()->active_r()) ? _labelfgcolor
-                                                             : fl_inactive(_labelfgcolor);
+  Fl_Color fg = style_table[_style].fgcolor;
+  return is_selected() ? fl_contrast(fg, tree()->selection_color())
+                       : (is_active() && tree()->active_r()) ? fg
+                                                             : fl_inactive(fg);
 }
 
 /// Returns the recommended background color used for drawing this item.
@@ -846,10 +1075,11 @@ Fl_Color Fl_Tree_Item::drawfgcolor() const {
 ///
 Fl_Color Fl_Tree_Item::drawbgcolor() const {
   const Fl_Color unspecified = 0xffffffff;
+  Fl_Color bg = style_table[_style].bgcolor;
   return is_selected() ? is_active() && tree()->active_r() ? tree()->selection_color()
                                                            : fl_inactive(tree()->selection_color())
-                       : _labelbgcolor == unspecified ? tree()->color()
-                                                      : _labelbgcolor;
+                       : bg == unspecified ? tree()->color()
+                                            : bg;
 }
 
 /// Draw the item content
@@ -939,12 +1169,13 @@ int Fl_Tree_Item::draw_item_content(int render) {
   if ( _label &&
        ( !widget() ||
          (prefs.item_draw_mode() & FL_TREE_ITEM_DRAW_LABEL_AND_WIDGET) ) ) {
+    const Fl_Tree_Item_Style &s = style_table[_style];
     if ( render ) {
       fl_color(fg);
-      fl_font(_labelfont, _labelsize);
+      fl_font(s.font, s.size);
     }
     int lx = label_x()+(_label ? prefs.labelmarginleft() : 0);
-    int ly = label_y()+(label_h()/2)+(_labelsize/2)-fl_descent()/2;
+    int ly = label_y()+(label_h()/2)+(s.size/2)-fl_descent()/2;
     int lw=0, lh=0;
     fl_measure(_label, lw, lh);         // get box around text (including white space)
     if ( render ) fl_draw(_label, lx, ly);
@@ -985,18 +1216,13 @@ void Fl_Tree_Item::draw(int X, int &Y, int W, Fl_Tree_Item *itemfocus,
   _xywh[2] = W;
   _xywh[3] = H;
 
-  // Determine collapse icon's xywh
-  //   Note: calculate collapse icon's xywh for possible mouse click detection.
-  //   We don't care about items clipped off the viewport; they won't get mouse events.
+  // Collapse icon's xywh
+  //   Not stored: event_on_collapse_icon() computes it again from the item's xywh.
   //
   int item_y_center = (Y+(H/2))|1;      // |1: force alignment w/dot pattern
-  _collapse_xywh[2] = prefs.openicon_w();
-  int &icon_w = _collapse_xywh[2];
-  _collapse_xywh[0] = X + (icon_w + prefs.connectorwidth())/2 - 3;
-  int &icon_x = _collapse_xywh[0];
-  _collapse_xywh[1] = item_y_center - prefs.openicon_h()/2;
-  int &icon_y = _collapse_xywh[1];
-  _collapse_xywh[3] = prefs.openicon_h();
+  int icon_w = prefs.openicon_w();
+  int icon_x = X + (icon_w + prefs.connectorwidth())/2 - 3;
+  int icon_y = item_y_center - prefs.openicon_h()/2;
 
   // Horizontal connector values
   //   Must calculate these even if(clipped) because 'draw children' code (below)
@@ -1005,20 +1231,10 @@ void Fl_Tree_Item::draw(int X, int &Y, int W, Fl_Tree_Item *itemfocus,
   int hconn_x  = X+icon_w/2-1;
   int hconn_x2 = hconn_x + prefs.connectorwidth();
   int hconn_x_center = X + icon_w + ((hconn_x2 - (X + icon_w)) / 2);
-  int cw1 = icon_w+prefs.connectorwidth()/2, cw2 = prefs.connectorwidth();
-  int conn_w = cw1>cw2 ? cw1 : cw2;
 
   // Usericon position
-  int uicon_x = X+(icon_w/2-1+conn_w) + ( (usericon() || prefs.usericon())
-                                          ? prefs.usericonmarginleft() : 0);
-  int uicon_w = usericon() ? usericon()->w()
-                           : prefs.usericon() ? prefs.usericon()->w() : 0;
-
-  // Label xywh
-  _label_xywh[0] = uicon_x + uicon_w + prefs.labelmarginleft();
-  _label_xywh[1] = Y;
-  _label_xywh[2] = tree()->_tix + tree()->_tiw - _label_xywh[0];
-  _label_xywh[3] = H;
+  int uicon_x = usericon_x(prefs);
+  int uicon_w = usericon_w(prefs);
 
   // Begin calc of this item's max width..
   //     It might not even be visible, so start at zero.
@@ -1038,7 +1254,7 @@ void Fl_Tree_Item::draw(int X, int &Y, int W, Fl_Tree_Item *itemfocus,
              ? widget()->h() : H;
     if ( _label &&
          (prefs.item_draw_mode() & FL_TREE_ITEM_DRAW_LABEL_AND_WIDGET) ) {
-      fl_font(_labelfont, _labelsize);  // fldescent() needs this
+      fl_font(labelfont(), labelsize());        // fldescent() needs this
       int lw=0, lh=0;
       fl_measure(_label,lw,lh);         // get box around text (including white space)
       wx += (lw + prefs.widgetmarginleft());
@@ -1075,7 +1291,7 @@ void Fl_Tree_Item::draw(int X, int &Y, int W, Fl_Tree_Item *itemfocus,
           }
         }
         // Draw collapse icon
-        if ( render && has_children() && prefs.showcollapse() ) {
+        if ( render && can_open() && prefs.showcollapse() ) {
           // Draw icon image
           if ( is_open() ) {
             if ( prefs.closeicon() ) {
@@ -1177,11 +1393,53 @@ void Fl_Tree_Item::draw(int X, int &Y, int W, Fl_Tree_Item *itemfocus,
 }
 
 
+// INTERNAL: Return the x position of the item's user icon.
+//    The item's geometry other than xywh() is not stored, but
+//    computed from xywh() and the tree's prefs when needed.
+//
+int Fl_Tree_Item::usericon_x(const Fl_Tree_Prefs &prefs) const {
+  int icon_w = prefs.openicon_w();
+  int cw1 = icon_w+prefs.connectorwidth()/2, cw2 = prefs.connectorwidth();
+  int conn_w = cw1>cw2 ? cw1 : cw2;
+  return(_xywh[0] + (icon_w/2-1+conn_w) + ( (usericon() || prefs.usericon())
+                                            ? prefs.usericonmarginleft() : 0));
+}
+
+// INTERNAL: Return the width of the item's user icon, or 0 if none.
+int Fl_Tree_Item::usericon_w(const Fl_Tree_Prefs &prefs) const {
+  return(usericon() ? usericon()->w()
+                    : prefs.usericon() ? prefs.usericon()->w() : 0);
+}
+
+// INTERNAL: Return the xywh of the item's collapse icon in \p xywh.
+void Fl_Tree_Item::collapse_xywh(const Fl_Tree_Prefs &prefs, int xywh[4]) const {
+  int item_y_center = (_xywh[1]+(_xywh[3]/2))|1;
+  xywh[0] = _xywh[0] + (prefs.openicon_w() + prefs.connectorwidth())/2 - 3;
+  xywh[1] = item_y_center - prefs.openicon_h()/2;
+  xywh[2] = prefs.openicon_w();
+  xywh[3] = prefs.openicon_h();
+}
+
+// Computed from xywh(), see usericon_x()
+int Fl_Tree_Item::label_x() const {
+  if ( !_tree ) return(_xywh[0]);
+  const Fl_Tree_Prefs &prefs = _tree->_prefs;
+  return(usericon_x(prefs) + usericon_w(prefs) + prefs.labelmarginleft());
+}
+
+// Computed from label_x() and the tree's inner width
+int Fl_Tree_Item::label_w() const {
+  if ( !_tree ) return(_xywh[2]);
+  return(_tree->_tix + _tree->_tiw - label_x());
+}
+
 /// Was the event on the 'collapse' button of this item?
 ///
 int Fl_Tree_Item::event_on_collapse_icon(const Fl_Tree_Prefs &prefs) const {
-  if ( is_visible() && is_active() && has_children() && prefs.showcollapse() ) {
-    return(event_inside(_collapse_xywh) ? 1 : 0);
+  if ( is_visible() && is_active() && can_open() && prefs.showcollapse() ) {
+    int xywh[4];
+    collapse_xywh(prefs, xywh);
+    return(event_inside(xywh) ? 1 : 0);
   } else {
     return(0);
   }
@@ -1195,7 +1453,7 @@ int Fl_Tree_Item::event_on_user_icon(const Fl_Tree_Prefs &prefs) const {
   if ( !is_visible() )  return 0;                       // item not visible? not us
   if ( !event_inside(_xywh) ) return 0;                 // not inside item? not us
   if ( event_on_collapse_icon(prefs) ) return 0;        // inside collapse icon? not us
-  if ( Fl::event_x() >= _label_xywh[0] ) return 0;      // inside label or beyond (e.g. widget())? not us
+  if ( Fl::event_x() >= label_x() ) return 0;           // inside label or beyond (e.g. widget())? not us
   // Is a user icon being shown?
   // TBD: Determining usericon xywh and 'if displayed' should be class methods used here and by draw_*()
   Fl_Image *ui = 0;
@@ -1207,7 +1465,7 @@ int Fl_Tree_Item::event_on_user_icon(const Fl_Tree_Prefs &prefs) const {
     else if ( prefs.userdeicon() ) ui = prefs.userdeicon(); // user deicon for tree?
   }
   if ( !ui ) return 0;                                  // no user icon? not us
-  int uix = _label_xywh[0]-ui->w();                     // find x position of usericon
+  int uix = label_x()-ui->w();                          // find x position of usericon
   if ( Fl::event_x() < uix ) return 0;                  // event left of usericon? not us
   return 1;                                             // must be inside usericon by elimination
 }
@@ -1222,7 +1480,7 @@ int Fl_Tree_Item::event_on_item(const Fl_Tree_Prefs &prefs) const {
 int Fl_Tree_Item::event_on_label(const Fl_Tree_Prefs &prefs) const {
   (void) prefs;       // quiet warnings unused params
   if ( is_visible() && is_active() ) {
-    return(event_inside(_label_xywh) ? 1 : 0);
+    return(Fl::event_inside(label_x(), label_y(), label_w(), label_h()) ? 1 : 0);
   } else {
     return(0);
   }
@@ -1232,7 +1490,7 @@ int Fl_Tree_Item::event_on_label(const Fl_Tree_Prefs &prefs) const {
 /// Used by open() to re-show widgets that were hidden by a previous close()
 ///
 void Fl_Tree_Item::show_widgets() {
-  if ( _widget ) _widget->show();
+  if ( widget() ) widget()->show();
   if ( is_open() ) {
     for ( int t=0; t<_children.total(); t++ ) {
       _children[t]->show_widgets();
@@ -1244,14 +1502,23 @@ void Fl_Tree_Item::show_widgets() {
 /// Used by close() to hide widgets.
 ///
 void Fl_Tree_Item::hide_widgets() {
-  if ( _widget ) _widget->hide();
+  if ( widget() ) widget()->hide();
   for ( int t=0; t<_children.total(); t++ ) {
     _children[t]->hide_widgets();
   }
 }
 
 /// Open this item and all its children.
+///
+/// If this is a lazy() item whose children have not been added yet,
+/// the tree's populate callback is called first to add them.
+/// \see Fl_Tree::populate_callback()
+///
 void Fl_Tree_Item::open() {
+  if ( is_flag(LAZY) && !is_flag(POPULATED) && _tree ) {
+    set_flag(POPULATED,1);      // set first: callback may open() this item
+    _tree->populate_item(this);
+  }
   set_flag(OPEN,1);
   // Tell children to show() their widgets
   for ( int t=0; t<_children.total(); t++ ) {
@@ -1261,12 +1528,37 @@ void Fl_Tree_Item::open() {
 }
 
 /// Close this item and all its children.
+///
+/// If this is a lazy() item and Fl_Tree::release_closed() is enabled,
+/// its children are deleted; they are added again when it is reopened.
+///
 void Fl_Tree_Item::close() {
   set_flag(OPEN,0);
   // Tell children to hide() their widgets
   for ( int t=0; t<_children.total(); t++ ) {
     _children[t]->hide_widgets();
   }
+  if ( is_flag(LAZY) && is_flag(POPULATED) && _tree && _tree->release_closed() ) {
+    _tree->release_item(this);
+    set_flag(POPULATED,0);
+  }
+  recalc_tree();                // may change tree geometry
+}
+
+/// Set whether this item's children are added only when it is opened.
+///
+/// A lazy item without children shows the open icon, and is closed by
+/// this method. When it is opened, the tree's populate callback is called
+/// to add its children.
+///
+/// \see Fl_Tree::populate_callback(), Fl_Tree::release_closed(), is_lazy()
+/// \version 1.4.0
+///
+void Fl_Tree_Item::lazy(int val) {
+  set_flag(LAZY, val);
+  if ( val && !has_children() && !is_flag(POPULATED) && is_flag(OPEN) ) {
+    set_flag(OPEN, 0);          // open() populates the item
+  }
   recalc_tree();                // may change tree geometry
 }
 
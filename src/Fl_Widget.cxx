@@ -18,9 +18,12 @@
 #include <FL/Fl_Widget.H>
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Tooltip.H>
+#include <FL/Fl_Widget_Profiler.H>
+#include <FL/Fl_Shortcut_Index.H>
 #include <FL/fl_draw.H>
 #include <FL/fl_string_functions.h>
 #include <stdlib.h>
+#include "Fl_Spatial_Index.H"
 #include "flstring.h"
 
 
@@ -137,6 +140,7 @@ Fl_Widget::Fl_Widget(int X, int Y, int W, int H, const char* L) {
 
 void Fl_Widget::resize(int X, int Y, int W, int H) {
   x_ = X; y_ = Y; w_ = W; h_ = H;
+  if (parent_ && parent_->spatial_) parent_->spatial_->moved(this);
 }
 
 // this is useful for parent widgets to call to resize children:
@@ -165,6 +169,8 @@ extern void fl_throw_focus(Fl_Widget*); // in Fl_x.cxx
 */
 Fl_Widget::~Fl_Widget() {
   Fl::clear_widget_pointer(this);
+  Fl_Widget_Profiler::widget_deleted(this);
+  Fl_Shortcut_Index::widget_deleted(this);
   if (flags() & COPIED_LABEL) free((void *)(label_.value));
   if (flags() & COPIED_TOOLTIP) free((void *)(tooltip_));
   image(NULL);
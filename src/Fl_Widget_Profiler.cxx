@@ -0,0 +1,344 @@
+//
+// Widget profiler for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/Fl_Widget_Profiler.H>
+#include <FL/Fl.H>
+#include <FL/Fl_Widget.H>
+#include <FL/fl_utf8.h>
+#include <FL/fl_string_functions.h>
+#include <FL/names.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool Fl_Widget_Profiler::enabled_ = false;
+int Fl_Widget_Profiler::count_ = 0;
+int Fl_Widget_Profiler::max_trace_events_ = 100000;
+int Fl_Widget_Profiler::trace_count_ = 0;
+int Fl_Widget_Profiler::trace_dropped_ = 0;
+
+typedef Fl_Widget_Profiler::Record Record;
+
+// all records, in order of first appearance
+static Record *records_ = NULL;
+static int alloc_ = 0;
+
+// open addressing hash table: widget address -> index in records_, or -1
+static int *table_ = NULL;
+static int table_size_ = 0; // a power of 2
+static int table_used_ = 0;
+
+// draw() and handle() calls in progress
+struct Frame {
+  int record;
+  Fl_Widget_Profiler::Kind kind;
+  int detail;
+  double start;       // seconds since origin_
+  double child_time;  // time spent in nested frames
+};
+static const int MAX_DEPTH = 256;
+static Frame stack_[MAX_DEPTH];
+static int depth_ = 0;    // may exceed MAX_DEPTH, deeper frames are not timed
+
+// completed frames, kept for write_trace()
+struct Trace_Event {
+  double start, duration;
+  int record;
+  unsigned char kind;
+  int detail;
+  int result;
+};
+static Trace_Event *trace_ = NULL;
+
+static Fl_Timestamp origin_;
+
+static double now() {
+  Fl_Timestamp t = Fl::now();
+  return Fl::seconds_between(t, origin_);
+}
+
+static unsigned hash(const Fl_Widget *w) {
+  fl_uintptr_t v = (fl_uintptr_t)w;
+  v ^= v >> 16;
+  return (unsigned)(v * 0x45d9f3bu);
+}
+
+static void rehash(int size) {
+  free(table_);
+  table_ = (int*)malloc(size * sizeof(int));
+  for (int i = 0; i < size; i++) table_[i] = -1;
+  table_size_ = size;
+  table_used_ = 0;
+  for (int r = 0; r < Fl_Widget_Profiler::records(); r++) {
+    if (!records_[r].widget) continue; // forget deleted widgets
+    unsigned h = hash(records_[r].widget) & (size - 1);
+    while (table_[h] >= 0) h = (h + 1) & (size - 1);
+    table_[h] = r;
+    table_used_++;
+  }
+}
+
+// Returns the slot of widget w, which holds -1 if w has no record yet
+static int *slot(const Fl_Widget *w) {
+  unsigned h = hash(w) & (table_size_ - 1);
+  while (table_[h] >= 0 && records_[table_[h]].widget != w) h = (h + 1) & (table_size_ - 1);
+  return table_ + h;
+}
+
+static int record_index(const Fl_Widget *w) {
+  if (2 * (table_used_ + 1) > table_size_) rehash(table_size_ ? 2 * table_size_ : 256);
+  int *s = slot(w);
+  if (*s >= 0) return *s;
+  int count = Fl_Widget_Profiler::records();
+  if (count >= alloc_) {
+    alloc_ = alloc_ ? 2 * alloc_ : 64;
+    records_ = (Record*)realloc(records_, alloc_ * sizeof(Record));
+  }
+  Record *r = records_ + count;
+  memset(r, 0, sizeof(Record));
+  r->widget = w;
+  r->label = w->label() ? fl_strdup(w->label()) : NULL;
+  r->type = w->type();
+  *s = count;
+  table_used_++;
+  return count;
+}
+
+
+/**
+  Starts or stops recording.
+  Data recorded earlier are kept; use reset() to discard them.
+*/
+void Fl_Widget_Profiler::enable(bool on) {
+  if (on && !enabled_ && !count_ && !trace_count_) origin_ = Fl::now();
+  enabled_ = on;
+  depth_ = 0;
+}
+
+
+/**
+  Discards all recorded data.
+  Trace event times restart from zero.
+*/
+void Fl_Widget_Profiler::reset() {
+  for (int i = 0; i < count_; i++) free(records_[i].label);
+  free(records_);
+  records_ = NULL;
+  alloc_ = count_ = 0;
+  free(table_);
+  table_ = NULL;
+  table_size_ = table_used_ = 0;
+  free(trace_);
+  trace_ = NULL;
+  trace_count_ = trace_dropped_ = 0;
+  depth_ = 0;
+  origin_ = Fl::now();
+}
+
+
+/** Returns the number of widgets that have a record. */
+int Fl_Widget_Profiler::records() {
+  return count_;
+}
+
+
+/** Returns record \p i, with 0 <= i < records(), or NULL. */
+const Fl_Widget_Profiler::Record *Fl_Widget_Profiler::record(int i) {
+  return (i >= 0 && i < count_) ? records_ + i : NULL;
+}
+
+
+/** Returns the record of widget \p w, or NULL if it has none. */
+const Fl_Widget_Profiler::Record *Fl_Widget_Profiler::find(const Fl_Widget *w) {
+  if (!w || !table_size_) return NULL;
+  int i = *slot(w);
+  return i >= 0 ? records_ + i : NULL;
+}
+
+
+/**
+  Sets the maximum number of trace events that are kept (default: 100000).
+  Each event uses about 32 bytes. Use 0 to keep no trace events.
+  Events already kept are discarded.
+*/
+void Fl_Widget_Profiler::max_trace_events(int n) {
+  free(trace_);
+  trace_ = NULL;
+  trace_count_ = trace_dropped_ = 0;
+  max_trace_events_ = n > 0 ? n : 0;
+}
+
+
+void Fl_Widget_Profiler::begin_(Kind k, const Fl_Widget *w, int detail) {
+  if (depth_ < MAX_DEPTH) {
+    // count_ must be updated before record_index() may call records()
+    int r = record_index(w);
+    if (r == count_) count_++;
+    Frame &f = stack_[depth_];
+    f.record = r;
+    f.kind = k;
+    f.detail = detail;
+    f.child_time = 0;
+    f.start = now();
+  }
+  depth_++;
+}
+
+
+void Fl_Widget_Profiler::end_(int result) {
+  if (depth_ <= 0) return; // enable() was called inside a timed call
+  depth_--;
+  if (depth_ >= MAX_DEPTH) return;
+  Frame &f = stack_[depth_];
+  double duration = now() - f.start;
+  if (depth_ > 0 && depth_ <= MAX_DEPTH) stack_[depth_ - 1].child_time += duration;
+  Record &r = records_[f.record];
+  if (f.kind == DRAW) {
+    r.draw_count++;
+    r.draw_time += duration;
+    r.draw_self_time += duration - f.child_time;
+    r.damage |= (unsigned char)f.detail;
+  } else {
+    r.handle_count++;
+    if (result) r.handled_count++;
+    r.handle_time += duration;
+    r.handle_self_time += duration - f.child_time;
+  }
+  if (trace_count_ < max_trace_events_) {
+    if (!trace_) trace_ = (Trace_Event*)malloc(max_trace_events_ * sizeof(Trace_Event));
+    Trace_Event &e = trace_[trace_count_++];
+    e.start = f.start;
+    e.duration = duration;
+    e.record = f.record;
+    e.kind = (unsigned char)f.kind;
+    e.detail = f.detail;
+    e.result = result;
+  } else {
+    trace_dropped_++;
+  }
+}
+
+
+void Fl_Widget_Profiler::damage_(const Fl_Widget *w, unsigned char) {
+  int r = record_index(w);
+  if (r == count_) count_++;
+  records_[r].redraw_count++;
+}
+
+
+void Fl_Widget_Profiler::widget_deleted_(const Fl_Widget *w) {
+  if (!table_size_) return;
+  int *s = slot(w);
+  if (*s < 0) return;
+  records_[*s].widget = NULL; // the slot stays used until the next rehash()
+}
+
+
+// Writes s as a JSON string
+static void write_string(FILE *f, const char *s) {
+  if (!s) { fputs("null", f); return; }
+  fputc('"', f);
+  for (; *s; s++) {
+    unsigned char c = (unsigned char)*s;
+    if (c == '"' || c == '\\') fprintf(f, "\\%c", c);
+    else if (c == '\n') fputs("\\n", f);
+    else if (c == '\t') fputs("\\t", f);
+    else if (c < 0x20) fprintf(f, "\\u%04x", c);
+    else fputc(c, f);
+  }
+  fputc('"', f);
+}
+
+
+static const char *event_name(int e) {
+  int n = (int)(sizeof(fl_eventnames) / sizeof(fl_eventnames[0]));
+  return (e >= 0 && e < n) ? fl_eventnames[e] : "?";
+}
+
+
+/**
+  Writes all records to a JSON file.
+  The file contains an array with one object per widget, sorted by
+  decreasing total draw and handle self time. Times are in microseconds.
+  \return 0 on success, -1 if the file can't be written.
+*/
+int Fl_Widget_Profiler::write_json(const char *filename) {
+  FILE *f = fl_fopen(filename, "w");
+  if (!f) return -1;
+  int *order = new int[count_ > 0 ? count_ : 1];
+  for (int i = 0; i < count_; i++) order[i] = i;
+  // insertion sort is good enough here, and keeps equal records in order
+  for (int i = 1; i < count_; i++) {
+    int k = order[i], j = i;
+    double t = records_[k].draw_self_time + records_[k].handle_self_time;
+    while (j > 0 && records_[order[j-1]].draw_self_time + records_[order[j-1]].handle_self_time < t) {
+      order[j] = order[j-1];
+      j--;
+    }
+    order[j] = k;
+  }
+  fputs("[\n", f);
+  for (int i = 0; i < count_; i++) {
+    Record &r = records_[order[i]];
+    fprintf(f, "  {\"id\": %d, \"widget\": ", order[i]);
+    if (r.widget) fprintf(f, "\"%p\"", (void*)r.widget);
+    else fputs("null", f);
+    fprintf(f, ", \"type\": %d, \"label\": ", r.type);
+    write_string(f, r.label);
+    fprintf(f, ",\n   \"draw_count\": %d, \"draw_us\": %.1f, \"draw_self_us\": %.1f, \"damage\": %d,\n",
+            r.draw_count, r.draw_time * 1e6, r.draw_self_time * 1e6, r.damage);
+    fprintf(f, "   \"handle_count\": %d, \"handled_count\": %d, \"handle_us\": %.1f, "
+            "\"handle_self_us\": %.1f, \"redraw_count\": %d}%s\n",
+            r.handle_count, r.handled_count, r.handle_time * 1e6, r.handle_self_time * 1e6,
+            r.redraw_count, i < count_ - 1 ? "," : "");
+  }
+  fputs("]\n", f);
+  delete[] order;
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+
+/**
+  Writes the kept trace events to a file in the Chrome trace event format.
+  Each draw() or handle() call is a complete ("X") event named after the
+  widget's label, with the damage bits or the event name as argument.
+  \return 0 on success, -1 if the file can't be written.
+*/
+int Fl_Widget_Profiler::write_trace(const char *filename) {
+  FILE *f = fl_fopen(filename, "w");
+  if (!f) return -1;
+  fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", f);
+  for (int i = 0; i < trace_count_; i++) {
+    Trace_Event &e = trace_[i];
+    Record &r = records_[e.record];
+    char name[80];
+    if (r.label && *r.label) snprintf(name, sizeof(name), "%.60s", r.label);
+    else snprintf(name, sizeof(name), "widget #%d", e.record);
+    fputs("{\"name\": ", f);
+    write_string(f, name);
+    fprintf(f, ", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1, ",
+            e.kind == DRAW ? "draw" : "handle", e.start * 1e6, e.duration * 1e6);
+    if (e.kind == DRAW)
+      fprintf(f, "\"args\": {\"id\": %d, \"damage\": %d}}", e.record, e.detail);
+    else
+      fprintf(f, "\"args\": {\"id\": %d, \"event\": \"%s\", \"result\": %d}}",
+              e.record, event_name(e.detail), e.result);
+    fputs(i < trace_count_ - 1 ? ",\n" : "\n", f);
+  }
+  fprintf(f, "], \"otherData\": {\"dropped_events\": %d}}\n", trace_dropped_);
+  return fclose(f) == 0 ? 0 : -1;
+}
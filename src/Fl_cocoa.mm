@@ -854,7 +854,7 @@ double Fl_Darwin_System_Driver::wait(double time_to_wait)
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
   if (fl_mac_os_version < 101100) NSDisableScreenUpdates(); // deprecated 10.11
-  Fl::flush();
+  Fl::flush_frame();
   if (fl_mac_os_version < 101100) NSEnableScreenUpdates(); // deprecated 10.11
 #pragma clang diagnostic pop
   if (Fl::idle) // 'idle' may have been set within flush()
@@ -460,7 +460,7 @@ double Fl_WinAPI_System_Driver::wait(double time_to_wait) {
     process_awake_handler_requests();
   }
 
-  Fl::flush();
+  Fl::flush_frame();
 
   // This should return 0 if only timer events were handled:
   return 1;
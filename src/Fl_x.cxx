@@ -206,6 +206,10 @@ static Atom fl_NET_WM_FULLSCREEN_MONITORS;
 Atom fl_NET_WORKAREA;
 static Atom fl_NET_WM_ICON;
 static Atom fl_NET_ACTIVE_WINDOW;
+static Atom fl_NET_WM_STATE_MODAL;
+static Atom fl_NET_WM_STATE_SKIP_TASKBAR;
+static Atom fl_NET_WM_WINDOW_TYPE;
+static Atom fl_NET_WM_WINDOW_TYPE_MENU;
 
 /*
   Debug: translate Atom (number) to name: enable (1) if used below
@@ -530,6 +534,92 @@ void Fl_X11_Screen_Driver::disable_im() {
   xim_deactivate();
 }
 
+// Startup timing, written to stderr when FLTK_STARTUP_TIMING is set
+
+static Fl_Timestamp startup_origin;
+static struct {
+  const char *phase;
+  double time;
+} startup_marks[8];
+static int startup_count = -1; // -1 when not timing
+
+static void startup_mark(const char *phase) {
+  if (startup_count < 0 || startup_count >= (int)(sizeof(startup_marks)/sizeof(startup_marks[0])))
+    return;
+  startup_marks[startup_count].phase = phase;
+  startup_marks[startup_count].time = Fl::seconds_since(startup_origin);
+  startup_count++;
+}
+
+static void startup_report() {
+  if (startup_count < 0) return;
+  fprintf(stderr, "FLTK startup timing (ms since opening the display):\n");
+  double prev = 0;
+  for (int i = 0; i < startup_count; i++) {
+    fprintf(stderr, "  %-28s %8.2f  (+%.2f)\n", startup_marks[i].phase,
+            startup_marks[i].time * 1000, (startup_marks[i].time - prev) * 1000);
+    prev = startup_marks[i].time;
+  }
+  startup_count = -1;
+}
+
+bool Fl_X11_Screen_Driver::deferred_setup_pending = false;
+
+static void clipboard_timeout(void *data);
+extern Fl_Window *fl_xfocus;
+
+// Queries that are not needed to map and draw the first window: they
+// are done once the first frame is drawn, when a clipboard change handler
+// is added, or when the mouse enters a window (XIM).
+void Fl_X11_Screen_Driver::deferred_setup() {
+  if (!deferred_setup_pending) return;
+  deferred_setup_pending = false;
+  if (startup_count >= 0) startup_mark("first frame");
+  Display *d = fl_display;
+
+  if (!xim_im) {
+    init_xim();
+    if (xim_ic && fl_xfocus && fl_xfocus->shown()) {
+      xim_activate(fl_xid(fl_xfocus));
+      XSetICFocus(xim_ic);
+    }
+  }
+
+#if HAVE_XFIXES
+  int error_base;
+  if (XFixesQueryExtension(fl_display, &xfixes_event_base, &error_base))
+    have_xfixes = true;
+  else
+    have_xfixes = false;
+  if (have_xfixes) {
+    // register the windows created so far for clipboard change notifications
+    for (Fl_X *x = Fl_X::first; x; x = x->next) {
+      if (x->w->parent()) continue;
+      XFixesSelectSelectionInput(d, x->xid, XA_PRIMARY, XFixesSetSelectionOwnerNotifyMask);
+      XFixesSelectSelectionInput(d, x->xid, CLIPBOARD, XFixesSetSelectionOwnerNotifyMask);
+    }
+    Fl::remove_timeout(clipboard_timeout);
+  }
+#endif
+
+#if USE_XRANDR
+  void *libxrandr_addr = Fl_Posix_System_Driver::dlopen_or_dlsym("libXrandr");
+  if (libxrandr_addr) {
+    int error_base;
+    typedef Bool (*XRRQueryExtension_type)(Display*, int*, int*);
+    typedef void (*XRRSelectInput_type)(Display*, Window, int);
+    XRRQueryExtension_type XRRQueryExtension_f = (XRRQueryExtension_type)dlsym(libxrandr_addr, "XRRQueryExtension");
+    XRRSelectInput_type XRRSelectInput_f = (XRRSelectInput_type)dlsym(libxrandr_addr, "XRRSelectInput");
+    XRRUpdateConfiguration_f = (XRRUpdateConfiguration_type)dlsym(libxrandr_addr, "XRRUpdateConfiguration");
+    if (XRRQueryExtension_f && XRRSelectInput_f && XRRQueryExtension_f(d, &randrEventBase, &error_base))
+      XRRSelectInput_f(d, RootWindow(d, fl_screen), RRScreenChangeNotifyMask);
+    else XRRUpdateConfiguration_f = NULL;
+    }
+#endif
+  startup_mark("deferred setup");
+  startup_report();
+}
+
 static void delayed_create_print_window(void *) {
   Fl::remove_check(delayed_create_print_window);
   fl_create_print_window();
@@ -539,6 +629,11 @@ void Fl_X11_Screen_Driver::open_display_platform() {
   static Display *d = NULL;
   if (d) return;
 
+  if (fl_getenv("FLTK_STARTUP_TIMING")) {
+    startup_origin = Fl::now();
+    startup_count = 0;
+  }
+
   setlocale(LC_CTYPE, "");
   XSetLocaleModifiers("");
 
@@ -550,6 +645,7 @@ void Fl_X11_Screen_Driver::open_display_platform() {
     Fl::fatal("Can't open display: %s", XDisplayName(0)); // does not return
     return; // silence static code analyzer
   }
+  startup_mark("XOpenDisplay");
 
   open_display_i(d);
   // the unique GC used by all X windows
@@ -559,50 +655,69 @@ void Fl_X11_Screen_Driver::open_display_platform() {
 }
 
 
+// All atoms are interned with a single request, see open_display_i()
+static const struct {
+  Atom *atom;
+  const char *name;
+} atom_table[] = {
+  { &WM_DELETE_WINDOW,               "WM_DELETE_WINDOW" },
+  { &WM_PROTOCOLS,                   "WM_PROTOCOLS" },
+  { &fl_MOTIF_WM_HINTS,              "_MOTIF_WM_HINTS" },
+  { &TARGETS,                        "TARGETS" },
+  { &CLIPBOARD,                      "CLIPBOARD" },
+  { &TIMESTAMP,                      "TIMESTAMP" },
+  { &PRIMARY_TIMESTAMP,              "PRIMARY_TIMESTAMP" },
+  { &CLIPBOARD_TIMESTAMP,            "CLIPBOARD_TIMESTAMP" },
+  { &fl_XdndAware,                   "XdndAware" },
+  { &fl_XdndSelection,               "XdndSelection" },
+  { &fl_XdndEnter,                   "XdndEnter" },
+  { &fl_XdndTypeList,                "XdndTypeList" },
+  { &fl_XdndPosition,                "XdndPosition" },
+  { &fl_XdndLeave,                   "XdndLeave" },
+  { &fl_XdndDrop,                    "XdndDrop" },
+  { &fl_XdndStatus,                  "XdndStatus" },
+  { &fl_XdndActionCopy,              "XdndActionCopy" },
+  { &fl_XdndFinished,                "XdndFinished" },
+  { &fl_XdndURIList,                 "text/uri-list" },
+  { &fl_Xatextplainutf,              "text/plain;charset=UTF-8" },
+  { &fl_Xatextplainutf2,             "text/plain;charset=utf-8" }, // Firefox/Thunderbird needs this - See STR#2930
+  { &fl_Xatextplain,                 "text/plain" },
+  { &fl_XaText,                      "TEXT" },
+  { &fl_XaCompoundText,              "COMPOUND_TEXT" },
+  { &fl_XaUtf8String,                "UTF8_STRING" },
+  { &fl_XaTextUriList,               "text/uri-list" },
+  { &fl_XaImageBmp,                  "image/bmp" },
+  { &fl_XaImagePNG,                  "image/png" },
+  { &fl_INCR,                        "INCR" },
+  { &fl_NET_WM_PID,                  "_NET_WM_PID" },
+  { &fl_NET_WM_NAME,                 "_NET_WM_NAME" },
+  { &fl_NET_WM_ICON_NAME,            "_NET_WM_ICON_NAME" },
+  { &fl_NET_SUPPORTING_WM_CHECK,     "_NET_SUPPORTING_WM_CHECK" },
+  { &fl_NET_WM_STATE,                "_NET_WM_STATE" },
+  { &fl_NET_WM_STATE_FULLSCREEN,     "_NET_WM_STATE_FULLSCREEN" },
+  { &fl_NET_WM_STATE_MAXIMIZED_VERT, "_NET_WM_STATE_MAXIMIZED_VERT" },
+  { &fl_NET_WM_STATE_MAXIMIZED_HORZ, "_NET_WM_STATE_MAXIMIZED_HORZ" },
+  { &fl_NET_WM_FULLSCREEN_MONITORS,  "_NET_WM_FULLSCREEN_MONITORS" },
+  { &fl_NET_WORKAREA,                "_NET_WORKAREA" },
+  { &fl_NET_WM_ICON,                 "_NET_WM_ICON" },
+  { &fl_NET_ACTIVE_WINDOW,           "_NET_ACTIVE_WINDOW" },
+  { &fl_NET_WM_STATE_MODAL,          "_NET_WM_STATE_MODAL" },
+  { &fl_NET_WM_STATE_SKIP_TASKBAR,   "_NET_WM_STATE_SKIP_TASKBAR" },
+  { &fl_NET_WM_WINDOW_TYPE,          "_NET_WM_WINDOW_TYPE" },
+  { &fl_NET_WM_WINDOW_TYPE_MENU,     "_NET_WM_WINDOW_TYPE_MENU" },
+};
+
 void open_display_i(Display* d) {
   fl_display = d;
 
-  WM_DELETE_WINDOW      = XInternAtom(d, "WM_DELETE_WINDOW",    0);
-  WM_PROTOCOLS          = XInternAtom(d, "WM_PROTOCOLS",        0);
-  fl_MOTIF_WM_HINTS     = XInternAtom(d, "_MOTIF_WM_HINTS",     0);
-  TARGETS               = XInternAtom(d, "TARGETS",             0);
-  CLIPBOARD             = XInternAtom(d, "CLIPBOARD",           0);
-  TIMESTAMP             = XInternAtom(d, "TIMESTAMP",           0);
-  PRIMARY_TIMESTAMP     = XInternAtom(d, "PRIMARY_TIMESTAMP",   0);
-  CLIPBOARD_TIMESTAMP   = XInternAtom(d, "CLIPBOARD_TIMESTAMP", 0);
-  fl_XdndAware          = XInternAtom(d, "XdndAware",           0);
-  fl_XdndSelection      = XInternAtom(d, "XdndSelection",       0);
-  fl_XdndEnter          = XInternAtom(d, "XdndEnter",           0);
-  fl_XdndTypeList       = XInternAtom(d, "XdndTypeList",        0);
-  fl_XdndPosition       = XInternAtom(d, "XdndPosition",        0);
-  fl_XdndLeave          = XInternAtom(d, "XdndLeave",           0);
-  fl_XdndDrop           = XInternAtom(d, "XdndDrop",            0);
-  fl_XdndStatus         = XInternAtom(d, "XdndStatus",          0);
-  fl_XdndActionCopy     = XInternAtom(d, "XdndActionCopy",      0);
-  fl_XdndFinished       = XInternAtom(d, "XdndFinished",        0);
-  fl_XdndURIList        = XInternAtom(d, "text/uri-list",       0);
-  fl_Xatextplainutf     = XInternAtom(d, "text/plain;charset=UTF-8",0);
-  fl_Xatextplainutf2    = XInternAtom(d, "text/plain;charset=utf-8",0); // Firefox/Thunderbird needs this - See STR#2930
-  fl_Xatextplain        = XInternAtom(d, "text/plain",          0);
-  fl_XaText             = XInternAtom(d, "TEXT",                0);
-  fl_XaCompoundText     = XInternAtom(d, "COMPOUND_TEXT",       0);
-  fl_XaUtf8String       = XInternAtom(d, "UTF8_STRING",         0);
-  fl_XaTextUriList      = XInternAtom(d, "text/uri-list",       0);
-  fl_XaImageBmp         = XInternAtom(d, "image/bmp",           0);
-  fl_XaImagePNG         = XInternAtom(d, "image/png",           0);
-  fl_INCR               = XInternAtom(d, "INCR",                0);
-  fl_NET_WM_PID         = XInternAtom(d, "_NET_WM_PID",         0);
-  fl_NET_WM_NAME        = XInternAtom(d, "_NET_WM_NAME",        0);
-  fl_NET_WM_ICON_NAME   = XInternAtom(d, "_NET_WM_ICON_NAME",   0);
-  fl_NET_SUPPORTING_WM_CHECK = XInternAtom(d, "_NET_SUPPORTING_WM_CHECK", 0);
-  fl_NET_WM_STATE       = XInternAtom(d, "_NET_WM_STATE",       0);
-  fl_NET_WM_STATE_FULLSCREEN = XInternAtom(d, "_NET_WM_STATE_FULLSCREEN", 0);
-  fl_NET_WM_STATE_MAXIMIZED_VERT = XInternAtom(d, "_NET_WM_STATE_MAXIMIZED_VERT", 0);
-  fl_NET_WM_STATE_MAXIMIZED_HORZ = XInternAtom(d, "_NET_WM_STATE_MAXIMIZED_HORZ", 0);
-  fl_NET_WM_FULLSCREEN_MONITORS = XInternAtom(d, "_NET_WM_FULLSCREEN_MONITORS", 0);
-  fl_NET_WORKAREA       = XInternAtom(d, "_NET_WORKAREA",       0);
-  fl_NET_WM_ICON        = XInternAtom(d, "_NET_WM_ICON",        0);
-  fl_NET_ACTIVE_WINDOW  = XInternAtom(d, "_NET_ACTIVE_WINDOW",  0);
+  // one round trip for all atoms instead of one per atom
+  const int atom_count = sizeof(atom_table) / sizeof(atom_table[0]);
+  char *atom_names[atom_count];
+  Atom atoms[atom_count];
+  for (int i = 0; i < atom_count; i++) atom_names[i] = (char*)atom_table[i].name;
+  XInternAtoms(d, atom_names, atom_count, False, atoms);
+  for (int i = 0; i < atom_count; i++) *atom_table[i].atom = atoms[i];
+  startup_mark("atoms");
 
   if (sizeof(Atom) < 4)
     atom_bits = sizeof(Atom) * 8;
@@ -619,37 +734,18 @@ void open_display_i(Display* d) {
   templt.visualid = XVisualIDFromVisual(DefaultVisual(d, fl_screen));
   fl_visual = XGetVisualInfo(d, VisualIDMask, &templt, &num);
   fl_colormap = DefaultColormap(d, fl_screen);
-  Fl_X11_Screen_Driver::init_xim();
 
 #if !USE_COLORMAP
   Fl::visual(FL_RGB);
 #endif
 
-#if HAVE_XFIXES
-  int error_base;
-  if (XFixesQueryExtension(fl_display, &xfixes_event_base, &error_base))
-    have_xfixes = true;
-  else
-    have_xfixes = false;
-#endif
-
-#if USE_XRANDR
-  void *libxrandr_addr = Fl_Posix_System_Driver::dlopen_or_dlsym("libXrandr");
-  if (libxrandr_addr) {
-    int error_base;
-    typedef Bool (*XRRQueryExtension_type)(Display*, int*, int*);
-    typedef void (*XRRSelectInput_type)(Display*, Window, int);
-    XRRQueryExtension_type XRRQueryExtension_f = (XRRQueryExtension_type)dlsym(libxrandr_addr, "XRRQueryExtension");
-    XRRSelectInput_type XRRSelectInput_f = (XRRSelectInput_type)dlsym(libxrandr_addr, "XRRSelectInput");
-    XRRUpdateConfiguration_f = (XRRUpdateConfiguration_type)dlsym(libxrandr_addr, "XRRUpdateConfiguration");
-    if (XRRQueryExtension_f && XRRSelectInput_f && XRRQueryExtension_f(d, &randrEventBase, &error_base))
-      XRRSelectInput_f(d, RootWindow(d, fl_screen), RRScreenChangeNotifyMask);
-    else XRRUpdateConfiguration_f = NULL;
-    }
-#endif
+  // XIM, XFixes and XRandR need several round trips to the server,
+  // they are set up after the first frame, see deferred_setup()
+  Fl_X11_Screen_Driver::deferred_setup_pending = true;
 
   // Listen for changes to _NET_WORKAREA
   XSelectInput(d, RootWindow(d, fl_screen), PropertyChangeMask);
+  startup_mark("display setup");
 }
 
 void Fl_X11_Screen_Driver::close_display() {
@@ -942,6 +1038,7 @@ static void handle_clipboard_timestamp(int clipboard, Time time)
 }
 
 void Fl_X11_Screen_Driver::clipboard_notify_change() {
+  deferred_setup();
   // Reset the timestamps if we've going idle so that you don't
   // get a bogus immediate trigger next time they're activated.
   if (fl_clipboard_notify_empty()) {
@@ -1011,6 +1108,7 @@ static void set_event_xy(Fl_Window *win) {
 #  if FLTK_CONSOLIDATE_MOTION
   send_motion = 0;
 #  endif
+  Fl::e_history_count = 0;
   float s = 1;
 #if USE_XFT
   s = Fl::screen_driver()->scale(Fl_Window_Driver::driver(win)->screen_num());
@@ -1031,6 +1129,96 @@ static void set_event_xy(Fl_Window *win) {
     Fl::e_is_click = 0;
 }
 
+// Event coalescing, see Fl::event_coalescing(int)
+
+static int history_alloc = 0;
+
+static void add_history(int x, int y) {
+  if (Fl::e_history_count >= history_alloc) {
+    history_alloc = history_alloc ? 2 * history_alloc : 64;
+    Fl::e_history = (int*)realloc(Fl::e_history, 2 * history_alloc * sizeof(int));
+  }
+  Fl::e_history[2 * Fl::e_history_count] = x;
+  Fl::e_history[2 * Fl::e_history_count + 1] = y;
+  Fl::e_history_count++;
+}
+
+// Removes the MotionNotify events that immediately follow fl_xevent in the
+// queue, for the same window and with the same modifier and button state,
+// and makes fl_xevent point to the last one. The positions of all these
+// events are kept in the motion history.
+static void coalesce_motion(Fl_Window *win) {
+  static XEvent last_motion;
+  float s = 1;
+#if USE_XFT
+  s = Fl::screen_driver()->scale(Fl_Window_Driver::driver(win)->screen_num());
+#endif
+  const XEvent *first = fl_xevent;
+  int count = 0;
+  XEvent next;
+  while (XEventsQueued(fl_display, QueuedAlready)) {
+    XPeekEvent(fl_display, &next);
+    if (next.type != MotionNotify ||
+        next.xmotion.window != first->xmotion.window ||
+        next.xmotion.state != first->xmotion.state) break;
+    if (!count++) add_history(int(first->xmotion.x/s), int(first->xmotion.y/s));
+    XNextEvent(fl_display, &last_motion);
+    add_history(int(last_motion.xmotion.x/s), int(last_motion.xmotion.y/s));
+  }
+  if (count) fl_xevent = &last_motion;
+}
+
+// Adds the area of an Expose event to the damage region of a window
+static void expose_rect(Fl_Window *window, int X, int Y, int W, int H) {
+#if USE_XFT
+  int ns = Fl_Window_Driver::driver(window)->screen_num();
+  float s = Fl::screen_driver()->scale(ns);
+  window->damage(FL_DAMAGE_EXPOSE, X/s, Y/s, W/s + 2, H/s + 2);
+#else
+  window->damage(FL_DAMAGE_EXPOSE, X, Y, W, H);
+#endif
+}
+
+// Handles an Expose event and all queued Expose events of the same window.
+// If the rectangles cover most of their bounding box, or if there are many
+// of them, the bounding box is damaged at once, which keeps the window's
+// damage region simple.
+static void coalesce_expose(Fl_Window *window, const XExposeEvent &first) {
+  static XRectangle *rects = NULL;
+  static int rects_alloc = 0;
+  int n = 0;
+  int x1 = first.x, y1 = first.y, x2 = first.x + first.width, y2 = first.y + first.height;
+  double area = double(first.width) * first.height;
+  XEvent next;
+  while (XCheckTypedWindowEvent(fl_display, first.window, Expose, &next)) {
+    const XExposeEvent &e = next.xexpose;
+    if (n >= rects_alloc) {
+      rects_alloc = rects_alloc ? 2 * rects_alloc : 16;
+      rects = (XRectangle*)realloc(rects, rects_alloc * sizeof(XRectangle));
+    }
+    rects[n].x = e.x; rects[n].y = e.y;
+    rects[n].width = e.width; rects[n].height = e.height;
+    n++;
+    if (e.x < x1) x1 = e.x;
+    if (e.y < y1) y1 = e.y;
+    if (e.x + e.width > x2) x2 = e.x + e.width;
+    if (e.y + e.height > y2) y2 = e.y + e.height;
+    area += double(e.width) * e.height;
+  }
+  if (n && (n >= 16 || double(x2 - x1) * (y2 - y1) <= 2 * area)) {
+    expose_rect(window, x1, y1, x2 - x1, y2 - y1);
+    return;
+  }
+  expose_rect(window, first.x, first.y, first.width, first.height);
+  for (int i = 0; i < n; i++)
+    expose_rect(window, rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+}
+
+static Bool is_configure_of(Display *, XEvent *e, XPointer xid) {
+  return e->type == ConfigureNotify && e->xconfigure.window == *(Window*)xid;
+}
+
+
 // if this is same event as last && is_click, increment click count:
 static inline void checkdouble() {
   if (Fl::e_is_click == Fl::e_keysym)
@@ -1071,103 +1259,326 @@ static int wasXExceptionRaised() {
 
 } // extern "C"
 
-static bool getNextEvent(XEvent *event_return) {
-  time_t t = time(NULL);
-  while (!XPending(fl_display)) {
-    if (time(NULL) - t > 10.0) {
-      // fprintf(stderr,"Error: The XNextEvent never came...\n");
-      return false;
-    }
+////////////////////////////////////////////////////////////////
+// Incremental (INCR) selection transfers, see ICCCM section 2.7.2.
+//
+// Large selection data are transferred in parts, each part being written
+// to a window property by the owner and deleted by the requestor. Both
+// directions are driven by PropertyNotify events handled by fl_handle(),
+// so that the event loop keeps running during the transfer.
+
+static unsigned char *sn_buffer = 0;  // selection data being received
+static long sn_length = 0;            // number of bytes in sn_buffer
+static long sn_alloc = 0;             // allocated size of sn_buffer
+
+static void sn_reserve(long size) {
+  if (size <= sn_alloc) return;
+  long n = sn_alloc ? sn_alloc : 65536;
+  while (n < size) n *= 2;
+  unsigned char *p = (unsigned char*)realloc(sn_buffer, n);
+  if (!p) Fl::fatal("Clipboard data transfer failed, size %ld is too large.", n);
+  sn_buffer = p;
+  sn_alloc = n;
+}
+
+static void sn_free() {
+  free(sn_buffer);
+  sn_buffer = 0;
+  sn_length = sn_alloc = 0;
+}
+
+// Largest amount of data written in one XChangeProperty() request
+static long incr_chunk_size() {
+  long n = XMaxRequestSize(fl_display) * 4 - 1024;
+  return n < 262144 ? n : 262144;
+}
+
+// Sends XdndFinished to the source of a drag and drop when its data,
+// received in property, has been pasted
+static void send_dnd_finished(Window requestor, Atom property, int retval, Atom action) {
+  if (property == XA_SECONDARY && fl_dnd_source_window) {
+    fl_sendClientMessage(fl_dnd_source_window,           // send to window
+                         fl_XdndFinished,                // XdndFinished message
+                         requestor,                      // data.l[0] target window
+                         retval ? 1 : 0,                 // data.l[1] Bit 0: 1 = success
+                         retval ? action : None);        // data.l[2] action performed
+    fl_dnd_source_window = 0; // don't send a second time
+  }
+}
+
+// Incoming transfer
+static struct {
+  bool active;
+  Window requestor;     // our window that receives the data
+  Atom property;
+  const char *type;     // Fl::clipboard_plain_text or Fl::clipboard_image
+  long expected;        // lower bound of the size given by the owner, or 0
+  long received;        // number of bytes received so far
+} incr_in;
+
+static const double incr_receive_timeout = 10.0; // seconds without data
+
+static void incr_receive_timeout_cb(void *);
+
+static void incr_receive_cancel() {
+  if (!incr_in.active) return;
+  incr_in.active = false;
+  Fl::remove_timeout(incr_receive_timeout_cb);
+  sn_free();
+  XDeleteProperty(fl_display, incr_in.requestor, incr_in.property);
+  send_dnd_finished(incr_in.requestor, incr_in.property, 0, None);
+}
+
+// the owner stopped sending data
+static void incr_receive_timeout_cb(void *) {
+  incr_receive_cancel();
+}
+
+static int deliver_selection(long length, Atom property, Window requestor);
+
+// Returns the length of the longest prefix of text s of length n that ends
+// with a complete UTF-8 character that is not a '\r', because the '\r' may
+// be followed by a '\n' in the next part.
+static long complete_text_length(const unsigned char *s, long n) {
+  long i = n - 1;
+  while (i >= 0 && i > n - 4 && (s[i] & 0xC0) == 0x80) i--;
+  long end = n;
+  if (i >= 0 && (s[i] & 0xC0) == 0xC0 && i + fl_utf8len1(s[i]) > n) end = i;
+  if (end > 0 && s[end - 1] == '\r') end--;
+  return end;
+}
+
+// Delivers the first n bytes of the text received so far in an FL_PASTE
+// event with Fl::event_paste_more() set, and keeps the rest
+static void incr_deliver_part(long n) {
+  unsigned char saved = sn_buffer[n];
+  sn_buffer[n] = 0;
+  long len = n;
+  convert_crlf(sn_buffer, len);
+  Fl::e_text = (char*)sn_buffer;
+  Fl::e_length = len;
+  Fl::e_clipboard_type = Fl::clipboard_plain_text;
+  Fl::e_paste_more = 1;
+  int old_event = Fl::e_number;
+  fl_selection_requestor->handle(Fl::e_number = FL_PASTE);
+  Fl::e_number = old_event;
+  Fl::e_paste_more = 0;
+  Fl::e_text = (char*)"";
+  Fl::e_length = 0;
+  sn_buffer[n] = saved;
+  memmove(sn_buffer, sn_buffer + n, sn_length - n);
+  sn_length -= n;
+}
+
+// Handles a PropertyNotify event of an incoming transfer, returns true if
+// the event belongs to it
+static bool incr_receive_property(const XPropertyEvent &pe) {
+  if (!incr_in.active || pe.window != incr_in.requestor || pe.atom != incr_in.property)
+    return false;
+  if (pe.state != PropertyNewValue) return true;
+  long chunk = 0;
+  for (;;) {
+    Atom actual; int format; unsigned long count, remaining;
+    unsigned char *portion = NULL;
+    if (XGetWindowProperty(fl_display, pe.window, pe.atom, chunk/4, 65536, True,
+                           AnyPropertyType, &actual, &format, &count, &remaining,
+                           &portion) != Success) break;
+    long n = (portion && format == 8) ? (long)count : 0;
+    sn_reserve(sn_length + n + (long)remaining + 1);
+    memcpy(sn_buffer + sn_length, portion, n);
+    sn_length += n;
+    chunk += n;
+    if (portion) XFree(portion);
+    if (!n || !remaining) break;
+  }
+  Fl::remove_timeout(incr_receive_timeout_cb);
+  if (chunk == 0) { // a zero-length property ends the transfer
+    incr_in.active = false;
+    Fl::e_clipboard_type = incr_in.type;
+    deliver_selection(sn_length, incr_in.property, incr_in.requestor);
+    return true;
+  }
+  incr_in.received += chunk;
+  if (!fl_selection_requestor ||
+      (Fl::paste_progress_ &&
+       !Fl::paste_progress_(incr_in.received, incr_in.expected, Fl::paste_progress_data_))) {
+    incr_receive_cancel();
+    return true;
+  }
+  Fl::add_timeout(incr_receive_timeout, incr_receive_timeout_cb);
+  if (Fl::paste_streaming_ && incr_in.type == Fl::clipboard_plain_text) {
+    long n = complete_text_length(sn_buffer, sn_length);
+    if (n > 0) incr_deliver_part(n);
   }
-  XNextEvent(fl_display, event_return);
   return true;
 }
 
-static long getIncrData(uchar* &data, const XSelectionEvent& selevent, size_t lower_bound) {
-  // fprintf(stderr,"Incremental transfer starting due to INCR property\n");
-  // fprintf(stderr, "[getIncrData:%d] lower_bound [in ] =%10ld\n", __LINE__, lower_bound);
-  const size_t alloc_min =   4 * 1024 * 1024; // min. initial allocation
-  const size_t alloc_max = 200 * 1024 * 1024; // max. initial allocation
-  const size_t alloc_inc =   4 * 1024 * 1024; // (min.) increase if necessary
-  size_t total = 0;
-  size_t data_size = lower_bound + 1;
-  if (data_size < alloc_min) {
-    data_size = alloc_min;
-  } else if (data_size > alloc_max) {
-    data_size = alloc_max;
+static void incr_receive_start(Window requestor, Atom property, long expected) {
+  incr_receive_cancel();
+  incr_in.active = true;
+  incr_in.requestor = requestor;
+  incr_in.property = property;
+  incr_in.type = Fl::e_clipboard_type;
+  incr_in.expected = expected;
+  incr_in.received = 0;
+  sn_length = 0;
+  if (expected > 0) sn_reserve(expected + 1);
+  // deleting the INCR property starts the transfer
+  XDeleteProperty(fl_display, requestor, property);
+  Fl::add_timeout(incr_receive_timeout, incr_receive_timeout_cb);
+}
+
+// Outgoing transfers
+struct Incr_Send {
+  Window requestor;
+  Atom property, type;
+  unsigned char *data;
+  long length, offset;
+  bool select_input;    // we selected PropertyNotify events on requestor
+  Fl_Timestamp last;    // time the requestor last deleted the property
+  Incr_Send *next;
+};
+static Incr_Send *incr_out = NULL;
+
+static const double incr_send_timeout = 30.0; // seconds without progress
+
+static void incr_send_end(Incr_Send *t) {
+  for (Incr_Send **p = &incr_out; *p; p = &(*p)->next) {
+    if (*p == t) { *p = t->next; break; }
+  }
+  if (t->select_input) {
+    bool used = false;
+    for (Incr_Send *u = incr_out; u; u = u->next) if (u->requestor == t->requestor) used = true;
+    if (!used) {
+      XErrorHandler old_handler = XSetErrorHandler(catchXExceptions());
+      XSelectInput(fl_display, t->requestor, NoEventMask);
+      XSync(fl_display, False);
+      XSetErrorHandler(old_handler);
+    }
   }
-  // fprintf(stderr, "[getIncrData:%d] initial alloc.    =%10ld\n", __LINE__, data_size);
+  free(t->data);
+  delete t;
+}
 
-  XEvent event;
-  XDeleteProperty(fl_display, selevent.requestor, selevent.property);
-  data = (uchar*)realloc(data, data_size);
-  if (!data) {
-    // fprintf(stderr, "[getIncrData:%d] realloc() FAILED, size = %ld\n", __LINE__, data_size);
-    Fl::fatal("Clipboard data transfer failed, size %ld is too large.", data_size);
+// drops transfers the requestor doesn't read, e.g. because it was closed
+static void incr_send_watchdog(void *) {
+  for (Incr_Send *t = incr_out, *next; t; t = next) {
+    next = t->next;
+    if (Fl::seconds_since(t->last) > incr_send_timeout) incr_send_end(t);
   }
-  for (;;) {
-    if (!getNextEvent(&event)) {
-      // This is unexpected but may happen if the sender (clipboard owner) no longer sends data
-      // fprintf(stderr, "[getIncrData:%d] Failed to get next event (timeout) *** break! ***\n", __LINE__);
-      break;
-    }
-    if (event.type == PropertyNotify) {
-      if (event.xproperty.state != PropertyNewValue) continue; // ignore PropertyDelete
-      Atom actual_type;
-      int actual_format;
-      unsigned long nitems;
-      unsigned long bytes_after;
-      unsigned char* prop = 0;
-      long offset = 0;
-      size_t num_bytes = 0;
-      // size_t slice_size = 0;
-      do {
-        XGetWindowProperty(fl_display, selevent.requestor, selevent.property, offset, 70000, True,
-                           AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after, &prop);
-        num_bytes = nitems * (actual_format / 8);
-        offset += num_bytes/4;
-        // slice_size += num_bytes;
-        if (total + num_bytes + bytes_after + 1 > data_size) {
-          data_size += alloc_inc;
-          if (total + num_bytes + bytes_after + 1 > data_size)
-            data_size = total + num_bytes + bytes_after + 1;
-          // printf(" -- realloc(%9ld), total=%10ld, num_bytes=%7ld, bytes_after=%7ld (%7ld), required=%10ld\n",
-          //        data_size, total, num_bytes, bytes_after, num_bytes + bytes_after, total + num_bytes + bytes_after + 1);
-          data = (uchar*)realloc(data, data_size);
-          if (!data) {
-            // fprintf(stderr, "[getIncrData():%d] realloc() FAILED, size = %ld\n", __LINE__, data_size);
-            Fl::fatal("Clipboard data transfer failed, size %ld is too large.", data_size);
-          }
-        }
-        memcpy(data + total, prop, num_bytes);
-        total += num_bytes;
-        if (prop) XFree(prop);
-      } while (bytes_after != 0);
-      // fprintf(stderr,"INCR data size:%ld\n", slice_size);
-      if (num_bytes == 0) break;
-    }
-    else {
-      // Unexpected next event. At this point we're handling the INCR protocol and can't deal with
-      // *some* other events due to potential recursions. We *could* call fl_handle(event) to handle
-      // *selected* other events but for the time being we ignore all other events!
-      // Handling the INCR protocol for very large data may take some time and multiple events.
-      // Interleaving "other" events are possible, for instance the KeyRelease event of the
-      // ctrl/v key pressed to insert the clipboard. This solution is not perfect but it can
-      // handle the INCR protocol with very large selections in most cases, although with potential
-      // side effects because other events may be ignored.
-      // See GitHub Issue #451: "Segfault if using very large selections".
-      // Note: the "fix" for Issue #451 is basically to use 'continue' rather than 'break'
-      // Debug:
-      // fprintf(stderr,
-      //   "[getIncrData:%d] getNextEvent() returned %d, not PropertyNotify (%d). Event ignored.\n",
-      //   __LINE__, event.type, PropertyNotify);
+  if (incr_out) Fl::repeat_timeout(5.0, incr_send_watchdog);
+}
 
-      continue;
+// Writes selection data to the property of the requestor, in parts if
+// they are too large for a single request
+static void send_selection_data(XSelectionEvent &e, const char *data, long length) {
+  if (length <= incr_chunk_size()) {
+    XChangeProperty(fl_display, e.requestor, e.property,
+                    e.target, 8, 0, (unsigned char *)data, length);
+    return;
+  }
+  unsigned char *copy = (unsigned char*)malloc(length);
+  if (!copy) { e.property = 0; return; }
+  memcpy(copy, data, length);
+  Incr_Send *t = new Incr_Send;
+  t->requestor = e.requestor;
+  t->property = e.property;
+  t->type = e.target;
+  t->data = copy;
+  t->length = length;
+  t->offset = 0;
+  t->select_input = !fl_find(e.requestor);
+  t->last = Fl::now();
+  t->next = incr_out;
+  incr_out = t;
+  if (t->select_input) {
+    XErrorHandler old_handler = XSetErrorHandler(catchXExceptions());
+    XSelectInput(fl_display, e.requestor, PropertyChangeMask);
+    XSync(fl_display, False);
+    XSetErrorHandler(old_handler);
+    if (wasXExceptionRaised()) { // the requestor is gone
+      t->select_input = false;
+      incr_send_end(t);
+      e.property = 0;
+      return;
     }
   }
-  XDeleteProperty(fl_display, selevent.requestor, selevent.property);
-  // fprintf(stderr, "[getIncrData:%d] total data  [out] =%10ld\n", __LINE__, (long)total);
-  return (long)total;
+  long size = length;
+  XChangeProperty(fl_display, e.requestor, e.property, fl_INCR, 32, 0,
+                  (unsigned char *)&size, 1);
+  if (!Fl::has_timeout(incr_send_watchdog)) Fl::add_timeout(5.0, incr_send_watchdog);
+}
+
+// Handles a PropertyNotify event of an outgoing transfer, returns true if
+// the event belongs to it
+static bool incr_send_property(const XPropertyEvent &pe) {
+  Incr_Send *t = incr_out;
+  while (t && (t->requestor != pe.window || t->property != pe.atom)) t = t->next;
+  if (!t) return false;
+  if (pe.state != PropertyDelete) return true;
+  long n = t->length - t->offset;
+  if (n > incr_chunk_size()) n = incr_chunk_size();
+  // the last part is followed by a zero-length part
+  XChangeProperty(fl_display, t->requestor, t->property, t->type, 8, 0,
+                  t->data + t->offset, n);
+  t->offset += n;
+  t->last = Fl::now();
+  if (n == 0) incr_send_end(t);
+  return true;
+}
+
+// Sends the received selection data to fl_selection_requestor
+static int deliver_selection(long bytesread, Atom property, Window requestor) {
+  if (sn_buffer && Fl::e_clipboard_type == Fl::clipboard_plain_text) {
+    sn_buffer[bytesread] = 0;
+    convert_crlf(sn_buffer, bytesread);
+  }
+  if (!fl_selection_requestor) return 0;
+  if (Fl::e_clipboard_type == Fl::clipboard_image) {
+    if (bytesread == 0) return 0;
+    static char tmp_fname[21];
+    static Fl_Shared_Image *shared = 0;
+    strcpy(tmp_fname, "/tmp/clipboardXXXXXX");
+    int fd = mkstemp(tmp_fname);
+    if (fd == -1) return 0;
+    uchar *p = sn_buffer; ssize_t towrite = bytesread, written;
+    while (towrite) {
+      written = write(fd, p, towrite);
+      p += written; towrite -= written;
+      }
+    close(fd);
+    sn_free();
+    shared = Fl_Shared_Image::get(tmp_fname);
+    fl_unlink(tmp_fname);
+    if (!shared) return 0;
+    uchar *rgb = new uchar[shared->w() * shared->h() * shared->d()];
+    memcpy(rgb, shared->data()[0], shared->w() * shared->h() * shared->d());
+    Fl_RGB_Image *image = new Fl_RGB_Image(rgb, shared->w(), shared->h(), shared->d());
+    shared->release();
+    image->alloc_array = 1;
+    Fl::e_clipboard_data = (void*)image;
+  }
+  else if (Fl::e_clipboard_type == Fl::clipboard_plain_text) {
+    Fl::e_text = sn_buffer ? (char*)sn_buffer : (char *)"";
+    Fl::e_length = bytesread;
+  }
+  Fl::e_paste_more = 0;
+  int old_event = Fl::e_number;
+  int retval = fl_selection_requestor->handle(Fl::e_number = FL_PASTE);
+  if (!retval && Fl::e_clipboard_type == Fl::clipboard_image) {
+    delete (Fl_RGB_Image*)Fl::e_clipboard_data;
+    Fl::e_clipboard_data = NULL;
+  }
+  Fl::e_number = old_event;
+  // Detect if this paste is due to Xdnd by the property name (I use
+  // XA_SECONDARY for that) and send an XdndFinished message.
+  // This has to be delayed until now rather than sending it immediately
+  // after calling XConvertSelection because we need to send the success
+  // status (retval) and the performed action to the sender - at least
+  // since XDND protocol version 5 (see docs).
+  // [FIXME: is the condition below really correct?]
+  send_dnd_finished(requestor, property, retval, fl_dnd_action);
+  return 1;
 }
 
 /*
@@ -1352,6 +1763,10 @@ int fl_handle(const XEvent& thisevent)
 #endif // USE_XFT
   }
 
+  if (xevent.type == PropertyNotify &&
+      (incr_receive_property(xevent.xproperty) || incr_send_property(xevent.xproperty)))
+    return 1;
+
   switch (xevent.type) {
 
   case KeymapNotify:
@@ -1363,10 +1778,6 @@ int fl_handle(const XEvent& thisevent)
     return 0;
 
   case SelectionNotify: {
-    static unsigned char* sn_buffer = 0;
-    if (sn_buffer) {
-      free(sn_buffer); sn_buffer = 0;
-    }
     long bytesread = 0;
     if (fl_xevent->xselection.property) for (;;) {
       // The Xdnd code pastes 64K chunks together, possibly to avoid
@@ -1432,95 +1843,36 @@ int fl_handle(const XEvent& thisevent)
         //
         // However, some X clients don't set the integer ("lower bound") in the INCR
         // property, hence 'count' below is zero and we must not access '*portion'.
-        // Debug:
-#if (0)
-        fprintf(stderr,
-                "[fl_handle(SelectionNotify/INCR):%d] actual=%ld (INCR), format=%d, count=%ld, remaining=%ld",
-                __LINE__, actual, format, count, remaining);
-        if (portion && count > 0) {
-          fprintf(stderr,
-                ", portion=%p (%ld)", portion, *(long*)portion);
-        }
-        fprintf(stderr, "\n");
-#endif
-        size_t lower_bound = 0;
+        long lower_bound = 0;
         if (portion && count > 0) {
-          lower_bound = *(unsigned long *)portion;
+          lower_bound = *(long *)portion;
         }
-        bytesread = getIncrData(sn_buffer, xevent.xselection, lower_bound);
         XFree(portion);
-        break;
+        // the data arrive with PropertyNotify events, see incr_receive_property()
+        incr_receive_start(xevent.xselection.requestor, xevent.xselection.property, lower_bound);
+        return true;
       }
       // Make sure we got something sane...
       if ((portion == NULL) || (format != 8) || (count == 0)) {
         if (portion) XFree(portion);
         return true;
       }
-      sn_buffer = (unsigned char*)realloc(sn_buffer, bytesread+count+remaining+1);
+      if (bytesread == 0) { // a new transfer replaces an incomplete one
+        incr_receive_cancel();
+        sn_length = 0;
+      }
+      sn_reserve(bytesread+count+remaining+1);
       memcpy(sn_buffer + bytesread, portion, count);
       XFree(portion);
       bytesread += count;
+      sn_length = bytesread;
       // Cannot trust data to be null terminated
       sn_buffer[bytesread] = '\0';
       if (!remaining) break;
     }
-    if (sn_buffer && Fl::e_clipboard_type == Fl::clipboard_plain_text) {
-      sn_buffer[bytesread] = 0;
-      convert_crlf(sn_buffer, bytesread);
-    }
-    if (!fl_selection_requestor) return 0;
-    if (Fl::e_clipboard_type == Fl::clipboard_image) {
-      if (bytesread == 0) return 0;
-      static char tmp_fname[21];
-      static Fl_Shared_Image *shared = 0;
-      strcpy(tmp_fname, "/tmp/clipboardXXXXXX");
-      int fd = mkstemp(tmp_fname);
-      if (fd == -1) return 0;
-      uchar *p = sn_buffer; ssize_t towrite = bytesread, written;
-      while (towrite) {
-        written = write(fd, p, towrite);
-        p += written; towrite -= written;
-        }
-      close(fd);
-      free(sn_buffer); sn_buffer = 0;
-      shared = Fl_Shared_Image::get(tmp_fname);
-      fl_unlink(tmp_fname);
-      if (!shared) return 0;
-      uchar *rgb = new uchar[shared->w() * shared->h() * shared->d()];
-      memcpy(rgb, shared->data()[0], shared->w() * shared->h() * shared->d());
-      Fl_RGB_Image *image = new Fl_RGB_Image(rgb, shared->w(), shared->h(), shared->d());
-      shared->release();
-      image->alloc_array = 1;
-      Fl::e_clipboard_data = (void*)image;
-    }
-    else if (Fl::e_clipboard_type == Fl::clipboard_plain_text) {
-      Fl::e_text = sn_buffer ? (char*)sn_buffer : (char *)"";
-      Fl::e_length = bytesread;
-    }
-    int old_event = Fl::e_number;
-    int retval = fl_selection_requestor->handle(Fl::e_number = FL_PASTE);
-    if (!retval && Fl::e_clipboard_type == Fl::clipboard_image) {
-      delete (Fl_RGB_Image*)Fl::e_clipboard_data;
-      Fl::e_clipboard_data = NULL;
-    }
-    Fl::e_number = old_event;
-    // Detect if this paste is due to Xdnd by the property name (I use
-    // XA_SECONDARY for that) and send an XdndFinished message.
-    // This has to be delayed until now rather than sending it immediately
-    // after calling XConvertSelection because we need to send the success
-    // status (retval) and the performed action to the sender - at least
-    // since XDND protocol version 5 (see docs).
-    // [FIXME: is the condition below really correct?]
-
-    if (fl_xevent->xselection.property == XA_SECONDARY && fl_dnd_source_window) {
-      fl_sendClientMessage(fl_dnd_source_window,            // send to window
-                           fl_XdndFinished,                 // XdndFinished message
-                           fl_xevent->xselection.requestor, // data.l[0] target window
-                           retval ? 1 : 0,                  // data.l[1] Bit 0: 1 = success
-                           retval ? fl_dnd_action : None);  // data.l[2] action performed
-      fl_dnd_source_window = 0; // don't send a second time
-    }
-    return 1;
+    if (bytesread == 0 && incr_in.active) return 1; // don't clobber its data
+    return deliver_selection(bytesread, fl_xevent->xselection.property,
+                             fl_xevent->xselection.requestor);
   } // SelectionNotify
 
   case SelectionClear: {
@@ -1557,10 +1909,8 @@ int fl_handle(const XEvent& thisevent)
             // behave that insist on asking for XA_TEXT instead of UTF8_STRING
             // Does not change XA_STRING as that breaks xclipboard.
             if (e.target != XA_STRING) e.target = fl_XaUtf8String;
-            XChangeProperty(fl_display, e.requestor, e.property,
-                            e.target, 8, 0,
-                            (unsigned char *)fl_selection_buffer[clipboard],
-                            fl_selection_length[clipboard]);
+            send_selection_data(e, fl_selection_buffer[clipboard],
+                                fl_selection_length[clipboard]);
           }
         } else { // no data available
           e.property = 0;
@@ -1573,10 +1923,8 @@ int fl_handle(const XEvent& thisevent)
                         XA_ATOM, atom_bits, 0, (unsigned char*)a, 1);
       } else {
         if (e.target == fl_XaImageBmp && fl_selection_length[clipboard]) {
-            XChangeProperty(fl_display, e.requestor, e.property,
-                            e.target, 8, 0,
-                            (unsigned char *)fl_selection_buffer[clipboard],
-                            fl_selection_length[clipboard]);
+            send_selection_data(e, fl_selection_buffer[clipboard],
+                                fl_selection_length[clipboard]);
         } else {
           e.property = 0;
         }
@@ -1787,17 +2135,11 @@ int fl_handle(const XEvent& thisevent)
 #  endif
 
   case GraphicsExpose:
-    {
-#if USE_XFT
-      int ns = Fl_Window_Driver::driver(window)->screen_num();
-      float s = Fl::screen_driver()->scale(ns);
-      window->damage(FL_DAMAGE_EXPOSE, xevent.xexpose.x/s, xevent.xexpose.y/s,
-                     xevent.xexpose.width/s + 2, xevent.xexpose.height/s + 2);
-#else
-      window->damage(FL_DAMAGE_EXPOSE, xevent.xexpose.x, xevent.xexpose.y,
-                     xevent.xexpose.width, xevent.xexpose.height);
-#endif
-     }
+    if (xevent.type == Expose && (Fl::e_coalesce & Fl::COALESCE_EXPOSE))
+      coalesce_expose(window, xevent.xexpose);
+    else
+      expose_rect(window, xevent.xexpose.x, xevent.xexpose.y,
+                  xevent.xexpose.width, xevent.xexpose.height);
     return 1;
 
   case FocusIn:
@@ -2150,7 +2492,15 @@ int fl_handle(const XEvent& thisevent)
     break;
 
   case MotionNotify:
-    set_event_xy(window);
+    Fl::e_history_count = 0;
+    if (Fl::e_coalesce & Fl::COALESCE_MOTION) coalesce_motion(window);
+    {
+      // set_event_xy() clears the motion history
+      int n = Fl::e_history_count;
+      set_event_xy(window);
+      Fl::e_history_count = n;
+    }
+    if (!Fl::e_history_count) add_history(Fl::e_x, Fl::e_y);
     in_a_window = true;
 #  if FLTK_CONSOLIDATE_MOTION
     send_motion = fl_xmousewin = window;
@@ -2202,6 +2552,13 @@ int fl_handle(const XEvent& thisevent)
   case ConfigureNotify: {
     if (window->parent()) break; // ignore child windows
 
+    // the window geometry is queried below, so queued ConfigureNotify
+    // events of the same window would only repeat this work:
+    if (xevent.type == ConfigureNotify && (Fl::e_coalesce & Fl::COALESCE_CONFIGURE)) {
+      XEvent next;
+      while (XCheckIfEvent(fl_display, &next, is_configure_of, (XPointer)&xid)) {}
+    }
+
     // figure out where OS really put window
     XWindowAttributes actual;
     XGetWindowAttributes(fl_display, fl_xid(window), &actual);
@@ -2745,19 +3102,15 @@ void Fl_X::make_xid(Fl_Window* win, XVisualInfo *visual, Colormap colormap)
       XSetTransientForHint(fl_display, xp->xid, fl_xid(wp));
       if (!wp->visible()) showit = 0; // guess that wm will not show it
       if (win->modal()) {
-        Atom net_wm_state = XInternAtom (fl_display, "_NET_WM_STATE", 0);
-        Atom net_wm_state_skip_taskbar = XInternAtom (fl_display, "_NET_WM_STATE_MODAL", 0);
-        XChangeProperty (fl_display, xp->xid, net_wm_state, XA_ATOM, 32,
-            PropModeAppend, (unsigned char*) &net_wm_state_skip_taskbar, 1);
+        XChangeProperty (fl_display, xp->xid, fl_NET_WM_STATE, XA_ATOM, 32,
+            PropModeAppend, (unsigned char*) &fl_NET_WM_STATE_MODAL, 1);
       }
     }
 
     // Make sure that borderless windows do not show in the task bar
     if (!win->border()) {
-      Atom net_wm_state = XInternAtom (fl_display, "_NET_WM_STATE", 0);
-      Atom net_wm_state_skip_taskbar = XInternAtom (fl_display, "_NET_WM_STATE_SKIP_TASKBAR", 0);
-      XChangeProperty (fl_display, xp->xid, net_wm_state, XA_ATOM, 32,
-          PropModeAppend, (unsigned char*) &net_wm_state_skip_taskbar, 1);
+      XChangeProperty (fl_display, xp->xid, fl_NET_WM_STATE, XA_ATOM, 32,
+          PropModeAppend, (unsigned char*) &fl_NET_WM_STATE_SKIP_TASKBAR, 1);
     }
 
     // If asked for, create fullscreen
@@ -2800,9 +3153,7 @@ void Fl_X::make_xid(Fl_Window* win, XVisualInfo *visual, Colormap colormap)
 
   // set the window type for menu and tooltip windows to avoid animations (compiz)
   if (win->menu_window() || win->tooltip_window()) {
-    Atom net_wm_type = XInternAtom(fl_display, "_NET_WM_WINDOW_TYPE", False);
-    Atom net_wm_type_kind = XInternAtom(fl_display, "_NET_WM_WINDOW_TYPE_MENU", False);
-    XChangeProperty(fl_display, xp->xid, net_wm_type, XA_ATOM, 32, PropModeReplace, (unsigned char*)&net_wm_type_kind, 1);
+    XChangeProperty(fl_display, xp->xid, fl_NET_WM_WINDOW_TYPE, XA_ATOM, 32, PropModeReplace, (unsigned char*)&fl_NET_WM_WINDOW_TYPE_MENU, 1);
   }
 
 #if HAVE_XFIXES
@@ -0,0 +1,104 @@
+//
+// Implementation of the headless graphics driver for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Headless_Graphics_Driver.H"
+#include <FL/Fl.H>
+#include <FL/Fl_RGB_Image.H>
+
+
+/* Creates a w x h pixel image surface filled with black and returns
+ a cairo_t * ready to be used by Fl_Cairo_Graphics_Driver::set_cairo().
+ */
+cairo_t *Fl_Headless_Graphics_Driver::create_buffer(int w, int h) {
+  if (w < 1) w = 1;
+  if (h < 1) h = 1;
+  cairo_surface_t *surf = cairo_image_surface_create(CAIRO_FORMAT_RGB24, w, h);
+  if (cairo_surface_status(surf) != CAIRO_STATUS_SUCCESS) {
+    Fl::fatal("can't create %dx%d headless buffer: %s\n", w, h,
+              cairo_status_to_string(cairo_surface_status(surf)));
+  }
+  cairo_t *cr = cairo_create(surf);
+  cairo_surface_destroy(surf); // cr keeps a reference to surf
+  cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+  cairo_save(cr); // set_cairo() starts with cairo_restore()
+  return cr;
+}
+
+
+void Fl_Headless_Graphics_Driver::delete_buffer(cairo_t *buffer) {
+  if (buffer) cairo_destroy(buffer);
+}
+
+
+void Fl_Headless_Graphics_Driver::buffer_size(cairo_t *buffer, int &w, int &h) {
+  cairo_surface_t *surf = cairo_get_target(buffer);
+  w = cairo_image_surface_get_width(surf);
+  h = cairo_image_surface_get_height(surf);
+}
+
+
+/* Returns a depth-3 copy of the X,Y,W,H rectangle of buffer, in pixel units,
+ clipped to the buffer's size, or NULL if the rectangle is empty.
+ */
+Fl_RGB_Image *Fl_Headless_Graphics_Driver::buffer_image(cairo_t *buffer, int X, int Y, int W, int H) {
+  cairo_surface_t *surf = cairo_get_target(buffer);
+  cairo_surface_flush(surf);
+  int width, height;
+  buffer_size(buffer, width, height);
+  if (X < 0) { W += X; X = 0; }
+  if (Y < 0) { H += Y; Y = 0; }
+  if (X + W > width) W = width - X;
+  if (Y + H > height) H = height - Y;
+  if (W <= 0 || H <= 0) return NULL;
+  int stride = cairo_image_surface_get_stride(surf);
+  const uchar *bits = cairo_image_surface_get_data(surf);
+  uchar *data = new uchar[W * H * 3];
+  uchar *p = data;
+  for (int j = 0; j < H; j++) {
+    const unsigned *q = (const unsigned*)(bits + (Y + j) * stride) + X;
+    for (int i = 0; i < W; i++) { // CAIRO_FORMAT_RGB24 pixels are native-endian 0xXXRRGGBB
+      unsigned px = *q++;
+      *p++ = (px >> 16) & 0xff; // R
+      *p++ = (px >> 8) & 0xff;  // G
+      *p++ = px & 0xff;         // B
+    }
+  }
+  Fl_RGB_Image *rgb = new Fl_RGB_Image(data, W, H, 3);
+  rgb->alloc_array = 1;
+  return rgb;
+}
+
+
+void Fl_Headless_Graphics_Driver::copy_offscreen(int x, int y, int w, int h,
+                                                 Fl_Offscreen src, int srcx, int srcy) {
+  // draw portion srcx,srcy,w,h of src to position x,y (top-left) of
+  // the graphics driver's surface
+  cairo_matrix_t matrix;
+  cairo_get_matrix(cairo_, &matrix);
+  double s = matrix.xx;
+  cairo_save(cairo_);
+  cairo_rectangle(cairo_, x, y, w, h);
+  cairo_clip(cairo_);
+  cairo_surface_t *surf = cairo_get_target((cairo_t *)src);
+  cairo_pattern_t *pat = cairo_pattern_create_for_surface(surf);
+  cairo_set_source(cairo_, pat);
+  cairo_matrix_init_scale(&matrix, s, s);
+  cairo_matrix_translate(&matrix, -(x - srcx), -(y - srcy));
+  cairo_pattern_set_matrix(pat, &matrix);
+  cairo_paint(cairo_);
+  cairo_pattern_destroy(pat);
+  cairo_restore(cairo_);
+}
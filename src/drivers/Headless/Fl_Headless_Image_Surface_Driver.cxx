@@ -0,0 +1,78 @@
+//
+// Draw-to-image code for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Headless_Image_Surface_Driver.H"
+#include "Fl_Headless_Graphics_Driver.H"
+
+
+Fl_Headless_Image_Surface_Driver::Fl_Headless_Image_Surface_Driver(int w, int h,
+      int high_res, Fl_Offscreen off) : Fl_Image_Surface_Driver(w, h, high_res, off) {
+  pre_window = 0;
+  float s = 1;
+  if (!off) {
+    fl_open_display();
+    s = fl_graphics_driver->scale();
+    if (s != 1 && high_res) {
+      w = int(w * s);
+      h = int(h * s);
+    }
+    cairo_t *cr = Fl_Headless_Graphics_Driver::create_buffer(w, h);
+    offscreen = (Fl_Offscreen)cr;
+    if (s != 1 && high_res) cairo_scale(cr, s, s);
+  }
+  driver(new Fl_Headless_Graphics_Driver());
+  if (s != 1 && high_res) driver()->scale(s);
+}
+
+
+Fl_Headless_Image_Surface_Driver::~Fl_Headless_Image_Surface_Driver() {
+  if (offscreen && !external_offscreen) {
+    Fl_Headless_Graphics_Driver::delete_buffer((cairo_t *)offscreen);
+  }
+  delete driver();
+}
+
+
+void Fl_Headless_Image_Surface_Driver::set_current() {
+  Fl_Surface_Device::set_current();
+  ((Fl_Headless_Graphics_Driver*)fl_graphics_driver)->set_cairo((cairo_t*)offscreen);
+  pre_window = fl_window;
+  fl_window = 0;
+}
+
+
+void Fl_Headless_Image_Surface_Driver::end_current() {
+  cairo_surface_flush(cairo_get_target((cairo_t*)offscreen));
+  fl_window = pre_window;
+  Fl_Surface_Device::end_current();
+}
+
+
+void Fl_Headless_Image_Surface_Driver::translate(int x, int y) {
+  ((Fl_Headless_Graphics_Driver*)driver())->ps_translate(x, y);
+}
+
+
+void Fl_Headless_Image_Surface_Driver::untranslate() {
+  ((Fl_Headless_Graphics_Driver*)driver())->ps_untranslate();
+}
+
+
+Fl_RGB_Image* Fl_Headless_Image_Surface_Driver::image() {
+  int W, H;
+  Fl_Headless_Graphics_Driver::buffer_size((cairo_t*)offscreen, W, H);
+  return Fl_Headless_Graphics_Driver::buffer_image((cairo_t*)offscreen, 0, 0, W, H);
+}
@@ -0,0 +1,201 @@
+//
+// Implementation of the headless screen driver for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include "Fl_Headless_Screen_Driver.H"
+#include "Fl_Headless_Graphics_Driver.H"
+#include "Fl_Headless_Window_Driver.H"
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_RGB_Image.H>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern void fl_trigger_clipboard_notify(int source);
+
+
+/* Returns true when the FLTK_BACKEND environment variable is "headless".
+ The value is read once and cached.
+ */
+bool Fl_Headless_Screen_Driver::requested() {
+  static int value = -1;
+  if (value < 0) {
+    const char *backend = ::getenv("FLTK_BACKEND");
+    value = (backend && strcmp(backend, "headless") == 0) ? 1 : 0;
+  }
+  return value == 1;
+}
+
+
+Fl_Headless_Screen_Driver::Fl_Headless_Screen_Driver() : Fl_Unix_Screen_Driver() {
+  screen_w_ = 1920;
+  screen_h_ = 1080;
+  scale_ = 1;
+  mouse_x_ = mouse_y_ = 0;
+  selection_buffer_[0] = selection_buffer_[1] = NULL;
+  selection_length_[0] = selection_length_[1] = 0;
+  clipboard_image_ = NULL;
+}
+
+
+Fl_Headless_Screen_Driver::~Fl_Headless_Screen_Driver() {
+  delete[] selection_buffer_[0];
+  delete[] selection_buffer_[1];
+  delete clipboard_image_;
+}
+
+
+void Fl_Headless_Screen_Driver::init() {
+  num_screens = 1;
+  const char *size = ::getenv("FLTK_HEADLESS_SIZE");
+  int W, H;
+  if (size && sscanf(size, "%dx%d", &W, &H) == 2 && W > 0 && H > 0) {
+    screen_w_ = W;
+    screen_h_ = H;
+  }
+}
+
+
+void Fl_Headless_Screen_Driver::screen_xywh(int &X, int &Y, int &W, int &H, int n) {
+  if (num_screens < 0) init();
+  X = 0;
+  Y = 0;
+  W = int(screen_w_ / scale_);
+  H = int(screen_h_ / scale_);
+}
+
+
+void Fl_Headless_Screen_Driver::screen_work_area(int &X, int &Y, int &W, int &H, int n) {
+  screen_xywh(X, Y, W, H, n);
+}
+
+
+void Fl_Headless_Screen_Driver::screen_dpi(float &h, float &v, int n) {
+  h = v = 96.0f;
+}
+
+
+int Fl_Headless_Screen_Driver::compose(int &del) {
+  unsigned char ascii = (unsigned char)Fl::e_text[0];
+  if ((Fl::e_state & (FL_ALT | FL_META | FL_CTRL)) && !(ascii & 128)) {
+    del = 0; // this stuff is to be treated as a function key
+    return 0;
+  }
+  del = Fl::compose_state;
+  Fl::compose_state = 0;
+  // Only insert non-control characters:
+  if (! (ascii & ~31 && ascii != 127)) return 0;
+  return 1;
+}
+
+
+int Fl_Headless_Screen_Driver::get_mouse(int &x, int &y) {
+  x = mouse_x_;
+  y = mouse_y_;
+  return 0;
+}
+
+
+void Fl_Headless_Screen_Driver::copy(const char *stuff, int len, int clipboard, const char *type) {
+  if (!stuff || len < 0) return;
+  if (clipboard >= 2) clipboard = 1;
+  if (clipboard < 0) clipboard = 0;
+  delete[] selection_buffer_[clipboard];
+  selection_buffer_[clipboard] = new char[len + 1];
+  memcpy(selection_buffer_[clipboard], stuff, len);
+  selection_buffer_[clipboard][len] = 0;
+  selection_length_[clipboard] = len;
+  if (clipboard == 1 && clipboard_image_) {
+    delete clipboard_image_;
+    clipboard_image_ = NULL;
+  }
+  fl_trigger_clipboard_notify(clipboard);
+}
+
+
+// Takes ownership of rgb, which becomes the content of the clipboard
+void Fl_Headless_Screen_Driver::copy_image(Fl_RGB_Image *rgb) {
+  delete clipboard_image_;
+  clipboard_image_ = rgb;
+  delete[] selection_buffer_[1];
+  selection_buffer_[1] = NULL;
+  selection_length_[1] = 0;
+  fl_trigger_clipboard_notify(1);
+}
+
+
+void Fl_Headless_Screen_Driver::paste(Fl_Widget &receiver, int clipboard, const char *type) {
+  if (clipboard >= 2) clipboard = 1;
+  if (clipboard < 0) clipboard = 0;
+  if (type == Fl::clipboard_plain_text && selection_buffer_[clipboard]) {
+    Fl::e_text = selection_buffer_[clipboard];
+    Fl::e_length = selection_length_[clipboard];
+    Fl::e_clipboard_type = Fl::clipboard_plain_text;
+    receiver.handle(FL_PASTE);
+  } else if (type == Fl::clipboard_image && clipboard == 1 && clipboard_image_) {
+    Fl_RGB_Image *rgb = (Fl_RGB_Image*)clipboard_image_->copy();
+    Fl::e_clipboard_data = rgb;
+    Fl::e_clipboard_type = Fl::clipboard_image;
+    int done = receiver.handle(FL_PASTE);
+    Fl::e_clipboard_type = "";
+    if (done == 0) {
+      delete rgb;
+      Fl::e_clipboard_data = NULL;
+    }
+  }
+}
+
+
+int Fl_Headless_Screen_Driver::clipboard_contains(const char *type) {
+  if (type == Fl::clipboard_plain_text) return selection_buffer_[1] != NULL;
+  if (type == Fl::clipboard_image) return clipboard_image_ != NULL;
+  return 0;
+}
+
+
+Fl_RGB_Image *Fl_Headless_Screen_Driver::read_win_rectangle(int X, int Y, int w, int h,
+                                                            Fl_Window *win,
+                                                            bool, bool *) {
+  cairo_t *buffer;
+  float s;
+  if (win) {
+    buffer = Fl_Headless_Window_Driver::driver(win)->buffer();
+    s = scale_;
+  } else {
+    Fl_Image_Surface_Driver *dr = (Fl_Image_Surface_Driver*)Fl_Surface_Device::surface();
+    buffer = (cairo_t*)dr->image_surface()->offscreen();
+    s = dr->driver()->scale();
+  }
+  if (!buffer) return NULL;
+  int Xs, Ys, ws, hs;
+  if (s == 1) {
+    Xs = X; Ys = Y; ws = w; hs = h;
+  } else {
+    Xs = Fl_Scalable_Graphics_Driver::floor(X, s);
+    Ys = Fl_Scalable_Graphics_Driver::floor(Y, s);
+    ws = Fl_Scalable_Graphics_Driver::floor(X+w, s) - Xs;
+    hs = Fl_Scalable_Graphics_Driver::floor(Y+h, s) - Ys;
+  }
+  // subwindows have their own buffer and are composited by
+  // Fl_Screen_Driver::traverse_to_gl_subwindows()
+  return Fl_Headless_Graphics_Driver::buffer_image(buffer, Xs, Ys, ws, hs);
+}
+
+
+void Fl_Headless_Screen_Driver::offscreen_size(Fl_Offscreen off, int &width, int &height) {
+  Fl_Headless_Graphics_Driver::buffer_size((cairo_t*)off, width, height);
+}
@@ -0,0 +1,140 @@
+//
+// Implementation of the headless window driver for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+#include <FL/platform.H>
+#include "Fl_Headless_Window_Driver.H"
+#include "Fl_Headless_Graphics_Driver.H"
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
+#include <FL/fl_ask.H>
+
+
+Fl_Headless_Window_Driver::Fl_Headless_Window_Driver(Fl_Window *win) : Fl_Window_Driver(win) {
+  buffer_ = NULL;
+}
+
+
+Fl_Headless_Window_Driver::~Fl_Headless_Window_Driver() {
+  delete_buffer();
+}
+
+
+void Fl_Headless_Window_Driver::delete_buffer() {
+  if (buffer_) {
+    if (fl_window == (Window)buffer_) fl_window = 0;
+    Fl_Headless_Graphics_Driver::delete_buffer(buffer_);
+    buffer_ = NULL;
+  }
+}
+
+
+void Fl_Headless_Window_Driver::makeWindow() {
+  float s = Fl::screen_scale(0);
+  buffer_ = Fl_Headless_Graphics_Driver::create_buffer(int(w() * s), int(h() * s));
+  Fl_X *xp = new Fl_X;
+  xp->xid = (fl_uintptr_t)buffer_;
+  other_xid = 0;
+  xp->w = pWindow;
+  flx(xp);
+  xp->region = 0;
+  if (!pWindow->parent()) {
+    xp->next = Fl_X::first;
+    Fl_X::first = xp;
+  } else if (Fl_X::first) {
+    xp->next = Fl_X::first->next;
+    Fl_X::first->next = xp;
+  } else {
+    xp->next = NULL;
+    Fl_X::first = xp;
+  }
+  if (pWindow->modal()) Fl::modal_ = pWindow;
+  screen_num_ = 0;
+  wait_for_expose_value = 0; // there is no expose event to wait for
+  pWindow->set_visible();
+  int old_event = Fl::e_number;
+  pWindow->redraw();
+  pWindow->handle(Fl::e_number = FL_SHOW); // get child windows to appear
+  Fl::e_number = old_event;
+}
+
+
+void Fl_Headless_Window_Driver::show() {
+  if (!shown()) {
+    fl_open_display();
+    makeWindow();
+  } else {
+    Fl::handle(FL_SHOW, pWindow);
+  }
+}
+
+
+void Fl_Headless_Window_Driver::hide() {
+  Fl_X* ip = Fl_X::flx(pWindow);
+  if (hide_common()) return;
+  if (ip->region) {
+    Fl_Graphics_Driver::default_driver().XDestroyRegion(ip->region);
+    ip->region = 0;
+  }
+  screen_num_ = -1;
+  delete_buffer();
+  delete ip;
+}
+
+
+void Fl_Headless_Window_Driver::map() {
+  pWindow->set_visible();
+  pWindow->redraw();
+}
+
+
+void Fl_Headless_Window_Driver::unmap() {
+  pWindow->clear_visible();
+}
+
+
+void Fl_Headless_Window_Driver::resize(int X, int Y, int W, int H) {
+  int is_a_resize = (W != w() || H != h() || Fl_Window::is_a_rescale());
+  if (X != x() || Y != y()) force_position(1);
+  else if (!is_a_resize) return;
+  if (is_a_resize) {
+    pWindow->Fl_Group::resize(X, Y, W, H);
+    if (buffer_) {
+      float s = Fl::screen_scale(0);
+      int bw, bh;
+      Fl_Headless_Graphics_Driver::buffer_size(buffer_, bw, bh);
+      if (bw != int(W * s) || bh != int(H * s)) {
+        delete_buffer();
+        buffer_ = Fl_Headless_Graphics_Driver::create_buffer(int(W * s), int(H * s));
+        Fl_X::flx(pWindow)->xid = (fl_uintptr_t)buffer_;
+      }
+    }
+    if (shown()) pWindow->redraw();
+  } else {
+    pWindow->Fl_Widget::resize(X, Y, W, H);
+  }
+}
+
+
+void Fl_Headless_Window_Driver::make_current() {
+  if (!shown()) {
+    static const char err_message[] = "Fl_Window::make_current(), but window is not shown().";
+    fl_alert(err_message);
+    Fl::fatal(err_message);
+  }
+  fl_window = (Window)buffer_;
+  fl_graphics_driver->clip_region(0);
+  ((Fl_Cairo_Graphics_Driver*)fl_graphics_driver)->set_cairo(buffer_, Fl::screen_scale(0));
+}
@@ -70,6 +70,8 @@ public:
   Fl_SVG_Graphics_Driver(FILE*);
   ~Fl_SVG_Graphics_Driver();
   FILE* file() {return out_;}
+  // vector output, like the PostScript driver
+  int has_feature(driver_feature mask) FL_OVERRIDE { return mask & PRINTER; }
 protected:
   void rect(int x, int y, int w, int h) FL_OVERRIDE;
   void rectf(int x, int y, int w, int h) FL_OVERRIDE;
@@ -796,11 +796,11 @@ double Fl_Unix_System_Driver::wait(double time_to_wait)
   if (time_to_wait <= 0.0) {
     // do flush second so that the results of events are visible:
     int ret = scr_dr->poll_or_select_with_delay(0.0);
-    Fl::flush();
+    Fl::flush_frame();
     return ret;
   } else {
     // do flush first so that user sees the display:
-    Fl::flush();
+    Fl::flush_frame();
     if (Fl::idle) // 'idle' may have been set within flush()
       time_to_wait = 0.0;
     else {
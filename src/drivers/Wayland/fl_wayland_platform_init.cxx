@@ -21,6 +21,11 @@
 #include "../Unix/Fl_Unix_System_Driver.H"
 #include "Fl_Wayland_Window_Driver.H"
 #include "Fl_Wayland_Image_Surface_Driver.H"
+#include "../Headless/Fl_Headless_Copy_Surface_Driver.H"
+#include "../Headless/Fl_Headless_Graphics_Driver.H"
+#include "../Headless/Fl_Headless_Screen_Driver.H"
+#include "../Headless/Fl_Headless_Window_Driver.H"
+#include "../Headless/Fl_Headless_Image_Surface_Driver.H"
 #ifdef FLTK_USE_X11
 #  include "../Xlib/Fl_Xlib_Copy_Surface_Driver.H"
 #  include "../Cairo/Fl_X11_Cairo_Graphics_Driver.H"
@@ -94,6 +99,7 @@ Fl_System_Driver *Fl_System_Driver::newSystemDriver() {
 
 
 Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver() {
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Graphics_Driver();
 #ifdef FLTK_USE_X11
   if (!attempt_wayland()) return new Fl_X11_Cairo_Graphics_Driver();
 #endif
@@ -102,6 +108,7 @@ Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver() {
 
 
 Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int h) {
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Copy_Surface_Driver(w, h);
 #ifdef FLTK_USE_X11
   if (!Fl_Wayland_Screen_Driver::wl_display) return new Fl_Xlib_Copy_Surface_Driver(w, h);
 #endif
@@ -111,6 +118,7 @@ Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int
 
 Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver() {
   if (!Fl_Screen_Driver::system_driver) Fl::system_driver();
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Screen_Driver();
 #ifdef FLTK_USE_X11
   if (attempt_wayland()) {
     return new Fl_Wayland_Screen_Driver();
@@ -128,6 +136,7 @@ Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver() {
 
 Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 {
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Window_Driver(w);
 #ifdef FLTK_USE_X11
   if (!attempt_wayland()) return new Fl_X11_Window_Driver(w);
 #endif
@@ -137,6 +146,8 @@ Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 
 Fl_Image_Surface_Driver *Fl_Image_Surface_Driver::newImageSurfaceDriver(int w, int h, int high_res, Fl_Offscreen off)
 {
+  if (Fl_Headless_Screen_Driver::requested())
+    return new Fl_Headless_Image_Surface_Driver(w, h, high_res, off);
 #ifdef FLTK_USE_X11
   if (!attempt_wayland())
     return new Fl_Xlib_Image_Surface_Driver(w, h, high_res, off);
@@ -24,6 +24,9 @@
 #if ! USE_XFT
 #  include "../Xlib/Fl_Font.H"
 #endif
+#if !FLTK_USE_CAIRO
+#  include "../Xlib/Fl_Xlib_Graphics_Driver.H"
+#endif
 
 
 // Describes crap needed to create a GLContext.
@@ -380,6 +383,9 @@ void Fl_X11_Gl_Window_Driver::gl_visual(Fl_Gl_Choice *c) {
 }
 
 void Fl_X11_Gl_Window_Driver::gl_start() {
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch(); // glXWaitX() only waits for sent requests
+#endif
   glXWaitX();
 }
 
@@ -19,6 +19,9 @@
 #include "Fl_X11_Screen_Driver.H"
 #include "Fl_X11_Window_Driver.H"
 #include "../Posix/Fl_Posix_System_Driver.H"
+#if !FLTK_USE_CAIRO
+#  include "../Xlib/Fl_Xlib_Graphics_Driver.H"
+#endif
 #include <FL/Fl.H>
 #include <FL/platform.H>
 #include <FL/fl_ask.H>
@@ -435,8 +438,13 @@ void Fl_X11_Screen_Driver::beep(int type)
 
 void Fl_X11_Screen_Driver::flush()
 {
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch();
+#endif
   if (fl_display)
     XFlush(fl_display);
+  if (deferred_setup_pending && Fl::frame_stats().frames)
+    deferred_setup();
 }
 
 
@@ -670,6 +678,9 @@ Fl_RGB_Image *Fl_X11_Screen_Driver::read_win_rectangle(int X, int Y, int w, int
   int allow_outside = w < 0;    // negative w allows negative X or Y, that is, window frame
   if (w < 0) w = - w;
   Window xid = (win && !allow_outside ? fl_xid(win) : fl_window);
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch();
+#endif
 
   float s = allow_outside ? 1 : Fl_Surface_Device::surface()->driver()->scale();
   int Xs = Fl_Scalable_Graphics_Driver::floor(X, s);
@@ -440,6 +440,9 @@ void Fl_X11_Window_Driver::hide() {
     cairo_ = NULL;
   }
 # endif
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch(); // before pending drawing becomes invalid
+#endif
   // this test makes sure ip->xid has not been destroyed already
   if (ip->xid) XDestroyWindow(fl_display, ip->xid);
   delete ip;
@@ -528,6 +531,9 @@ int Fl_X11_Window_Driver::scroll(int src_x, int src_y, int src_w, int src_h, int
                                  void (*draw_area)(void*, int,int,int,int), void* data)
 {
   float s = Fl::screen_driver()->scale(screen_num());
+#if !FLTK_USE_CAIRO
+  Fl_Xlib_Graphics_Driver::flush_batch(); // copy pixels only after pending drawing
+#endif
   XCopyArea(fl_display, fl_window, fl_window, (GC)fl_graphics_driver->gc(),
             int(src_x*s), int(src_y*s), int(src_w*s), int(src_h*s), int(dest_x*s), int(dest_y*s));
   // we have to sync the display and get the GraphicsExpose events! (sigh)
@@ -26,10 +26,20 @@
 #include "../Unix/Fl_Unix_System_Driver.H"
 #include "Fl_X11_Window_Driver.H"
 #include "../Xlib/Fl_Xlib_Image_Surface_Driver.H"
+#if FLTK_USE_CAIRO
+#  include "../Headless/Fl_Headless_Copy_Surface_Driver.H"
+#  include "../Headless/Fl_Headless_Graphics_Driver.H"
+#  include "../Headless/Fl_Headless_Screen_Driver.H"
+#  include "../Headless/Fl_Headless_Window_Driver.H"
+#  include "../Headless/Fl_Headless_Image_Surface_Driver.H"
+#endif
 
 
 Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int h)
 {
+#if FLTK_USE_CAIRO
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Copy_Surface_Driver(w, h);
+#endif
   return new Fl_Xlib_Copy_Surface_Driver(w, h);
 }
 
@@ -37,6 +47,7 @@ Fl_Copy_Surface_Driver *Fl_Copy_Surface_Driver::newCopySurfaceDriver(int w, int
 Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver()
 {
 #if FLTK_USE_CAIRO
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Graphics_Driver();
   return new Fl_X11_Cairo_Graphics_Driver();
 #else
   return new Fl_Xlib_Graphics_Driver();
@@ -46,6 +57,9 @@ Fl_Graphics_Driver *Fl_Graphics_Driver::newMainGraphicsDriver()
 
 Fl_Screen_Driver *Fl_Screen_Driver::newScreenDriver()
 {
+#if FLTK_USE_CAIRO
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Screen_Driver();
+#endif
   Fl_X11_Screen_Driver *d = new Fl_X11_Screen_Driver();
 #if USE_XFT
   for (int i = 0;  i < MAX_SCREENS; i++) d->screens[i].scale = 1;
@@ -65,11 +79,18 @@ Fl_System_Driver *Fl_System_Driver::newSystemDriver()
 
 Fl_Window_Driver *Fl_Window_Driver::newWindowDriver(Fl_Window *w)
 {
+#if FLTK_USE_CAIRO
+  if (Fl_Headless_Screen_Driver::requested()) return new Fl_Headless_Window_Driver(w);
+#endif
   return new Fl_X11_Window_Driver(w);
 }
 
 
 Fl_Image_Surface_Driver *Fl_Image_Surface_Driver::newImageSurfaceDriver(int w, int h, int high_res, Fl_Offscreen off)
 {
+#if FLTK_USE_CAIRO
+  if (Fl_Headless_Screen_Driver::requested())
+    return new Fl_Headless_Image_Surface_Driver(w, h, high_res, off);
+#endif
   return new Fl_Xlib_Image_Surface_Driver(w, h, high_res, off);
 }
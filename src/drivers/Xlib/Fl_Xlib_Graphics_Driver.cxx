@@ -38,7 +38,12 @@ int Fl_Xlib_Graphics_Driver::fl_overlay = 0;
  */
 GC fl_gc = 0;
 
-GC fl_x11_gc() { return fl_gc; }
+// Direct Xlib drawing with this GC must not be reordered with respect to
+// batched FLTK drawing, hence the pending batch is sent first.
+GC fl_x11_gc() {
+  Fl_Xlib_Graphics_Driver::flush_batch();
+  return fl_gc;
+}
 
 Fl_Xlib_Graphics_Driver::Fl_Xlib_Graphics_Driver(void) {
   mask_bitmap_ = NULL;
@@ -57,6 +62,7 @@ Fl_Xlib_Graphics_Driver::~Fl_Xlib_Graphics_Driver() {
 
 
 void Fl_Xlib_Graphics_Driver::gc(void *value) {
+  flush_batch();
   gc_ = (GC)value;
   fl_gc = gc_;
 }
@@ -73,6 +79,7 @@ void Fl_Xlib_Graphics_Driver::scale(float f) {
 }
 
 void Fl_Xlib_Graphics_Driver::copy_offscreen(int x, int y, int w, int h, Fl_Offscreen pixmap, int srcx, int srcy) {
+  flush_batch();
   XCopyArea(fl_display, (Pixmap)pixmap, fl_window, gc_, srcx*scale(), srcy*scale(), w*scale(), h*scale(), (x+offset_x_)*scale(), (y+offset_y_)*scale());
 
 }
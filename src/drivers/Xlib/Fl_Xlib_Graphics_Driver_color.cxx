@@ -102,6 +102,7 @@ void Fl_Xlib_Graphics_Driver::color(Fl_Color i) {
   } else {
     Fl_Graphics_Driver::color(i);
     if(!gc_) return; // don't get a default gc if current window is not yet created/valid
+    flush_batch();
     XSetForeground(fl_display, gc_, fl_xpixel(i));
   }
 }
@@ -109,6 +110,7 @@ void Fl_Xlib_Graphics_Driver::color(Fl_Color i) {
 void Fl_Xlib_Graphics_Driver::color(uchar r,uchar g,uchar b) {
   Fl_Graphics_Driver::color( fl_rgb_color(r, g, b) );
   if(!gc_) return; // don't get a default gc if current window is not yet created/valid
+  flush_batch();
   XSetForeground(fl_display, gc_, fl_xpixel(r,g,b));
 }
 
@@ -659,6 +659,7 @@ void Fl_Xlib_Graphics_Driver::draw_unscaled(const char* c, int n, int x, int y)
   int y1 = y + offset_y_;
   if (y1 < clip_min() || y1 > clip_max()) return;
 
+  flush_batch();
   if (font_gc != gc_) {
     if (!font_descriptor()) this->font(FL_HELVETICA, FL_NORMAL_SIZE);
     font_gc = gc_;
@@ -694,6 +695,7 @@ void Fl_Xlib_Graphics_Driver::rtl_draw_unscaled(const char* c, int n, int x, int
   int y1 = y + offset_y_;
   if (y1 < clip_min() || y1 > clip_max()) return;
 
+  flush_batch();
   if (font_gc != gc_) {
     if (!font_descriptor()) this->font(FL_HELVETICA, FL_NORMAL_SIZE);
     font_gc = gc_;
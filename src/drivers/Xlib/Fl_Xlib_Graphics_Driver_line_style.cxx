@@ -55,6 +55,7 @@ void Fl_Xlib_Graphics_Driver::line_style_unscaled(int style, int width, char* da
   }
   static int Cap[4] = {CapButt, CapButt, CapRound, CapProjecting};
   static int Join[4] = {JoinMiter, JoinMiter, JoinRound, JoinBevel};
+  flush_batch();
   XSetLineAttributes(fl_display, gc_,
                      line_width_,
                      ndashes ? LineOnOffDash : LineSolid,
@@ -65,6 +66,7 @@ void Fl_Xlib_Graphics_Driver::line_style_unscaled(int style, int width, char* da
 void *Fl_Xlib_Graphics_Driver::change_pen_width(int lwidth) {
   XGCValues *gc_values = (XGCValues*)malloc(sizeof(XGCValues));
   gc_values->line_width = lwidth;
+  flush_batch();
   XChangeGC(fl_display, gc_, GCLineWidth, gc_values);
   gc_values->line_width = line_width_;
   line_width_ = lwidth;
@@ -74,6 +76,7 @@ void *Fl_Xlib_Graphics_Driver::change_pen_width(int lwidth) {
 void Fl_Xlib_Graphics_Driver::reset_pen_width(void *data) {
   XGCValues *gc_values = (XGCValues*)data;
   line_width_ = gc_values->line_width;
+  flush_batch();
   XChangeGC(fl_display, gc_, GCLineWidth, gc_values);
   free(data);
 }
@@ -27,6 +27,77 @@
 
 #include "Fl_Xlib_Graphics_Driver.H"
 
+// --- request batching
+
+/*
+  Filled rectangles (fl_rectf(), fl_point()) and single line segments
+  (fl_line(), fl_xyline(), fl_yxline()) are very frequent, e.g. in grids,
+  charts or when drawing boxes. Instead of sending one X request per
+  primitive they are collected while the target drawable and the GC
+  state remain unchanged, and sent with a single XFillRectangles() or
+  XDrawSegments() request.
+
+  The pending batch is flushed (see flush_batch())
+  - when another kind of primitive is batched,
+  - when the target drawable or GC changes,
+  - when the GC state is about to change (color, line style, clipping),
+  - before any other drawing operation of this driver,
+  - when fl_x11_gc() is called to use Xlib directly, and
+  - when FLTK flushes its output to the X server.
+*/
+
+enum {
+  BATCH_RECTANGLES = 1,
+  BATCH_SEGMENTS
+};
+
+static int batch_type = 0;
+static Window batch_window = 0;
+static GC batch_gc = 0;
+static union {
+  XRectangle rects[FL_XLIB_GRAPHICS_BATCH_SIZE];
+  XSegment segments[FL_XLIB_GRAPHICS_BATCH_SIZE];
+} batch;
+
+int Fl_Xlib_Graphics_Driver::batch_count_ = 0;
+
+void Fl_Xlib_Graphics_Driver::flush_batch_() {
+  int n = batch_count_;
+  batch_count_ = 0;
+  if (batch_type == BATCH_RECTANGLES)
+    XFillRectangles(fl_display, batch_window, batch_gc, batch.rects, n);
+  else
+    XDrawSegments(fl_display, batch_window, batch_gc, batch.segments, n);
+}
+
+// Adds a rectangle in X coordinates (already clipped) to the batch
+void Fl_Xlib_Graphics_Driver::batch_rectangle_(int x, int y, int w, int h) {
+  if (batch_count_ && (batch_type != BATCH_RECTANGLES || batch_window != fl_window ||
+                       batch_gc != gc_ || batch_count_ >= FL_XLIB_GRAPHICS_BATCH_SIZE))
+    flush_batch_();
+  if (!batch_count_) {
+    batch_type = BATCH_RECTANGLES;
+    batch_window = fl_window;
+    batch_gc = gc_;
+  }
+  XRectangle *r = batch.rects + batch_count_++;
+  r->x = x; r->y = y; r->width = w; r->height = h;
+}
+
+// Adds a line segment in X coordinates (already clipped) to the batch
+void Fl_Xlib_Graphics_Driver::batch_segment_(int x1, int y1, int x2, int y2) {
+  if (batch_count_ && (batch_type != BATCH_SEGMENTS || batch_window != fl_window ||
+                       batch_gc != gc_ || batch_count_ >= FL_XLIB_GRAPHICS_BATCH_SIZE))
+    flush_batch_();
+  if (!batch_count_) {
+    batch_type = BATCH_SEGMENTS;
+    batch_window = fl_window;
+    batch_gc = gc_;
+  }
+  XSegment *s = batch.segments + batch_count_++;
+  s->x1 = x1; s->y1 = y1; s->x2 = x2; s->y2 = y2;
+}
+
 // Arbitrary line clipping: clip line end points to 16-bit coordinate range.
 
 // We clip at +/- 16-bit boundaries (+/- (2**15-K)) where K currently is 8
@@ -214,6 +285,7 @@ void Fl_Xlib_Graphics_Driver::focus_rect(int x, int y, int w, int h) {
   x = this->floor(x) + floor(offset_x_);
   y = this->floor(y) + floor(offset_y_);
   if (!clip_rect(x, y, w, h)) {
+    flush_batch();
     int lw_save = line_width_;       // preserve current line_width
     if (line_width_ == 0)
       line_style(FL_DOT, 1);
@@ -230,6 +302,7 @@ void Fl_Xlib_Graphics_Driver::focus_rect(int x, int y, int w, int h) {
 void Fl_Xlib_Graphics_Driver::rect_unscaled(int x, int y, int w, int h) {
   void *old = NULL;
   if (line_width_ == 0) old = change_pen_width(1); // #156, #1052
+  flush_batch();
   XDrawRectangle(fl_display, fl_window, gc_, x, y, w, h);
   if (old) reset_pen_width(old);
 }
@@ -238,7 +311,7 @@ void Fl_Xlib_Graphics_Driver::rectf_unscaled(int x, int y, int w, int h) {
   x += floor(offset_x_);
   y += floor(offset_y_);
   if (!clip_rect(x, y, w, h))
-    XFillRectangle(fl_display, fl_window, gc_, x, y, w, h);
+    batch_rectangle_(x, y, w, h);
 }
 
 void Fl_Xlib_Graphics_Driver::line_unscaled(int x, int y, int x1, int y1) {
@@ -254,6 +327,7 @@ void Fl_Xlib_Graphics_Driver::line_unscaled(int x, int y, int x1, int y1, int x2
     p[0].x = x + x_offset;  p[0].y = y + y_offset;
     p[1].x = x1 + x_offset; p[1].y = y1 + y_offset;
     p[2].x = x2 + x_offset; p[2].y = y2 + y_offset;
+    flush_batch();
     XDrawLines(fl_display, fl_window, gc_, p, 3, 0);
   }
 }
@@ -281,6 +355,7 @@ void Fl_Xlib_Graphics_Driver::loop_unscaled(int x, int y, int x1, int y1, int x2
   p[2].x = x2 + floor(offset_x_) ; p[2].y = y2 + floor(offset_y_) ;
   p[3].x = p[0].x;  p[3].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XDrawLines(fl_display, fl_window, gc_, p, 4, 0);
 }
 
@@ -292,6 +367,7 @@ void Fl_Xlib_Graphics_Driver::loop_unscaled(int x, int y, int x1, int y1, int x2
   p[3].x = x3 + floor(offset_x_) ; p[3].y = y3 + floor(offset_y_) ;
   p[4].x = p[0].x;  p[4].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XDrawLines(fl_display, fl_window, gc_, p, 5, 0);
 }
 
@@ -302,6 +378,7 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
   p[2].x = x2 + floor(offset_x_) ; p[2].y = y2 + floor(offset_y_) ;
   p[3].x = p[0].x;  p[3].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XFillPolygon(fl_display, fl_window, gc_, p, 3, Convex, 0);
   XDrawLines(fl_display, fl_window, gc_, p, 4, 0);
 }
@@ -314,6 +391,7 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
   p[3].x = x3 + floor(offset_x_) ; p[3].y = y3 + floor(offset_y_) ;
   p[4].x = p[0].x;  p[4].y = p[0].y;
   // *FIXME* This needs X coordinate clipping!
+  flush_batch();
   XFillPolygon(fl_display, fl_window, gc_, p, 4, Convex, 0);
   XDrawLines(fl_display, fl_window, gc_, p, 5, 0);
 }
@@ -322,10 +400,11 @@ void Fl_Xlib_Graphics_Driver::polygon_unscaled(int x, int y, int x1, int y1, int
 
 // Draw an arbitrary line with coordinates clipped to the X coordinate space.
 // This draws nothing if the line is entirely outside the X coordinate space.
+// The line is batched with other line segments, see batch_segment_().
 
 void Fl_Xlib_Graphics_Driver::draw_clipped_line(int x1, int y1, int x2, int y2) {
   if (!clip_line(x1, y1, x2, y2))
-    XDrawLine(fl_display, fl_window, gc_, x1, y1, x2, y2);
+    batch_segment_(x1, y1, x2, y2);
 }
 
 // --- clipping
@@ -392,6 +471,7 @@ int Fl_Xlib_Graphics_Driver::not_clipped(int x, int y, int w, int h) {
 }
 
 void Fl_Xlib_Graphics_Driver::restore_clip() {
+  flush_batch();
   fl_clip_state_number++;
   if (gc_) {
     Region r = (Region)rstack[rstackptr];
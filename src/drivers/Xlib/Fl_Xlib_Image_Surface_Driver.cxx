@@ -67,6 +67,7 @@ Fl_Xlib_Image_Surface_Driver::~Fl_Xlib_Image_Surface_Driver() {
   }
   cairo_destroy(cairo_);
 #else
+  Fl_Xlib_Graphics_Driver::flush_batch();
   if (shape_data_) {
     XFreePixmap(fl_display, shape_data_->background);
     delete shape_data_->mask;
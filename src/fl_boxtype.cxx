@@ -26,7 +26,11 @@
 #include <FL/Fl.H>
 #include <FL/Fl_Widget.H>
 #include <FL/fl_draw.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/Fl_Graphics_Driver.H>
 #include <config.h>
+#include <stdlib.h>
 
 ////////////////////////////////////////////////////////////////
 
@@ -48,6 +52,7 @@ static int draw_it_active = 1;
 
 int Fl::box_border_radius_max_ = 15;
 int Fl::box_shadow_width_ = 3;
+long Fl::box_cache_size_ = 4 * 1024 * 1024;
 
 /**
   Determines if the currently drawn box is active or inactive.
@@ -289,6 +294,7 @@ static struct {
   uchar dx, dy, dw, dh;
   int set;
   Fl_Box_Draw_Focus_F *ff;
+  int cache;    // boxes of this type may be drawn from the box cache
 } fl_box_table[FL_MAX_BOXTYPE+1] = {
   // must match list in Enumerations.H!!!
   {fl_no_box,           0,0,0,0,1},
@@ -426,6 +432,12 @@ void fl_internal_boxtype(Fl_Boxtype t, Fl_Box_Draw_F* f, Fl_Box_Draw_Focus_F* ff
   }
 }
 
+// Allows boxes of type t to be drawn from the box cache, unless the
+// application has replaced its drawing function f
+void fl_cache_boxtype(Fl_Boxtype t, Fl_Box_Draw_F* f) {
+  if (fl_box_table[t].f == f) fl_box_table[t].cache = 1;
+}
+
 /** Gets the current box drawing function for the specified box type. */
 Fl_Box_Draw_F *Fl::get_boxtype(Fl_Boxtype t) {
   return fl_box_table[t].f;
@@ -452,6 +464,7 @@ void Fl::set_boxtype(Fl_Boxtype t, Fl_Box_Draw_F* f,
   fl_box_table[t].dw  = dw;
   fl_box_table[t].dh  = dh;
   fl_box_table[t].ff  = ff;
+  fl_box_table[t].cache = 0;
 }
 
 /** Copies the from boxtype. */
@@ -459,6 +472,196 @@ void Fl::set_boxtype(Fl_Boxtype to, Fl_Boxtype from) {
   fl_box_table[to] = fl_box_table[from];
 }
 
+////////////////////////////////////////////////////////////////
+// Cache of rendered boxes.
+//
+// The box types of the gleam, plastic, gtk+ and oxy schemes draw their
+// gradients line by line, computing a color for each line. A box of such a
+// type that is drawn again with the same size, color and state is rendered
+// once into an RGBA image, which is then drawn instead. At most
+// Fl::box_cache_size() bytes of images are kept; the least recently used
+// images are dropped first.
+
+struct Box_Cache_Entry {
+  Fl_Box_Draw_F *f;
+  int w, h;
+  Fl_Color c;
+  int active;
+  float scale;
+  Fl_RGB_Image *image;  // NULL until the box is drawn a second time
+  long bytes;
+  Box_Cache_Entry *next_in_bucket;
+  Box_Cache_Entry *prev, *next; // most recently used first
+};
+
+static const int box_cache_buckets = 1024;
+static const int box_cache_max_entries = 4096;
+static Box_Cache_Entry *box_cache_table[box_cache_buckets];
+static Box_Cache_Entry *box_cache_first = NULL, *box_cache_last = NULL;
+static int box_cache_entries = 0;
+static long box_cache_bytes = 0;
+
+static unsigned box_cache_hash(Fl_Box_Draw_F *f, int w, int h, Fl_Color c, int active) {
+  unsigned v = (unsigned)(fl_uintptr_t)f;
+  v = v * 31 + (unsigned)w;
+  v = v * 31 + (unsigned)h;
+  v = v * 31 + (unsigned)c;
+  v = v * 31 + (unsigned)active;
+  return (v ^ (v >> 13)) % box_cache_buckets;
+}
+
+static void box_cache_unlink(Box_Cache_Entry *e) {
+  if (e->prev) e->prev->next = e->next; else box_cache_first = e->next;
+  if (e->next) e->next->prev = e->prev; else box_cache_last = e->prev;
+}
+
+static void box_cache_push_front(Box_Cache_Entry *e) {
+  e->prev = NULL;
+  e->next = box_cache_first;
+  if (box_cache_first) box_cache_first->prev = e; else box_cache_last = e;
+  box_cache_first = e;
+}
+
+static void box_cache_remove(Box_Cache_Entry *e) {
+  Box_Cache_Entry **p = box_cache_table +
+    box_cache_hash(e->f, e->w, e->h, e->c, e->active);
+  while (*p != e) p = &(*p)->next_in_bucket;
+  *p = e->next_in_bucket;
+  box_cache_unlink(e);
+  delete e->image;
+  box_cache_bytes -= e->bytes;
+  box_cache_entries--;
+  delete e;
+}
+
+// Drops the least recently used entries until the cache fits its limits
+static void box_cache_trim(long max_bytes) {
+  while (box_cache_last &&
+         (box_cache_bytes > max_bytes || box_cache_entries > box_cache_max_entries))
+    box_cache_remove(box_cache_last);
+}
+
+// Called when colors change, see Fl::set_color()
+void fl_clear_box_cache() {
+  while (box_cache_first) box_cache_remove(box_cache_first);
+}
+
+// Renders a box on a black and on a white background. Pixels that differ
+// between both renderings were not (fully) covered by the box, which
+// gives their alpha value.
+static Fl_RGB_Image *box_cache_render(Fl_Box_Draw_F *f, int w, int h, Fl_Color c) {
+  Fl_Image_Surface *surf = new Fl_Image_Surface(w, h, 1);
+  Fl_Surface_Device::push_current(surf);
+  fl_color(0, 0, 0);
+  fl_rectf(0, 0, w, h);
+  f(0, 0, w, h, c);
+  Fl_RGB_Image *black = surf->image();
+  fl_color(255, 255, 255);
+  fl_rectf(0, 0, w, h);
+  f(0, 0, w, h, c);
+  Fl_RGB_Image *white = surf->image();
+  Fl_Surface_Device::pop_current();
+  delete surf;
+  int pw = black->data_w(), ph = black->data_h(), d = black->d();
+  int ld = black->ld() ? black->ld() : pw * d;
+  Fl_RGB_Image *result = NULL;
+  if (d >= 3 && white->data_w() == pw && white->data_h() == ph && white->d() == d) {
+    uchar *data = new uchar[pw * ph * 4];
+    uchar *q = data;
+    for (int y = 0; y < ph; y++) {
+      const uchar *b = (const uchar*)black->data()[0] + y * ld;
+      const uchar *wh = (const uchar*)white->data()[0] + y * ld;
+      for (int x = 0; x < pw; x++, b += d, wh += d, q += 4) {
+        int diff = 0;
+        for (int k = 0; k < 3; k++) if (wh[k] - b[k] > diff) diff = wh[k] - b[k];
+        int a = 255 - diff;
+        for (int k = 0; k < 3; k++) {
+          int v = a ? (b[k] * 255 + a / 2) / a : 0;
+          q[k] = (uchar)(v > 255 ? 255 : v);
+        }
+        q[3] = (uchar)a;
+      }
+    }
+    result = new Fl_RGB_Image(data, pw, ph, 4);
+    result->alloc_array = 1;
+    result->scale(w, h, 0, 1);
+  }
+  delete black;
+  delete white;
+  return result;
+}
+
+// Draws a box from the cache. Returns false if the box must be drawn by
+// its drawing function.
+static bool box_cache_draw(Fl_Boxtype t, int x, int y, int w, int h, Fl_Color c) {
+  if (!fl_box_table[t].cache || Fl::box_cache_size() <= 0 || w <= 0 || h <= 0)
+    return false;
+  // Bitmaps are no good for printers and vector file formats, and fractional
+  // scaling would move pixels relative to direct drawing.
+  float s = fl_graphics_driver->scale();
+  if (fl_graphics_driver->has_feature(Fl_Graphics_Driver::PRINTER) ||
+      s != int(s) || s != Fl_Graphics_Driver::default_driver().scale() ||
+      !fl_can_do_alpha_blending())
+    return false;
+  Fl_Box_Draw_F *f = fl_box_table[t].f;
+  Box_Cache_Entry **bucket = box_cache_table + box_cache_hash(f, w, h, c, draw_it_active);
+  Box_Cache_Entry *e = *bucket;
+  while (e && (e->f != f || e->w != w || e->h != h || e->c != c ||
+               e->active != draw_it_active || e->scale != s))
+    e = e->next_in_bucket;
+  if (!e) { // first use: remember the box, but draw it directly
+    e = new Box_Cache_Entry;
+    e->f = f; e->w = w; e->h = h; e->c = c;
+    e->active = draw_it_active;
+    e->scale = s;
+    e->image = NULL;
+    e->bytes = 0;
+    e->next_in_bucket = *bucket;
+    *bucket = e;
+    box_cache_push_front(e);
+    box_cache_entries++;
+    box_cache_trim(Fl::box_cache_size());
+    return false;
+  }
+  if (e != box_cache_first) {
+    box_cache_unlink(e);
+    box_cache_push_front(e);
+  }
+  if (!e->image) {
+    long bytes = long(w * s) * long(h * s) * 4;
+    if (bytes > Fl::box_cache_size() / 4) return false; // too large to be worth it
+    e->image = box_cache_render(f, w, h, c);
+    if (!e->image) return false;
+    e->bytes = bytes;
+    box_cache_bytes += bytes;
+    box_cache_trim(Fl::box_cache_size());
+    if (e != box_cache_first) return false; // e was dropped
+  }
+  e->image->draw(x, y);
+  return true;
+}
+
+/**
+  Sets the memory used by the cache of rendered boxes.
+
+  Boxes of the "gleam", "plastic", "gtk+" and "oxy" schemes are drawn as many
+  lines of computed colors. When such a box is drawn again with the same
+  size, color and active state, it is rendered once into an image that is
+  drawn instead, which is much faster for e.g. a toolbar of many buttons.
+  Boxes are only cached on the display and in image surfaces, at integral
+  scaling factors, never when printing.
+
+  \param[in] bytes  maximum size of all cached images in bytes, default 4 MB;
+                    0 disables the cache and frees all cached images
+  \see Fl::set_boxtype(), boxes drawn by application functions are not cached
+  \since 1.4.0
+*/
+void Fl::box_cache_size(long bytes) {
+  box_cache_size_ = bytes > 0 ? bytes : 0;
+  box_cache_trim(box_cache_size_);
+  if (!box_cache_size_) fl_clear_box_cache();
+}
+
 /**
   Draws a box using given type, position, size and color.
   \param[in] t box type
@@ -466,7 +669,8 @@ void Fl::set_boxtype(Fl_Boxtype to, Fl_Boxtype from) {
   \param[in] c color
 */
 void fl_draw_box(Fl_Boxtype t, int x, int y, int w, int h, Fl_Color c) {
-  if (t && fl_box_table[t].f) fl_box_table[t].f(x,y,w,h,c);
+  if (t && fl_box_table[t].f && !box_cache_draw(t, x, y, w, h, c))
+    fl_box_table[t].f(x,y,w,h,c);
 }
 
 /**
@@ -527,6 +731,7 @@ void Fl_Widget::draw_box(Fl_Boxtype t, Fl_Color c) const {
 /** Draws a box of type t, of color c at the position X,Y and size W,H. */
 void Fl_Widget::draw_box(Fl_Boxtype t, int X, int Y, int W, int H, Fl_Color c) const {
   draw_it_active = active_r();
-  fl_box_table[t].f(X, Y, W, H, c);
+  if (!box_cache_draw(t, X, Y, W, H, c))
+    fl_box_table[t].f(X, Y, W, H, c);
   draw_it_active = 1;
 }
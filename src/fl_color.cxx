@@ -80,9 +80,12 @@ void Fl::set_color(Fl_Color i, uchar red, uchar green, uchar blue, uchar alpha)
 }
 
 
+extern void fl_clear_box_cache(); // in fl_boxtype.cxx
+
 void Fl::set_color(Fl_Color i, unsigned c)
 {
   Fl_Graphics_Driver::default_driver().set_color(i, c);
+  fl_clear_box_cache();
 }
 
 
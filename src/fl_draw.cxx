@@ -25,6 +25,7 @@
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
 #include <FL/Fl_Image.H>
+#include <FL/Fl_Graphics_Driver.H>
 #include <FL/platform.H>        // fl_open_display()
 
 #include "flstring.h"
@@ -189,6 +190,167 @@ fl_expand_text(const char* from, char* buf, int maxbuf, double maxw, int& n,
   return expand_text_(from,  buf, maxbuf, maxw,  n, width,  wrap,  draw_symbols);
 }
 
+////////////////////////////////////////////////////////////////
+// Text layout cache.
+//
+// Widgets draw and measure the same labels again and again. Breaking a
+// text into lines gives the expanded text of each line, its width and the
+// position of the underlined shortcut character, if any. These are kept
+// in a small LRU cache keyed by the text and everything that changes its
+// layout, so that redrawing an unchanged label doesn't measure it again.
+
+struct Text_Line {
+  int start;      // offset of the expanded line in Text_Layout::buf
+  int length;     // number of bytes of the expanded line
+  int underline;  // offset of the underlined character in the line, or -1
+  double width;
+};
+
+struct Text_Layout {
+  // key
+  char *text;
+  unsigned hash;
+  Fl_Graphics_Driver *driver;
+  Fl_Font font;
+  Fl_Fontsize size;
+  float scale;
+  double maxw;              // 0 if not wrapped
+  char wrap, draw_symbols, shortcut;
+  // layout
+  int lines;
+  Text_Line *line;
+  char *buf;                // all expanded lines, each nul-terminated
+  bool cached;              // false: delete after use
+  Text_Layout *prev, *next, *next_in_bucket;
+};
+
+static const int layout_buckets = 256;
+static const int layout_max_entries = 512;
+static const size_t layout_max_text = 2048; // longer texts are not cached
+static Text_Layout *layout_table[layout_buckets];
+static Text_Layout *layout_first = NULL, *layout_last = NULL;
+static int layout_entries = 0;
+
+static void layout_delete(Text_Layout *t) {
+  free(t->text);
+  free(t->line);
+  free(t->buf);
+  delete t;
+}
+
+static void layout_unlink(Text_Layout *t) {
+  if (t->prev) t->prev->next = t->next; else layout_first = t->next;
+  if (t->next) t->next->prev = t->prev; else layout_last = t->prev;
+}
+
+static void layout_push_front(Text_Layout *t) {
+  t->prev = NULL;
+  t->next = layout_first;
+  if (layout_first) layout_first->prev = t; else layout_last = t;
+  layout_first = t;
+}
+
+static void layout_remove(Text_Layout *t) {
+  Text_Layout **p = layout_table + t->hash % layout_buckets;
+  while (*p != t) p = &(*p)->next_in_bucket;
+  *p = t->next_in_bucket;
+  layout_unlink(t);
+  layout_entries--;
+  layout_delete(t);
+}
+
+// Called when font metrics may change, see Fl::set_font()
+void fl_clear_text_layout_cache() {
+  while (layout_first) layout_remove(layout_first);
+}
+
+// Called when a graphics driver is deleted, so that its layouts are not
+// reused by a new driver allocated at the same address
+void fl_clear_text_layout_cache(const Fl_Graphics_Driver *driver) {
+  for (Text_Layout *t = layout_first; t; ) {
+    Text_Layout *next = t->next;
+    if (t->driver == driver) layout_remove(t);
+    t = next;
+  }
+}
+
+// Breaks str into lines like fl_draw() does, in the current font
+static Text_Layout *layout_text(const char *str, double maxw, int wrap, int draw_symbols) {
+  if (!wrap) maxw = 0;
+  float scale = fl_graphics_driver->scale();
+  size_t len = strlen(str);
+  unsigned hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) hash = (hash ^ (uchar)str[i]) * 16777619u;
+  hash ^= (unsigned)fl_font() * 31 + (unsigned)fl_size();
+  if (len < layout_max_text) {
+    for (Text_Layout *t = layout_table[hash % layout_buckets]; t; t = t->next_in_bucket) {
+      if (t->hash == hash && t->driver == fl_graphics_driver && t->font == fl_font() &&
+          t->size == fl_size() && t->scale == scale && t->maxw == maxw &&
+          t->wrap == (wrap != 0) && t->draw_symbols == (draw_symbols != 0) &&
+          t->shortcut == fl_draw_shortcut && !strcmp(t->text, str)) {
+        if (t != layout_first) {
+          layout_unlink(t);
+          layout_push_front(t);
+        }
+        return t;
+      }
+    }
+  }
+  Text_Layout *t = new Text_Layout;
+  t->lines = 0;
+  t->line = NULL;
+  t->buf = NULL;
+  int alloc_lines = 0, buf_used = 0, buf_alloc = 0;
+  for (const char *p = str; ; ) {
+    char *linebuf;
+    int buflen;
+    double width;
+    const char *e = expand_text_(p, linebuf, 0, maxw, buflen, width, wrap, draw_symbols);
+    if (t->lines >= alloc_lines) {
+      alloc_lines = alloc_lines ? 2 * alloc_lines : 4;
+      t->line = (Text_Line*)realloc(t->line, alloc_lines * sizeof(Text_Line));
+    }
+    if (buf_used + buflen + 1 > buf_alloc) {
+      buf_alloc = 2 * (buf_used + buflen + 1);
+      t->buf = (char*)realloc(t->buf, buf_alloc);
+    }
+    Text_Line &l = t->line[t->lines++];
+    l.start = buf_used;
+    l.length = buflen;
+    l.width = width;
+    l.underline = (underline_at && underline_at >= linebuf && underline_at < linebuf + buflen) ?
+                  (int)(underline_at - linebuf) : -1;
+    memcpy(t->buf + buf_used, linebuf, buflen + 1);
+    buf_used += buflen + 1;
+    if (!*e || (*e == '@' && e[1] != '@' && draw_symbols)) break;
+    p = e;
+  }
+  t->cached = len < layout_max_text;
+  t->text = NULL;
+  if (!t->cached) return t;
+  t->text = (char*)malloc(len + 1);
+  memcpy(t->text, str, len + 1);
+  t->hash = hash;
+  t->driver = fl_graphics_driver;
+  t->font = fl_font();
+  t->size = fl_size();
+  t->scale = scale;
+  t->maxw = maxw;
+  t->wrap = (wrap != 0);
+  t->draw_symbols = (draw_symbols != 0);
+  t->shortcut = fl_draw_shortcut;
+  Text_Layout **bucket = layout_table + hash % layout_buckets;
+  t->next_in_bucket = *bucket;
+  *bucket = t;
+  layout_push_front(t);
+  if (++layout_entries > layout_max_entries) layout_remove(layout_last);
+  return t;
+}
+
+static void layout_release(Text_Layout *t) {
+  if (!t->cached) layout_delete(t);
+}
+
 // Caution: put the documentation next to the function's declaration in fl_draw.H for Doxygen
 // to see default argument values.
 void fl_draw(
@@ -198,11 +360,8 @@ void fl_draw(
     void (*callthis)(const char*,int,int,int),
     Fl_Image* img, int draw_symbols, int spacing)
 {
-  char *linebuf = NULL;       // Pointer to a buffer managed by expand_text_
+  Text_Layout *layout = NULL; // Lines of the text
   const char* p;              // Scratch pointer into text, multiple use
-  const char* e;              // Scratch pointer into text, multiple use
-  int buflen;                 // Number of bytes copied into linebuf
-                              // by expand_text_
   char symbol[2][255];        // Copy of symbol text at start and end of str
   int symwidth[2];            // Width and height of symbols (always square)
   int symoffset;
@@ -211,7 +370,6 @@ void fl_draw(
   int imgvert = ((align&FL_ALIGN_IMAGE_NEXT_TO_TEXT)==0); // True if image is
                               // above or below text
   int lines;                  // Number of text lines including '\n' and wrapping
-  double width;               // width of the longest text line
   int height = fl_height();   // Height of a line of text
 
 
@@ -250,16 +408,12 @@ void fl_draw(
   int strw = 0;               // Width of text only without symbols
   int strh;                   // Height of text only without symbols
 
-  // Count how many lines and put the last one into the buffer:
+  // Break the text into lines and find the widest one:
   if (str) {
-    for (p = str, lines=0; p;) {
-      e = expand_text_(p, linebuf, 0, w - symtotal - imgtotal, buflen, width,
-                         align&FL_ALIGN_WRAP, draw_symbols);
-      if (strw<width) strw = (int)width;
-      lines++;
-      if (!*e || (*e == '@' && e[1] != '@' && draw_symbols)) break;
-      p = e;
-    }
+    layout = layout_text(str, w - symtotal - imgtotal, align&FL_ALIGN_WRAP, draw_symbols);
+    lines = layout->lines;
+    for (int i = 0; i < lines; i++)
+      if (strw < layout->line[i].width) strw = (int)layout->line[i].width;
   } else lines = 0;
 
   // Fix the size of the symbols if there is at least one line of text to print
@@ -348,13 +502,11 @@ void fl_draw(
   // Now draw all the text lines
   if (str) {
     int desc = fl_descent();
-    for (p=str; ; ypos += height) {
-      if (lines>1) {
-        e = expand_text_(p, linebuf, 0, w - symtotal - imgtotal, buflen,
-                         width, align&FL_ALIGN_WRAP, draw_symbols);
-      } else {
-        e = "";
-      }
+    for (int i = 0; i < lines; i++) {
+      if (i) ypos += height;
+      const Text_Line &line = layout->line[i];
+      const char *linebuf = layout->buf + line.start;
+      double width = line.width;
 
       if (width > symoffset) symoffset = (int)(width + 0.5);
 
@@ -366,14 +518,12 @@ void fl_draw(
         xpos = x + (w - (int)(width + .5) - symtotal - imgw[0] - imgw[1]) / 2 + symwidth[0] + imgw[0];
       }
 
-      callthis(linebuf,buflen,xpos,ypos-desc);
+      callthis(linebuf,line.length,xpos,ypos-desc);
 
-      if (underline_at && underline_at >= linebuf && underline_at < (linebuf + buflen))
-        callthis("_",1,xpos+int(fl_width(linebuf,(int) (underline_at-linebuf))),ypos-desc);
-
-      if (!*e || (*e == '@' && e[1] != '@')) break;
-      p = e;
+      if (line.underline >= 0)
+        callthis("_",1,xpos+int(fl_width(linebuf,line.underline)),ypos-desc);
     }
+    layout_release(layout);
   }
 
   // Draw the image if the image is *below* the text
@@ -487,12 +637,8 @@ void fl_draw(
 void fl_measure(const char* str, int& w, int& h, int draw_symbols) {
   if (!str || !*str) {w = 0; h = 0; return;}
   h = fl_height();
-  char *linebuf = NULL;
   const char* p;
-  const char* e;
-  int buflen;
   int lines;
-  double width=0;
   int W = 0;
   int symwidth[2], symtotal;
 
@@ -516,15 +662,11 @@ void fl_measure(const char* str, int& w, int& h, int draw_symbols) {
 
   symtotal = symwidth[0] + symwidth[1];
 
-  for (p = str, lines=0; p;) {
-//    e = expand(p, linebuf, w - symtotal, buflen, width, w != 0, draw_symbols);
-    e = expand_text_(p, linebuf, 0, w - symtotal, buflen, width,
-                        w != 0, draw_symbols);
-    if ((int)ceil(width) > W) W = (int)ceil(width);
-    lines++;
-    if (!*e || (*e == '@' && e[1] != '@' && draw_symbols)) break;
-    p = e;
-  }
+  Text_Layout *layout = layout_text(str, w - symtotal, w != 0, draw_symbols);
+  lines = layout->lines;
+  for (int i = 0; i < lines; i++)
+    if ((int)ceil(layout->line[i].width) > W) W = (int)ceil(layout->line[i].width);
+  layout_release(layout);
 
   if ((symwidth[0] || symwidth[1]) && lines) {
     if (symwidth[0]) symwidth[0] = lines * fl_height();
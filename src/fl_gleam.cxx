@@ -165,6 +165,7 @@ static void thin_down_box(int x, int y, int w, int h, Fl_Color c) {
 }
 
 extern void fl_internal_boxtype(Fl_Boxtype, Fl_Box_Draw_F*, Fl_Box_Draw_Focus_F* =NULL);
+extern void fl_cache_boxtype(Fl_Boxtype, Fl_Box_Draw_F*);
 
 Fl_Boxtype fl_define_FL_GLEAM_UP_BOX() {
   fl_internal_boxtype(_FL_GLEAM_UP_BOX, up_box);
@@ -175,5 +176,11 @@ Fl_Boxtype fl_define_FL_GLEAM_UP_BOX() {
   fl_internal_boxtype(_FL_GLEAM_THIN_DOWN_BOX, thin_down_box);
   fl_internal_boxtype(_FL_GLEAM_ROUND_UP_BOX, up_box);
   fl_internal_boxtype(_FL_GLEAM_ROUND_DOWN_BOX, down_box);
+  fl_cache_boxtype(_FL_GLEAM_UP_BOX, up_box);
+  fl_cache_boxtype(_FL_GLEAM_DOWN_BOX, down_box);
+  fl_cache_boxtype(_FL_GLEAM_THIN_UP_BOX, thin_up_box);
+  fl_cache_boxtype(_FL_GLEAM_THIN_DOWN_BOX, thin_down_box);
+  fl_cache_boxtype(_FL_GLEAM_ROUND_UP_BOX, up_box);
+  fl_cache_boxtype(_FL_GLEAM_ROUND_DOWN_BOX, down_box);
   return _FL_GLEAM_UP_BOX;
 }
@@ -25,6 +25,7 @@
 #include <FL/fl_draw.H>
 
 extern void fl_internal_boxtype(Fl_Boxtype, Fl_Box_Draw_F*, Fl_Box_Draw_Focus_F* =NULL);
+extern void fl_cache_boxtype(Fl_Boxtype, Fl_Box_Draw_F*);
 
 
 static void gtk_color(Fl_Color c) {
@@ -296,6 +297,12 @@ Fl_Boxtype fl_define_FL_GTK_UP_BOX() {
   fl_internal_boxtype(_FL_GTK_THIN_DOWN_FRAME, gtk_thin_down_frame);
   fl_internal_boxtype(_FL_GTK_ROUND_UP_BOX, gtk_round_up_box, fl_round_focus);
   fl_internal_boxtype(_FL_GTK_ROUND_DOWN_BOX, gtk_round_down_box, fl_round_focus);
+  fl_cache_boxtype(_FL_GTK_UP_BOX, gtk_up_box);
+  fl_cache_boxtype(_FL_GTK_DOWN_BOX, gtk_down_box);
+  fl_cache_boxtype(_FL_GTK_THIN_UP_BOX, gtk_thin_up_box);
+  fl_cache_boxtype(_FL_GTK_THIN_DOWN_BOX, gtk_thin_down_box);
+  fl_cache_boxtype(_FL_GTK_ROUND_UP_BOX, gtk_round_up_box);
+  fl_cache_boxtype(_FL_GTK_ROUND_DOWN_BOX, gtk_round_down_box);
 
   return _FL_GTK_UP_BOX;
 }
@@ -28,6 +28,9 @@ struct Fl_Fontdesc;
 extern FL_EXPORT Fl_Fontdesc *fl_fonts; // the table
 
 static int table_size;
+
+extern void fl_clear_text_layout_cache(); // in fl_draw.cxx
+
 /**
   Changes a face.
  \param fnum The font number to be assigned a new face
@@ -64,6 +67,7 @@ void Fl::set_font(Fl_Font fnum, const char* name) {
   }
   d.font_name(fnum, name);
   d.font(-1, 0);
+  fl_clear_text_layout_cache();
 }
 
 /** Copies one face to another. */
@@ -0,0 +1,568 @@
+//
+// Drawing benchmark program for the Fast Light Tool Kit (FLTK).
+//
+// Copyright 2024 by Bill Spitzak and others.
+//
+// This library is free software. Distribution and use rights are outlined in
+// the file "COPYING" which should have been included with this file.  If this
+// file is missing or damaged, see the license at:
+//
+//     https://www.fltk.org/COPYING.php
+//
+// Please see the following page on how to report bugs and issues:
+//
+//     https://www.fltk.org/bugs.php
+//
+
+//
+// This program renders a fixed set of scripted drawing workloads and reports
+// their throughput (ops/sec) and frame times as JSON on stdout (or in a file).
+// All coordinates, colors and image contents come from a seeded generator,
+// so two runs draw exactly the same pixels.
+//
+// Usage: bench [options]
+//   -w, --window       draw into a shown window instead of an Fl_Image_Surface
+//   -f, --frames N     number of timed frames per workload (default: 50)
+//   -s, --size WxH     size of the drawing area (default: 800x600)
+//   -k, --filter STR   only run workloads whose name contains STR
+//   -o, --output FILE  write the JSON report to FILE instead of stdout
+//   -l, --list         list workload names and exit
+//
+// Each frame draws one workload into the target, then reads back one pixel
+// so that asynchronous graphics systems (X11) finish the frame before the
+// clock is stopped. Under Xvfb, or with FLTK_BACKEND=headless where
+// available, no physical display is needed.
+//
+
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_RGB_Image.H>
+#include <FL/Fl_Group.H>
+#include <FL/Fl_Button.H>
+#include <FL/Fl_Check_Button.H>
+#include <FL/Fl_Light_Button.H>
+#include <FL/Fl_Round_Button.H>
+#include <FL/Fl_Input.H>
+#include <FL/Fl_Slider.H>
+#include <FL/Fl_Dial.H>
+#include <FL/Fl_Progress.H>
+#include <FL/Fl_Hold_Browser.H>
+#include <FL/Fl_Choice.H>
+#include <FL/Fl_Box.H>
+#include <FL/fl_draw.H>
+#include <FL/platform.H>         // fl_open_display()
+#include <FL/fl_utf8.h>          // fl_fopen()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- deterministic pseudo-random numbers -----------------------------------
+
+static unsigned int seed_ = 1;
+
+static void bench_srand(unsigned int s) { seed_ = s ? s : 1; }
+
+static int bench_rand(int n) { // 0 <= result < n
+  seed_ = seed_ * 1103515245u + 12345u;
+  return (int)((seed_ >> 8) % (unsigned)n);
+}
+
+static int W = 800, H = 600;
+
+static void random_color() {
+  fl_color((uchar)bench_rand(256), (uchar)bench_rand(256), (uchar)bench_rand(256));
+}
+
+// --- workloads --------------------------------------------------------------
+
+struct Workload {
+  const char *name;
+  const char *category;
+  int ops;                // drawing operations per frame
+  void (*draw)(int ops);  // draws one frame
+  void (*setup)();        // optional, called before the first frame
+  void (*cleanup)();      // optional, called after the last frame
+};
+
+static void draw_rectf(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_rectf(bench_rand(W), bench_rand(H), 1 + bench_rand(100), 1 + bench_rand(100));
+  }
+}
+
+static void draw_rect(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_rect(bench_rand(W), bench_rand(H), 2 + bench_rand(100), 2 + bench_rand(100));
+  }
+}
+
+static void draw_xyline(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    int x = bench_rand(W), y = bench_rand(H);
+    if (i & 1) fl_xyline(x, y, x + bench_rand(200));
+    else fl_yxline(x, y, y + bench_rand(200));
+  }
+}
+
+static void draw_line(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_line(bench_rand(W), bench_rand(H), bench_rand(W), bench_rand(H));
+  }
+}
+
+static void draw_wide_line(int n) {
+  fl_line_style(FL_SOLID, 3);
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_line(bench_rand(W), bench_rand(H), bench_rand(W), bench_rand(H));
+  }
+  fl_line_style(0);
+}
+
+static void draw_polygon(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    int x = bench_rand(W), y = bench_rand(H);
+    fl_polygon(x, y, x + bench_rand(60), y + bench_rand(30),
+               x + bench_rand(60), y + 30 + bench_rand(30), x - bench_rand(30), y + bench_rand(60));
+  }
+}
+
+static void draw_complex_polygon(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    int x = bench_rand(W), y = bench_rand(H);
+    fl_begin_complex_polygon();
+    for (int j = 0; j < 16; j++) fl_vertex(x + bench_rand(80), y + bench_rand(80));
+    fl_end_complex_polygon();
+  }
+}
+
+static void draw_arc(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    int d = 4 + bench_rand(80);
+    fl_arc(bench_rand(W), bench_rand(H), d, d, bench_rand(360), 360);
+  }
+}
+
+static void draw_pie(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    int d = 4 + bench_rand(80);
+    int a1 = bench_rand(360);
+    fl_pie(bench_rand(W), bench_rand(H), d, d, a1, a1 + 30 + bench_rand(300));
+  }
+}
+
+static void draw_circle(int n) {
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_begin_loop();
+    fl_circle(bench_rand(W), bench_rand(H), 2 + bench_rand(40));
+    fl_end_loop();
+  }
+}
+
+static const char *short_text = "Hello";
+static const char *medium_text = "The quick brown fox jumps over the lazy dog";
+static char long_text[401];
+
+static void setup_text() {
+  if (!long_text[0]) {
+    size_t l = strlen(medium_text);
+    for (int i = 0; i < 400; i++) long_text[i] = (i % (l + 1) == l) ? ' ' : medium_text[i % (l + 1)];
+    long_text[400] = 0;
+  }
+  fl_font(FL_HELVETICA, 14);
+}
+
+static void draw_text(const char *s, int n) {
+  int l = (int)strlen(s);
+  for (int i = 0; i < n; i++) {
+    random_color();
+    fl_draw(s, l, bench_rand(W) - 100, bench_rand(H));
+  }
+}
+
+static void draw_text_short(int n) { draw_text(short_text, n); }
+static void draw_text_medium(int n) { draw_text(medium_text, n); }
+static void draw_text_long(int n) { draw_text(long_text, n); }
+
+static void draw_text_measure(int n) {
+  static double sink = 0; // prevents the loop from being optimized away
+  for (int i = 0; i < n; i++) {
+    fl_font(FL_HELVETICA, 10 + bench_rand(8));
+    sink += fl_width(medium_text);
+  }
+  fl_font(FL_HELVETICA, 14);
+  if (sink < 0) puts("");
+}
+
+static void draw_text_multiline(int n) {
+  fl_color(FL_BLACK);
+  for (int i = 0; i < n; i++) {
+    fl_draw("Label line 1\nsecond line of the label\n@-> with a symbol",
+            bench_rand(W), bench_rand(H), 200, 60, FL_ALIGN_CENTER | FL_ALIGN_WRAP, 0, 1);
+  }
+}
+
+// images
+
+static Fl_RGB_Image *rgb_image = 0, *rgba_image = 0;
+static const int IMG_SIZE = 128;
+
+static Fl_RGB_Image *make_image(int d) {
+  uchar *data = new uchar[IMG_SIZE * IMG_SIZE * d];
+  uchar *p = data;
+  for (int y = 0; y < IMG_SIZE; y++) {
+    for (int x = 0; x < IMG_SIZE; x++) {
+      *p++ = (uchar)(x * 2);
+      *p++ = (uchar)(y * 2);
+      *p++ = (uchar)((x ^ y) * 2);
+      if (d == 4) *p++ = (uchar)(255 - (x + y));
+    }
+  }
+  Fl_RGB_Image *img = new Fl_RGB_Image(data, IMG_SIZE, IMG_SIZE, d);
+  img->alloc_array = 1;
+  return img;
+}
+
+static void setup_images() {
+  if (!rgb_image) rgb_image = make_image(3);
+  if (!rgba_image) rgba_image = make_image(4);
+}
+
+static void draw_image(Fl_RGB_Image *img, float s, int n) {
+  img->scale(int(IMG_SIZE * s), int(IMG_SIZE * s), 0, 1);
+  for (int i = 0; i < n; i++) img->draw(bench_rand(W) - 50, bench_rand(H) - 50);
+}
+
+static void draw_rgb_1x(int n) { draw_image(rgb_image, 1.0f, n); }
+static void draw_rgb_half(int n) { draw_image(rgb_image, 0.5f, n); }
+static void draw_rgb_2x(int n) { draw_image(rgb_image, 2.0f, n); }
+static void draw_rgba_1x(int n) { draw_image(rgba_image, 1.0f, n); }
+static void draw_rgba_half(int n) { draw_image(rgba_image, 0.5f, n); }
+static void draw_rgba_2x(int n) { draw_image(rgba_image, 2.0f, n); }
+
+static void draw_image_direct(int n) {
+  for (int i = 0; i < n; i++)
+    fl_draw_image(rgb_image->array, bench_rand(W) - 50, bench_rand(H) - 50, IMG_SIZE, IMG_SIZE, 3);
+}
+
+// box types, one workload per scheme
+
+static const Fl_Boxtype boxtypes[] = {
+  FL_UP_BOX, FL_DOWN_BOX, FL_UP_FRAME, FL_DOWN_FRAME, FL_THIN_UP_BOX, FL_THIN_DOWN_BOX,
+  FL_ENGRAVED_BOX, FL_EMBOSSED_BOX, FL_BORDER_BOX, FL_ROUND_UP_BOX, FL_ROUND_DOWN_BOX,
+  FL_ROUNDED_BOX, FL_OVAL_BOX, FL_PLASTIC_UP_BOX, FL_GTK_UP_BOX, FL_GLEAM_UP_BOX,
+  FL_OXY_UP_BOX, FL_OXY_ROUND_UP_BOX
+};
+static const int num_boxtypes = sizeof(boxtypes) / sizeof(boxtypes[0]);
+
+static void draw_boxes(int n) {
+  for (int i = 0; i < n; i++) {
+    Fl_Boxtype b = boxtypes[i % num_boxtypes];
+    fl_draw_box(b, bench_rand(W), bench_rand(H), 20 + bench_rand(100), 12 + bench_rand(30),
+                (Fl_Color)(FL_BACKGROUND_COLOR + (i & 1) * 8));
+  }
+}
+
+static void scheme_none() { Fl::scheme("none"); }
+static void scheme_gtk() { Fl::scheme("gtk+"); }
+static void scheme_gleam() { Fl::scheme("gleam"); }
+static void scheme_plastic() { Fl::scheme("plastic"); }
+static void scheme_oxy() { Fl::scheme("oxy"); }
+
+// a toolbar: many boxes of the same size, which the box cache draws as images
+
+static void draw_toolbar(int n) {
+  const int bw = 60, bh = 26;
+  int columns = W / bw;
+  for (int i = 0; i < n; i++) {
+    int x = (i % columns) * bw, y = ((i / columns) * bh) % (H - bh);
+    fl_draw_box((i % 7) ? FL_UP_BOX : FL_DOWN_BOX, x, y, bw, bh, FL_BACKGROUND_COLOR);
+  }
+}
+
+static void no_box_cache() { Fl::box_cache_size(0); }
+static void default_box_cache() { Fl::scheme("none"); Fl::box_cache_size(4 * 1024 * 1024); }
+static void gleam_no_cache() { scheme_gleam(); no_box_cache(); }
+static void plastic_no_cache() { scheme_plastic(); no_box_cache(); }
+static void gtk_no_cache() { scheme_gtk(); no_box_cache(); }
+static void oxy_no_cache() { scheme_oxy(); no_box_cache(); }
+
+// a full widget tree, drawn without being shown
+
+static Fl_Group *tree = 0;
+static const int tree_columns = 5;
+static const int tree_rows = 20;
+
+static void setup_tree() {
+  if (tree) return;
+  Fl_Group::current(0);
+  tree = new Fl_Group(0, 0, W, H);
+  int cw = W / tree_columns, rh = H / tree_rows;
+  for (int r = 0; r < tree_rows; r++) {
+    for (int c = 0; c < tree_columns; c++) {
+      int x = c * cw + 2, y = r * rh + 2, w = cw - 4, h = rh - 4;
+      switch ((r * tree_columns + c) % 10) {
+        case 0: new Fl_Button(x, y, w, h, "Button"); break;
+        case 1: new Fl_Check_Button(x, y, w, h, "Check"); break;
+        case 2: new Fl_Light_Button(x, y, w, h, "Light"); break;
+        case 3: new Fl_Round_Button(x, y, w, h, "Round"); break;
+        case 4: (new Fl_Input(x, y, w, h))->value("Some input text"); break;
+        case 5: {
+          Fl_Slider *s = new Fl_Slider(x, y, w, h);
+          s->type(FL_HOR_NICE_SLIDER);
+          s->value(0.3);
+        } break;
+        case 6: {
+          Fl_Progress *p = new Fl_Progress(x, y, w, h, "50%");
+          p->value(50);
+        } break;
+        case 7: {
+          Fl_Choice *ch = new Fl_Choice(x, y, w, h);
+          ch->add("One|Two|Three");
+          ch->value(1);
+        } break;
+        case 8: new Fl_Dial(x, y, h, h); break;
+        default: {
+          Fl_Box *b = new Fl_Box(FL_ENGRAVED_BOX, x, y, w, h, "@+ Box");
+          b->labelfont(FL_HELVETICA_BOLD);
+        } break;
+      }
+    }
+  }
+  tree->end();
+}
+
+static void draw_tree(int n) {
+  for (int i = 0; i < n; i++) {
+    tree->damage(FL_DAMAGE_ALL);
+    ((Fl_Widget*)tree)->draw();
+  }
+  tree->clear_damage();
+}
+
+static void draw_browser(int n) {
+  static Fl_Hold_Browser *b = 0;
+  if (!b) {
+    Fl_Group::current(0);
+    b = new Fl_Hold_Browser(10, 10, W - 20, H - 20);
+    char line[80];
+    for (int i = 0; i < 1000; i++) {
+      snprintf(line, sizeof(line), "@%sLine %d of the browser\t%d", (i % 7) ? "." : "b", i, i * 37);
+      b->add(line);
+    }
+    b->value(3);
+  }
+  for (int i = 0; i < n; i++) {
+    b->topline(1 + (i * 37) % 900);
+    b->damage(FL_DAMAGE_ALL);
+    ((Fl_Widget*)b)->draw();
+  }
+  b->clear_damage();
+}
+
+static Workload workloads[] = {
+  {"rectf",            "shapes", 2000, draw_rectf, 0, 0},
+  {"rect",             "shapes", 2000, draw_rect, 0, 0},
+  {"xyline",           "shapes", 4000, draw_xyline, 0, 0},
+  {"line",             "shapes", 2000, draw_line, 0, 0},
+  {"line_width3",      "shapes", 1000, draw_wide_line, 0, 0},
+  {"polygon",          "shapes", 1000, draw_polygon, 0, 0},
+  {"complex_polygon",  "shapes", 200,  draw_complex_polygon, 0, 0},
+  {"arc",              "shapes", 1000, draw_arc, 0, 0},
+  {"pie",              "shapes", 1000, draw_pie, 0, 0},
+  {"circle",           "shapes", 500,  draw_circle, 0, 0},
+  {"text_short",       "text",   2000, draw_text_short, setup_text, 0},
+  {"text_medium",      "text",   1000, draw_text_medium, setup_text, 0},
+  {"text_long",        "text",   200,  draw_text_long, setup_text, 0},
+  {"text_measure",     "text",   5000, draw_text_measure, setup_text, 0},
+  {"text_multiline",   "text",   300,  draw_text_multiline, setup_text, 0},
+  {"image_rgb_1x",     "images", 100,  draw_rgb_1x, setup_images, 0},
+  {"image_rgb_0.5x",   "images", 100,  draw_rgb_half, setup_images, 0},
+  {"image_rgb_2x",     "images", 50,   draw_rgb_2x, setup_images, 0},
+  {"image_rgba_1x",    "images", 100,  draw_rgba_1x, setup_images, 0},
+  {"image_rgba_0.5x",  "images", 100,  draw_rgba_half, setup_images, 0},
+  {"image_rgba_2x",    "images", 50,   draw_rgba_2x, setup_images, 0},
+  {"image_direct",     "images", 100,  draw_image_direct, setup_images, 0},
+  {"boxes_none",       "boxes",  1000, draw_boxes, scheme_none, 0},
+  {"boxes_gtk+",       "boxes",  1000, draw_boxes, scheme_gtk, scheme_none},
+  {"boxes_gleam",      "boxes",  1000, draw_boxes, scheme_gleam, scheme_none},
+  {"boxes_plastic",    "boxes",  1000, draw_boxes, scheme_plastic, scheme_none},
+  {"boxes_oxy",        "boxes",  1000, draw_boxes, scheme_oxy, scheme_none},
+  {"toolbar_gtk+",     "boxes",  300,  draw_toolbar, scheme_gtk, scheme_none},
+  {"toolbar_gtk+_nocache", "boxes", 300, draw_toolbar, gtk_no_cache, default_box_cache},
+  {"toolbar_gleam",    "boxes",  300,  draw_toolbar, scheme_gleam, scheme_none},
+  {"toolbar_gleam_nocache", "boxes", 300, draw_toolbar, gleam_no_cache, default_box_cache},
+  {"toolbar_plastic",  "boxes",  300,  draw_toolbar, scheme_plastic, scheme_none},
+  {"toolbar_plastic_nocache", "boxes", 300, draw_toolbar, plastic_no_cache, default_box_cache},
+  {"toolbar_oxy",      "boxes",  300,  draw_toolbar, scheme_oxy, scheme_none},
+  {"toolbar_oxy_nocache", "boxes", 300, draw_toolbar, oxy_no_cache, default_box_cache},
+  {"widget_tree",      "widgets", 5,   draw_tree, setup_tree, 0},
+  {"browser_scroll",   "widgets", 20,  draw_browser, 0, 0}
+};
+static const int num_workloads = sizeof(workloads) / sizeof(workloads[0]);
+
+// --- drawing targets --------------------------------------------------------
+
+static Workload *current_workload = 0;
+
+// The widget that draws the current workload in --window mode
+class Bench_Window : public Fl_Window {
+public:
+  Bench_Window(int w, int h) : Fl_Window(w, h, "FLTK drawing benchmark") {}
+  void draw() FL_OVERRIDE {
+    fl_color(FL_WHITE);
+    fl_rectf(0, 0, w(), h());
+    if (current_workload) current_workload->draw(current_workload->ops);
+  }
+};
+
+static Bench_Window *window = 0;
+static Fl_Image_Surface *surface = 0;
+
+// Makes sure all drawing requests of the current frame were executed
+static void sync_target() {
+  uchar pixel[3];
+  if (window) window->make_current();
+  fl_read_image(pixel, 0, 0, 1, 1);
+}
+
+static double frame(Workload *wl) {
+  Fl_Timestamp start = Fl::now();
+  if (window) {
+    current_workload = wl;
+    window->redraw();
+    Fl::flush();
+  } else {
+    fl_color(FL_WHITE);
+    fl_rectf(0, 0, W, H);
+    wl->draw(wl->ops);
+  }
+  sync_target();
+  return Fl::seconds_since(start) * 1000.0;
+}
+
+// --- statistics and report --------------------------------------------------
+
+static int compare_doubles(const void *a, const void *b) {
+  double d = *(const double*)a - *(const double*)b;
+  return d < 0 ? -1 : (d > 0 ? 1 : 0);
+}
+
+static void report_workload(FILE *out, Workload *wl, double *times, int frames, bool last) {
+  double total = 0;
+  for (int i = 0; i < frames; i++) total += times[i];
+  qsort(times, frames, sizeof(double), compare_doubles);
+  int p95 = (int)(frames * 0.95);
+  if (p95 >= frames) p95 = frames - 1;
+  double ops_per_sec = total > 0 ? (double)wl->ops * frames / (total / 1000.0) : 0;
+  fprintf(out, "    {\"name\": \"%s\", \"category\": \"%s\", \"ops_per_frame\": %d, \"frames\": %d,\n",
+          wl->name, wl->category, wl->ops, frames);
+  fprintf(out, "     \"ops_per_sec\": %.1f, \"frame_ms\": {\"min\": %.4f, \"median\": %.4f, "
+          "\"mean\": %.4f, \"p95\": %.4f, \"max\": %.4f}}%s\n",
+          ops_per_sec, times[0], times[frames / 2], total / frames, times[p95],
+          times[frames - 1], last ? "" : ",");
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-w|--window] [-f|--frames N] [-s|--size WxH] [-k|--filter STR]\n"
+          "          [-o|--output FILE] [-l|--list]\n", prog);
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  int frames = 50;
+  bool use_window = false;
+  const char *filter = 0, *output = 0;
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    bool has_value = (i + 1 < argc);
+    if (!strcmp(a, "-w") || !strcmp(a, "--window")) use_window = true;
+    else if ((!strcmp(a, "-f") || !strcmp(a, "--frames")) && has_value) frames = atoi(argv[++i]);
+    else if ((!strcmp(a, "-s") || !strcmp(a, "--size")) && has_value) {
+      if (sscanf(argv[++i], "%dx%d", &W, &H) != 2 || W < 100 || H < 100) usage(argv[0]);
+    }
+    else if ((!strcmp(a, "-k") || !strcmp(a, "--filter")) && has_value) filter = argv[++i];
+    else if ((!strcmp(a, "-o") || !strcmp(a, "--output")) && has_value) output = argv[++i];
+    else if (!strcmp(a, "-l") || !strcmp(a, "--list")) {
+      for (int j = 0; j < num_workloads; j++)
+        printf("%-18s %s\n", workloads[j].name, workloads[j].category);
+      return 0;
+    }
+    else usage(argv[0]);
+  }
+  if (frames < 1) frames = 1;
+
+  FILE *out = stdout;
+  if (output) {
+    out = fl_fopen(output, "w");
+    if (!out) {
+      fprintf(stderr, "%s: can't open %s\n", argv[0], output);
+      return 1;
+    }
+  }
+
+  fl_open_display();
+  if (use_window) {
+    window = new Bench_Window(W, H);
+    window->end();
+    window->show();
+    window->wait_for_expose();
+    Fl::flush();
+  } else {
+    surface = new Fl_Image_Surface(W, H);
+    Fl_Surface_Device::push_current(surface);
+  }
+
+  int selected = 0;
+  for (int j = 0; j < num_workloads; j++)
+    if (!filter || strstr(workloads[j].name, filter)) selected++;
+
+  fprintf(out, "{\n  \"benchmark\": \"fltk-drawing\",\n");
+  fprintf(out, "  \"fltk_version\": \"%d.%d.%d\",\n", FL_MAJOR_VERSION, FL_MINOR_VERSION, FL_PATCH_VERSION);
+  fprintf(out, "  \"target\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n",
+          use_window ? "window" : "image_surface", W, H, frames);
+  fprintf(out, "  \"results\": [\n");
+
+  double *times = new double[frames];
+  int done = 0;
+  for (int j = 0; j < num_workloads; j++) {
+    Workload *wl = workloads + j;
+    if (filter && !strstr(wl->name, filter)) continue;
+    if (wl->setup) wl->setup();
+    bench_srand(j + 1);
+    frame(wl); // warm-up frame: fills font, image and scheme caches
+    for (int i = 0; i < frames; i++) {
+      bench_srand(j + 1); // every frame draws the same pixels
+      times[i] = frame(wl);
+    }
+    if (wl->cleanup) wl->cleanup();
+    report_workload(out, wl, times, frames, ++done == selected);
+    fflush(out);
+  }
+  delete[] times;
+  fprintf(out, "  ]\n}\n");
+
+  if (surface) {
+    Fl_Surface_Device::pop_current();
+    delete surface;
+  }
+  if (window) {
+    current_workload = 0;
+    window->hide();
+    delete window;
+  }
+  if (out != stdout) fclose(out);
+  return 0;
+}
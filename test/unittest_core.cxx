@@ -19,6 +19,9 @@
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Button.H>
 #include <FL/Fl_Terminal.H>
+#include <FL/Fl_Text_Buffer.H>
+#include <FL/Fl_Table_Row.H>
+#include <FL/Fl_Tree.H>
 #include "../src/Fl_String.H"
 #include <FL/Fl_Preferences.H>
 #include <FL/fl_callback_macros.H>
@@ -363,6 +366,213 @@ TEST(Fl_Callback_Macros, FL_INLINE_CALLBACK) {
 
 #endif // FIXME - Fl_String
 
+static int count_matches_cb(int, int, void *data) {
+  (*(int*)data)++;
+  return 1;
+}
+
+/* Test Fl_Text_Buffer searching, including multibyte and case-folded needles. */
+TEST(Fl_Text_Buffer, Search) {
+  Fl_Text_Buffer buf;
+  // "Über" starts the buffer, "ÜBER" ends it; "ü" is 2 bytes in UTF-8
+  buf.text("\xC3\x9C" "ber alles, uber \xC3\xBC" "ber, \xC3\x9C" "BER");
+  int len = buf.length();
+  int pos = -1;
+  // match at buffer start, case sensitive and caseless
+  EXPECT_EQ(buf.search_forward(0, "\xC3\x9C" "ber", &pos, 1), 1);
+  EXPECT_EQ(pos, 0);
+  EXPECT_EQ(buf.search_forward(1, "\xC3\x9C" "ber", &pos, 1), 0);   // exact case only at 0
+  EXPECT_EQ(buf.search_forward(2, "\xC3\xBC" "BER", &pos, 0), 1);   // folded needle
+  EXPECT_EQ(pos, 18);
+  // match at buffer end, searching backward
+  EXPECT_EQ(buf.search_backward(len, "\xC3\xBC" "ber", &pos, 0), 1);
+  EXPECT_EQ(pos, len - 5);
+  EXPECT_EQ(buf.search_backward(len, "\xC3\xBC" "ber", &pos, 1), 1);
+  EXPECT_EQ(pos, 18);
+  EXPECT_EQ(buf.search_backward(17, "\xC3\xBC" "ber", &pos, 0), 1);
+  EXPECT_EQ(pos, 0);
+  EXPECT_EQ(buf.search_backward(len, "ALLES", &pos, 1), 0);
+  EXPECT_EQ(buf.search_backward(len, "ALLES", &pos, 0), 1);
+  EXPECT_EQ(pos, 6);
+  // "uber" must not match inside the two byte "ü"
+  EXPECT_EQ(buf.search_forward(0, "uber", &pos, 0), 1);
+  EXPECT_EQ(pos, 13);
+  // same results with the gap in the middle of a match
+  buf.insert(20, "x");
+  buf.remove(20, 21);
+  EXPECT_EQ(buf.search_forward(1, "\xC3\xBC" "BER", &pos, 0), 1);
+  EXPECT_EQ(pos, 18);
+  EXPECT_EQ(buf.search_backward(len, "\xC3\xBC" "ber", &pos, 1), 1);
+  EXPECT_EQ(pos, 18);
+  // search_all() with and without a range
+  int n = 0;
+  EXPECT_EQ(buf.search_all("\xC3\xBC" "ber", count_matches_cb, &n, 0), 3);
+  EXPECT_EQ(n, 3);
+  EXPECT_EQ(buf.search_all("\xC3\xBC" "ber", NULL, NULL, 0, 1, len - 1), 1);
+  EXPECT_EQ(buf.search_all("\xC3\xBC" "ber", NULL, NULL, 0, 0, len), 3);
+  return true;
+}
+
+// Small deterministic random number generator for repeatable tests
+static unsigned int ut_seed = 1;
+static int ut_rand(int n) {
+  ut_seed = ut_seed * 1103515245 + 12345;
+  return (int)((ut_seed >> 8) % (unsigned int)n);
+}
+
+/* Test Fl_Table_Row row selection against a plain array of flags. */
+TEST(Fl_Table_Row, Selection) {
+  Fl_Group::current(NULL);
+  Fl_Table_Row table(0, 0, 200, 200);
+  table.type(Fl_Table_Row::SELECT_MULTI);
+  int nrows = 100;
+  char sel[150] = { 0 };
+  table.rows(nrows);
+  ut_seed = 1;
+  for (int i = 0; i < 2000; i++) {
+    int r1 = ut_rand(nrows), r2 = ut_rand(nrows), flag = ut_rand(3);
+    switch (ut_rand(8)) {
+      case 0: case 1: case 2: {       // single row
+        int changed = (flag == 2) || (sel[r1] != flag);
+        sel[r1] = (flag == 2) ? !sel[r1] : flag;
+        EXPECT_EQ(table.select_row(r1, flag), changed);
+        break;
+      }
+      case 3: case 4: case 5: {       // range of rows, in either order
+        int lo = r1 < r2 ? r1 : r2, hi = r1 < r2 ? r2 : r1, changed = 0;
+        for (int r = lo; r <= hi; r++) {
+          if (flag == 2 || sel[r] != flag) changed = 1;
+          sel[r] = (flag == 2) ? !sel[r] : flag;
+        }
+        EXPECT_EQ(table.select_rows(r1, r2, flag), changed);
+        break;
+      }
+      case 6:                         // all rows
+        if (ut_rand(4)) break;
+        for (int r = 0; r < nrows; r++) sel[r] = (flag == 2) ? !sel[r] : flag;
+        table.select_all_rows(flag);
+        break;
+      case 7: {                       // shrink or grow, new rows are not selected
+        int n = 1 + ut_rand(150);
+        for (int r = nrows; r < n; r++) sel[r] = 0;
+        nrows = n;
+        table.rows(nrows);
+        break;
+      }
+    }
+    // compare every row, and walk the selection
+    int next = table.next_selected_row();
+    for (int r = 0; r < nrows; r++) {
+      EXPECT_EQ(table.row_selected(r), sel[r]);
+      if (sel[r]) {
+        EXPECT_EQ(next, r);
+        next = table.next_selected_row(r);
+      }
+    }
+    EXPECT_EQ(next, -1);
+  }
+  EXPECT_EQ(table.select_rows(0, nrows), -1);   // out of range
+  return true;
+}
+
+// Count the selected items in the subtree of 'item' the slow way
+static int ut_count_selected(Fl_Tree_Item *item) {
+  int count = item->is_selected() ? 1 : 0;
+  for (int i = 0; i < item->children(); i++)
+    count += ut_count_selected(item->child(i));
+  return count;
+}
+
+// Check selected_count() of every item in the subtree of 'item'
+static bool ut_check_selected(Fl_Tree_Item *item) {
+  if (item->selected_count() != ut_count_selected(item)) return false;
+  for (int i = 0; i < item->children(); i++)
+    if (!ut_check_selected(item->child(i))) return false;
+  return true;
+}
+
+/* Test Fl_Tree_Item::selected_count() and walking the selection as items are changed. */
+TEST(Fl_Tree, SelectedCount) {
+  Fl_Group::current(NULL);
+  Fl_Tree tree(0, 0, 200, 200);
+  Fl_Tree_Item *root = tree.root();
+  Fl_Tree_Item *a = tree.add("a");
+  Fl_Tree_Item *b = tree.add("a/b");
+  Fl_Tree_Item *c = tree.add("a/c");
+  Fl_Tree_Item *d = tree.add("d");
+  tree.select(b, 0);
+  tree.select(c, 0);
+  EXPECT_EQ(root->selected_count(), 2);
+  EXPECT_EQ(a->selected_count(), 2);
+  EXPECT_EQ(d->selected_count(), 0);
+  tree.select(tree.add("a/b/e"), 0);        // add below a selected item
+  EXPECT_EQ(b->selected_count(), 2);
+  EXPECT_EQ(root->selected_count(), 3);
+  EXPECT_EQ(b->move_into(d), 0);            // move a subtree
+  EXPECT_EQ(a->selected_count(), 1);
+  EXPECT_EQ(d->selected_count(), 2);
+  EXPECT_EQ(root->selected_count(), 3);
+  tree.remove(c);                           // remove a selected item
+  EXPECT_EQ(a->selected_count(), 0);
+  EXPECT_EQ(root->selected_count(), 2);
+  tree.clear_children(d);                   // remove a subtree
+  EXPECT_EQ(d->selected_count(), 0);
+  EXPECT_EQ(root->selected_count(), 0);
+  // random changes, checked against counting the selected items
+  char path[20];
+  ut_seed = 2;
+  for (int i = 0; i < 300; i++) {
+    Fl_Tree_Item *items[200];
+    int n = 0;
+    for (Fl_Tree_Item *item = tree.first(); item && n < 200; item = tree.next(item))
+      items[n++] = item;
+    Fl_Tree_Item *item = items[ut_rand(n)];
+    Fl_Tree_Item *other = items[ut_rand(n)];
+    switch (ut_rand(6)) {
+      case 0: case 1:                       // add an item, maybe selected
+        if (n >= 150) break;
+        snprintf(path, sizeof(path), "i%d", i);
+        other = tree.add(item, path);
+        if (ut_rand(2)) tree.select(other, 0);
+        break;
+      case 2:                               // toggle the selection
+        if (item->is_selected()) tree.deselect(item, 0);
+        else                     tree.select(item, 0);
+        break;
+      case 3: {                             // move 'item' into 'other'
+        Fl_Tree_Item *p = other;
+        while (p && p != item) p = p->parent();
+        if (!p && item != root) item->move_into(other);
+        break;
+      }
+      case 4:                               // remove an item with its children
+        if (item != root && ut_rand(2)) tree.remove(item);
+        break;
+      case 5:                               // remove all children
+        if (ut_rand(4) == 0) tree.clear_children(item);
+        break;
+    }
+    EXPECT_TRUE(ut_check_selected(root));
+    // walk the selection both ways, checked against a scan of all items
+    n = 0;
+    for (item = tree.first(); item && n < 200; item = tree.next(item))
+      items[n++] = item;
+    Fl_Tree_Item *sel = NULL;               // last selected item above items[j]
+    for (int j = 0; j < n; j++) {
+      EXPECT_TRUE(tree.next_selected_item(items[j], FL_Up) == sel);
+      if (items[j]->is_selected()) sel = items[j];
+    }
+    EXPECT_TRUE(tree.last_selected_item() == sel);
+    sel = NULL;                             // first selected item below items[j]
+    for (int j = n - 1; j >= 0; j--) {
+      EXPECT_TRUE(tree.next_selected_item(items[j], FL_Down) == sel);
+      if (items[j]->is_selected()) sel = items[j];
+    }
+    EXPECT_TRUE(tree.first_selected_item() == sel);
+  }
+  return true;
+}
+
 //
 //------- test aspects of the FLTK core library ----------
 //